@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief Append a batch of actions to the desired actions of a frontend.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <Eigen/Eigen>
+#include <time_series/interface.hpp>
+
+namespace robot_fingers
+{
+/**
+ * @brief Append a batch of actions to the desired actions of a frontend.
+ *
+ * The batch is given as one matrix per action field (torque, position,
+ * position_kp, position_kd) with one row per time step.  Fields with zero rows
+ * are set to their default value (see the default constructor of Action),
+ * e.g. to only specify positions.
+ *
+ * All rows are validated before the first action is appended, so either all
+ * or none of the actions are appended.  The actions are appended one after the
+ * other, so the returned range is contiguous as long as no other frontend
+ * appends actions at the same time (which is not supported by
+ * robot_interfaces anyway).
+ *
+ * Note that the actions of the batch stay in the desired action time series
+ * until they are executed, so the batch must not be longer than the history
+ * of the robot data (send long trajectories in chunks).
+ *
+ * @tparam Action  The action type of the robot.
+ * @tparam Frontend  A frontend with method
+ *     `time_series::Index append_desired_action(const Action &)`.
+ * @tparam Batch  Struct with matrices `torque`, `position`, `position_kp` and
+ *     `position_kd`.
+ *
+ * @param frontend  The frontend to which the actions are appended.
+ * @param batch  The actions.
+ *
+ * @return Range [t_begin, t_end) of the time indices at which the actions are
+ *     going to be executed.
+ * @throws std::invalid_argument if the batch is empty or the fields have
+ *     different numbers of rows.
+ */
+template <typename Action, typename Frontend, typename Batch>
+std::pair<time_series::Index, time_series::Index> append_desired_actions(
+    Frontend &frontend, const Batch &batch)
+{
+    const Eigen::Index n = std::max({batch.torque.rows(),
+                                     batch.position.rows(),
+                                     batch.position_kp.rows(),
+                                     batch.position_kd.rows()});
+    if (n == 0)
+    {
+        throw std::invalid_argument("Action batch is empty.");
+    }
+
+    auto check_rows = [n](const auto &field, const std::string &name) {
+        if (field.rows() != 0 && field.rows() != n)
+        {
+            throw std::invalid_argument(
+                "Action batch field '" + name + "' has " +
+                std::to_string(field.rows()) + " rows, expected " +
+                std::to_string(n) + ".");
+        }
+    };
+    check_rows(batch.torque, "torque");
+    check_rows(batch.position, "position");
+    check_rows(batch.position_kp, "position_kp");
+    check_rows(batch.position_kd, "position_kd");
+
+    time_series::Index t_begin = 0, t = 0;
+    for (Eigen::Index i = 0; i < n; i++)
+    {
+        Action action;
+        if (batch.torque.rows() != 0)
+        {
+            action.torque = batch.torque.row(i).transpose();
+        }
+        if (batch.position.rows() != 0)
+        {
+            action.position = batch.position.row(i).transpose();
+        }
+        if (batch.position_kp.rows() != 0)
+        {
+            action.position_kp = batch.position_kp.row(i).transpose();
+        }
+        if (batch.position_kd.rows() != 0)
+        {
+            action.position_kd = batch.position_kd.row(i).transpose();
+        }
+
+        t = frontend.append_desired_action(action);
+        if (i == 0)
+        {
+            t_begin = t;
+        }
+    }
+
+    return {t_begin, t + 1};
+}
+
+}  // namespace robot_fingers
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief Append lines to log files from a background thread.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace robot_fingers
+{
+/**
+ * @brief Appends lines to log files from a background thread.
+ *
+ * @ref append only queues the line and returns immediately, opening and
+ * writing the file is done by a worker thread.  This way the caller is not
+ * blocked by slow file I/O (e.g. a log file on a network drive).
+ *
+ * Files are opened in append mode for each line.  If a file cannot be written,
+ * an error is printed to stderr by the worker thread and the line is dropped.
+ *
+ * Pending lines are written before the destructor returns.
+ */
+class BackgroundLogWriter
+{
+public:
+    BackgroundLogWriter() : thread_(&BackgroundLogWriter::loop, this)
+    {
+    }
+
+    ~BackgroundLogWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            is_running_ = false;
+        }
+        wakeup_.notify_one();
+        thread_.join();
+    }
+
+    BackgroundLogWriter(const BackgroundLogWriter &) = delete;
+    BackgroundLogWriter &operator=(const BackgroundLogWriter &) = delete;
+
+    /**
+     * @brief Queue a line to be appended to the given file.
+     *
+     * @param filename  Path to the file.  It is created if it does not exist.
+     * @param line  The line, without trailing newline.
+     */
+    void append(const std::string &filename, const std::string &line)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back({filename, line});
+        }
+        wakeup_.notify_one();
+    }
+
+    //! @brief Block until all queued lines are written.
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return queue_.empty() && !is_writing_; });
+    }
+
+    //! @brief Number of lines that could not be written so far.
+    size_t get_failure_count() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return failure_count_;
+    }
+
+private:
+    struct Entry
+    {
+        std::string filename;
+        std::string line;
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable idle_;
+    std::deque<Entry> queue_;
+    bool is_running_ = true;
+    bool is_writing_ = false;
+    size_t failure_count_ = 0;
+    // declared last, so the members above are initialised when it starts
+    std::thread thread_;
+
+    void loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            wakeup_.wait(lock,
+                         [this] { return !queue_.empty() || !is_running_; });
+            // write all pending lines before stopping
+            if (queue_.empty())
+            {
+                break;
+            }
+
+            Entry entry = std::move(queue_.front());
+            queue_.pop_front();
+            is_writing_ = true;
+
+            lock.unlock();
+            const bool success = write(entry);
+            lock.lock();
+
+            is_writing_ = false;
+            if (!success)
+            {
+                failure_count_++;
+            }
+            if (queue_.empty())
+            {
+                idle_.notify_all();
+            }
+        }
+    }
+
+    static bool write(const Entry &entry)
+    {
+        std::ofstream file(entry.filename, std::ios_base::app);
+        if (file)
+        {
+            file << entry.line << '\n';
+        }
+        if (!file)
+        {
+            std::cerr << "Failed to write to file " << entry.filename << "."
+                      << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+}  // namespace robot_fingers
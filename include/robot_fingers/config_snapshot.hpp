@@ -0,0 +1,307 @@
+/**
+ * @file
+ * @brief Compact binary snapshots of configurations.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Eigen>
+
+namespace robot_fingers
+{
+/**
+ * @brief 64-bit FNV-1a hash of the given data.
+ *
+ * Used to identify snapshots by the content of the file they were created
+ * from (not suitable for anything security-related).
+ */
+inline uint64_t fnv1a_hash(const std::string &data)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Serialises values into a compact binary buffer.
+ *
+ * Supports trivially copyable types (written as is), strings, std::array,
+ * std::vector, fixed-size Eigen matrices and classes with a method
+ * `template <typename Archive> void serialize(Archive &)` that passes all
+ * members to the archive.  The layout is only meant to be read back by @ref
+ * SnapshotReader on the same machine (no handling of endianness).
+ */
+class SnapshotWriter
+{
+public:
+    template <typename T>
+    void operator()(const T &value)
+    {
+        if constexpr (std::is_trivially_copyable<T>::value)
+        {
+            data_.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+        else
+        {
+            const_cast<T &>(value).serialize(*this);
+        }
+    }
+
+    void operator()(const std::string &value)
+    {
+        (*this)(static_cast<uint64_t>(value.size()));
+        data_.append(value);
+    }
+
+    template <typename T, size_t N>
+    void operator()(const std::array<T, N> &values)
+    {
+        for (const T &value : values)
+        {
+            (*this)(value);
+        }
+    }
+
+    template <typename T>
+    void operator()(const std::vector<T> &values)
+    {
+        (*this)(static_cast<uint64_t>(values.size()));
+        for (const T &value : values)
+        {
+            (*this)(value);
+        }
+    }
+
+    template <typename Scalar, int ROWS, int COLS, int OPTIONS>
+    void operator()(const Eigen::Matrix<Scalar, ROWS, COLS, OPTIONS> &value)
+    {
+        static_assert(ROWS != Eigen::Dynamic && COLS != Eigen::Dynamic,
+                      "Only fixed-size matrices are supported.");
+        data_.append(reinterpret_cast<const char *>(value.data()),
+                     sizeof(Scalar) * ROWS * COLS);
+    }
+
+    //! @brief The serialised data.
+    const std::string &data() const
+    {
+        return data_;
+    }
+
+    /**
+     * @brief Write the data to a file.
+     *
+     * The data is written to a temporary file first which is then renamed, so
+     * concurrent readers never see a partially written file.
+     *
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string &filename) const
+    {
+        const std::string tmp_filename =
+            filename + ".tmp" + std::to_string(getpid());
+        {
+            std::ofstream file(tmp_filename, std::ios::binary);
+            file.write(data_.data(), data_.size());
+            if (!file)
+            {
+                std::remove(tmp_filename.c_str());
+                throw std::runtime_error("Failed to write snapshot " +
+                                         tmp_filename);
+            }
+        }
+        if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+        {
+            std::remove(tmp_filename.c_str());
+            throw std::runtime_error("Failed to write snapshot " + filename);
+        }
+    }
+
+private:
+    std::string data_;
+};
+
+/**
+ * @brief Reads values written by @ref SnapshotWriter.
+ *
+ * Values have to be read in the same order as they were written.  Reading
+ * beyond the end of the data throws a std::runtime_error, so truncated or
+ * corrupted snapshots are detected instead of resulting in undefined
+ * behaviour.
+ */
+class SnapshotReader
+{
+public:
+    SnapshotReader(const char *data, size_t size) : data_(data), size_(size)
+    {
+    }
+
+    template <typename T>
+    void operator()(T &value)
+    {
+        if constexpr (std::is_trivially_copyable<T>::value)
+        {
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        }
+        else
+        {
+            value.serialize(*this);
+        }
+    }
+
+    void operator()(std::string &value)
+    {
+        const uint64_t size = read_size(1);
+        value.assign(take(size), size);
+    }
+
+    template <typename T, size_t N>
+    void operator()(std::array<T, N> &values)
+    {
+        for (T &value : values)
+        {
+            (*this)(value);
+        }
+    }
+
+    template <typename T>
+    void operator()(std::vector<T> &values)
+    {
+        // every element takes at least one byte, which limits the size of
+        // corrupted snapshots
+        values.resize(read_size(1));
+        for (T &value : values)
+        {
+            (*this)(value);
+        }
+    }
+
+    template <typename Scalar, int ROWS, int COLS, int OPTIONS>
+    void operator()(Eigen::Matrix<Scalar, ROWS, COLS, OPTIONS> &value)
+    {
+        static_assert(ROWS != Eigen::Dynamic && COLS != Eigen::Dynamic,
+                      "Only fixed-size matrices are supported.");
+        constexpr size_t num_bytes = sizeof(Scalar) * ROWS * COLS;
+        std::memcpy(value.data(), take(num_bytes), num_bytes);
+    }
+
+    //! @brief True if all data has been read.
+    bool at_end() const
+    {
+        return position_ == size_;
+    }
+
+private:
+    const char *data_;
+    size_t size_;
+    size_t position_ = 0;
+
+    const char *take(size_t num_bytes)
+    {
+        if (num_bytes > size_ - position_)
+        {
+            throw std::runtime_error("Snapshot is truncated.");
+        }
+        const char *begin = data_ + position_;
+        position_ += num_bytes;
+        return begin;
+    }
+
+    uint64_t read_size(size_t min_element_size)
+    {
+        uint64_t size;
+        (*this)(size);
+        if (size > (size_ - position_) / min_element_size)
+        {
+            throw std::runtime_error("Snapshot is corrupted.");
+        }
+        return size;
+    }
+};
+
+/**
+ * @brief Read-only memory mapping of a file.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @param filename  Path to the file.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string &filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to open " + filename);
+        }
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Failed to stat " + filename);
+        }
+        size_ = static_cast<size_t>(file_stat.st_size);
+
+        // mmap does not support empty mappings
+        if (size_ > 0)
+        {
+            void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error("Failed to map " + filename);
+            }
+            data_ = static_cast<const char *>(data);
+        }
+        // the mapping stays valid after closing the file
+        close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (data_)
+        {
+            munmap(const_cast<char *>(data_), size_);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace robot_fingers
@@ -0,0 +1,267 @@
+/**
+ * @file
+ * @brief Recording of the timing of the control loop.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <robot_fingers/latency_histogram.hpp>
+#include <robot_fingers/spsc_ring_buffer.hpp>
+
+namespace robot_fingers
+{
+/**
+ * @brief Records the timing of the phases of each control cycle.
+ *
+ * The control thread calls @ref record once per cycle with the timestamps of
+ * the phase boundaries.  These are pushed into a preallocated lock-free ring
+ * buffer, so recording neither allocates nor blocks.
+ *
+ * The buffer is drained by a non-real-time reader thread (see @ref start) which
+ * writes the raw timestamps to a file (if a file name is given) and adds the
+ * phase durations to a @ref LatencyHistogram per phase.  A summary of the
+ * histograms can be printed with @ref print_summary.
+ *
+ * If the reader does not keep up and the buffer is full, new records are
+ * dropped and counted (see @ref get_dropped_count).
+ */
+class CycleTimingTrace
+{
+public:
+    //! @brief Timestamps (CLOCK_MONOTONIC in ns) of one control cycle.
+    struct CycleTimestamps
+    {
+        //! @brief Number of the cycle.
+        uint64_t cycle = 0;
+        //! @brief Start of the cycle.
+        int64_t start_ns = 0;
+        //! @brief Observation is acquired.
+        int64_t observation_ns = 0;
+        //! @brief Desired action is processed.
+        int64_t processing_ns = 0;
+        //! @brief Torque commands are sent to the motor boards.
+        int64_t send_ns = 0;
+        //! @brief End of the cycle (i.e. after sleeping until the deadline).
+        int64_t end_ns = 0;
+    };
+
+    //! @brief Phases of a cycle for which histograms are computed.
+    enum Phase
+    {
+        //! Acquiring the observation (start -> observation).
+        OBSERVATION = 0,
+        //! Processing the desired action (observation -> processing).
+        PROCESSING,
+        //! Sending the torques (processing -> send).
+        SEND,
+        //! Sleeping until the end of the period (send -> end).
+        SLEEP,
+        //! Whole cycle (start -> end).
+        CYCLE,
+        //! Time between the start of two consecutive cycles.
+        PERIOD,
+        NUM_PHASES
+    };
+
+    /**
+     * @param buffer_capacity  Number of cycles that can be buffered until the
+     *     reader needs to drain the buffer.
+     * @param output_file  If not empty, the raw timestamps of all cycles are
+     *     written to this file (one line per cycle).
+     */
+    explicit CycleTimingTrace(size_t buffer_capacity = 16384,
+                              const std::string &output_file = "")
+        : buffer_(buffer_capacity)
+    {
+        if (!output_file.empty())
+        {
+            output_.open(output_file);
+            if (!output_)
+            {
+                throw std::runtime_error("Failed to open file " + output_file +
+                                         " for writing.");
+            }
+            output_ << "# cycle start_ns observation_ns processing_ns send_ns "
+                       "end_ns\n";
+        }
+    }
+
+    ~CycleTimingTrace()
+    {
+        stop();
+    }
+
+    /**
+     * @brief Record timestamps of one cycle (real-time safe).
+     *
+     * Must only be called by a single thread.
+     */
+    void record(const CycleTimestamps &timestamps)
+    {
+        if (!buffer_.try_push(timestamps))
+        {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Start a thread that periodically drains the buffer.
+     *
+     * @param drain_interval_s  Interval in which the buffer is drained.
+     */
+    void start(double drain_interval_s = 0.01)
+    {
+        if (reader_thread_.joinable())
+        {
+            return;
+        }
+
+        is_reader_running_ = true;
+        reader_thread_ = std::thread([this, drain_interval_s]() {
+            const auto interval = std::chrono::duration<double>(drain_interval_s);
+            while (is_reader_running_)
+            {
+                drain();
+                std::this_thread::sleep_for(interval);
+            }
+        });
+    }
+
+    /**
+     * @brief Stop the reader thread (if running) and drain remaining records.
+     */
+    void stop()
+    {
+        is_reader_running_ = false;
+        if (reader_thread_.joinable())
+        {
+            reader_thread_.join();
+        }
+        drain();
+        if (output_.is_open())
+        {
+            output_.flush();
+        }
+    }
+
+    /**
+     * @brief Process all records that are currently in the buffer.
+     *
+     * This is called by the reader thread, so only call it manually if the
+     * reader thread is not running.
+     *
+     * @return Number of records that were processed.
+     */
+    size_t drain()
+    {
+        size_t count = 0;
+        CycleTimestamps ts;
+        while (buffer_.try_pop(&ts))
+        {
+            histograms_[OBSERVATION].record(ts.observation_ns - ts.start_ns);
+            histograms_[PROCESSING].record(ts.processing_ns -
+                                           ts.observation_ns);
+            histograms_[SEND].record(ts.send_ns - ts.processing_ns);
+            histograms_[SLEEP].record(ts.end_ns - ts.send_ns);
+            histograms_[CYCLE].record(ts.end_ns - ts.start_ns);
+            // only consecutive cycles are meaningful for the period
+            if (has_previous_ && ts.cycle == previous_cycle_ + 1)
+            {
+                histograms_[PERIOD].record(ts.start_ns - previous_start_ns_);
+            }
+            has_previous_ = true;
+            previous_cycle_ = ts.cycle;
+            previous_start_ns_ = ts.start_ns;
+
+            if (output_.is_open())
+            {
+                output_ << ts.cycle << " " << ts.start_ns << " "
+                        << ts.observation_ns << " " << ts.processing_ns << " "
+                        << ts.send_ns << " " << ts.end_ns << "\n";
+            }
+
+            count++;
+        }
+
+        return count;
+    }
+
+    //! @brief Number of records that were dropped because the buffer was full.
+    uint64_t get_dropped_count() const
+    {
+        return dropped_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the histogram of the given phase.
+     *
+     * Only access this when the reader thread is not running.
+     */
+    const LatencyHistogram &get_histogram(Phase phase) const
+    {
+        return histograms_.at(phase);
+    }
+
+    /**
+     * @brief Print summary statistics of all phases (in microseconds).
+     *
+     * Only call this when the reader thread is not running.
+     */
+    void print_summary(std::ostream &stream) const
+    {
+        static const std::array<const char *, NUM_PHASES> PHASE_NAMES = {
+            "observation", "processing", "send", "sleep", "cycle", "period"};
+
+        stream << "Control cycle timing [us] (" << get_dropped_count()
+               << " records dropped):\n"
+               << std::setw(13) << "phase" << std::setw(10) << "count"
+               << std::setw(10) << "min" << std::setw(10) << "mean"
+               << std::setw(10) << "p50" << std::setw(10) << "p90"
+               << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+               << std::setw(10) << "max"
+               << "\n";
+
+        stream << std::fixed << std::setprecision(1);
+        for (size_t i = 0; i < NUM_PHASES; i++)
+        {
+            const LatencyHistogram &h = histograms_[i];
+            stream << std::setw(13) << PHASE_NAMES[i] << std::setw(10)
+                   << h.get_count() << std::setw(10) << h.get_min() / 1e3
+                   << std::setw(10) << h.get_mean() / 1e3 << std::setw(10)
+                   << h.get_value_at_percentile(50) / 1e3 << std::setw(10)
+                   << h.get_value_at_percentile(90) / 1e3 << std::setw(10)
+                   << h.get_value_at_percentile(99) / 1e3 << std::setw(10)
+                   << h.get_value_at_percentile(99.9) / 1e3 << std::setw(10)
+                   << h.get_max() / 1e3 << "\n";
+        }
+        stream << std::defaultfloat << std::flush;
+    }
+
+private:
+    SpscRingBuffer<CycleTimestamps> buffer_;
+    std::atomic<uint64_t> dropped_count_ = {0};
+
+    // members below are only accessed by the reader
+    std::array<LatencyHistogram, NUM_PHASES> histograms_;
+    std::ofstream output_;
+    bool has_previous_ = false;
+    uint64_t previous_cycle_ = 0;
+    int64_t previous_start_ns_ = 0;
+
+    std::atomic<bool> is_reader_running_ = {false};
+    std::thread reader_thread_;
+};
+
+}  // namespace robot_fingers
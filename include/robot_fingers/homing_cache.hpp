@@ -0,0 +1,258 @@
+/**
+ * @file
+ * @brief Persisted homing state for skipping the homing on warm restarts.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+#include <Eigen/Eigen>
+#include <yaml_utils/yaml_eigen.hpp>
+
+namespace robot_fingers
+{
+/**
+ * @brief Homing state of the robot, stored to skip homing on the next start.
+ *
+ * The motor boards count the encoder position relative to where they were
+ * powered on.  As long as they are not power-cycled, the zero angles found by
+ * the homing therefore stay valid, even if the driver is restarted.
+ *
+ * Positions are stored in this "raw" frame of the boards (i.e. without zero
+ * angles applied).  On the next start, the cache is only considered valid if
+ *
+ * - it was created with the same homing method and home offset,
+ * - the current raw joint positions match the stored ones (a power cycle
+ *   resets the position counter of the boards), and
+ * - for joints for which an encoder index was already measured, the raw index
+ *   angle matches the stored one (modulo the distance between two indices).
+ *
+ * The position check alone relies on the robot not being moved while the
+ * driver is not running.  Since no index is measured before the joints move,
+ * the driver additionally moves each joint over its next encoder index before
+ * accepting the cache and compares the index angles with
+ * matches_index_angles().
+ *
+ * @tparam N_JOINTS  Number of joints.
+ */
+template <size_t N_JOINTS>
+struct HomingCache
+{
+    typedef Eigen::Matrix<double, N_JOINTS, 1> Vector;
+
+    //! @brief Name of the homing method used to find the zero angles.
+    std::string homing_method;
+    //! @brief Home offset used to find the zero angles.
+    Vector home_offset_rad = Vector::Zero();
+    //! @brief Zero angles found by the homing (raw frame).
+    Vector zero_angles = Vector::Zero();
+    //! @brief Joint positions when the cache was written (raw frame).
+    Vector raw_position = Vector::Zero();
+    //! @brief Angles of the last encoder index of each joint (raw frame, NaN
+    //!        if none was measured).
+    Vector raw_index_angles =
+        Vector::Constant(std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * @brief Load the cache from a YAML file.
+     *
+     * @throws std::runtime_error if the file cannot be read or is invalid.
+     */
+    static HomingCache load(const std::string &filename)
+    {
+        HomingCache cache;
+        try
+        {
+            YAML::Node node = YAML::LoadFile(filename);
+            cache.homing_method = node["homing_method"].as<std::string>();
+            cache.home_offset_rad = node["home_offset_rad"].as<Vector>();
+            cache.zero_angles = node["zero_angles"].as<Vector>();
+            cache.raw_position = node["raw_position"].as<Vector>();
+            cache.raw_index_angles = node["raw_index_angles"].as<Vector>();
+        }
+        catch (const YAML::Exception &e)
+        {
+            throw std::runtime_error("Failed to load homing cache " +
+                                     filename + ": " + e.what());
+        }
+
+        return cache;
+    }
+
+    /**
+     * @brief Write the cache to a YAML file.
+     *
+     * The file is written to a temporary file first and then renamed, so an
+     * interrupted write does not leave a corrupted cache behind.
+     *
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string &filename) const
+    {
+        YAML::Node node;
+        node["homing_method"] = homing_method;
+        node["home_offset_rad"] = home_offset_rad;
+        node["zero_angles"] = zero_angles;
+        node["raw_position"] = raw_position;
+        node["raw_index_angles"] = raw_index_angles;
+
+        const std::string tmp_filename = filename + ".tmp";
+        {
+            std::ofstream file(tmp_filename);
+            file << node << "\n";
+            if (!file)
+            {
+                throw std::runtime_error("Failed to write homing cache " +
+                                         tmp_filename);
+            }
+        }
+        if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+        {
+            throw std::runtime_error("Failed to write homing cache " +
+                                     filename);
+        }
+    }
+
+    /**
+     * @brief Check if the cache is still valid for the current robot state.
+     *
+     * @param homing_method_  Currently configured homing method.
+     * @param home_offset_rad_  Currently configured home offset.
+     * @param current_raw_position  Current joint positions (raw frame).
+     * @param current_raw_index_angles  Angles of the last encoder index of
+     *     each joint measured since the driver started (raw frame, NaN if
+     *     none).
+     * @param position_tolerance_rad  Allowed deviation of positions and index
+     *     angles.
+     * @param index_spacing_rad  Joint distance between two encoder indices
+     *     (i.e. one motor revolution).
+     * @param reason  If not null, set to a description of why the cache is
+     *     not valid.
+     *
+     * @return True if the cache is valid.
+     */
+    bool is_valid(const std::string &homing_method_,
+                  const Vector &home_offset_rad_,
+                  const Vector &current_raw_position,
+                  const Vector &current_raw_index_angles,
+                  const double position_tolerance_rad,
+                  const double index_spacing_rad,
+                  std::string *reason = nullptr) const
+    {
+        std::ostringstream msg;
+
+        // small tolerance for the offset, as it went through a text file
+        if (homing_method_ != homing_method ||
+            !home_offset_rad_.isApprox(home_offset_rad, 1e-9))
+        {
+            msg << "Homing configuration changed.";
+        }
+        else
+        {
+            for (size_t i = 0; i < N_JOINTS; i++)
+            {
+                if (!(std::abs(current_raw_position[i] - raw_position[i]) <=
+                      position_tolerance_rad))
+                {
+                    msg << "Position of joint " << i << " changed.";
+                    break;
+                }
+
+                if (!std::isnan(current_raw_index_angles[i]) &&
+                    !std::isnan(raw_index_angles[i]) &&
+                    !index_matches(i,
+                                   current_raw_index_angles[i],
+                                   position_tolerance_rad,
+                                   index_spacing_rad))
+                {
+                    msg << "Encoder index of joint " << i << " moved.";
+                    break;
+                }
+            }
+        }
+
+        if (reason)
+        {
+            *reason = msg.str();
+        }
+        return msg.str().empty();
+    }
+
+    /**
+     * @brief Check if the encoder indices are where they were.
+     *
+     * Unlike is_valid(), this requires an index angle for every joint, both
+     * stored and current.  Use it after moving the joints over their encoder
+     * index.
+     *
+     * @param current_raw_index_angles  Angles of the last encoder index of
+     *     each joint (raw frame).
+     * @param position_tolerance_rad  Allowed deviation of the index angles.
+     * @param index_spacing_rad  Joint distance between two encoder indices
+     *     (i.e. one motor revolution).
+     * @param reason  If not null, set to a description of why the index angles
+     *     do not match.
+     *
+     * @return True if the index angles of all joints match the stored ones
+     *     (modulo the index spacing).
+     */
+    bool matches_index_angles(const Vector &current_raw_index_angles,
+                              const double position_tolerance_rad,
+                              const double index_spacing_rad,
+                              std::string *reason = nullptr) const
+    {
+        std::ostringstream msg;
+
+        for (size_t i = 0; i < N_JOINTS; i++)
+        {
+            if (std::isnan(raw_index_angles[i]))
+            {
+                msg << "No encoder index of joint " << i << " stored.";
+                break;
+            }
+            if (std::isnan(current_raw_index_angles[i]))
+            {
+                msg << "Encoder index of joint " << i << " not found.";
+                break;
+            }
+            if (!index_matches(i,
+                               current_raw_index_angles[i],
+                               position_tolerance_rad,
+                               index_spacing_rad))
+            {
+                msg << "Encoder index of joint " << i << " moved.";
+                break;
+            }
+        }
+
+        if (reason)
+        {
+            *reason = msg.str();
+        }
+        return msg.str().empty();
+    }
+
+private:
+    //! @brief Check if the index angle of the joint matches the stored one.
+    bool index_matches(size_t joint,
+                       double raw_index_angle,
+                       double position_tolerance_rad,
+                       double index_spacing_rad) const
+    {
+        // distance to the nearest index of the stored one
+        const double diff = std::remainder(
+            raw_index_angle - raw_index_angles[joint], index_spacing_rad);
+        return std::abs(diff) <= position_tolerance_rad;
+    }
+};
+
+}  // namespace robot_fingers
@@ -0,0 +1,129 @@
+/**
+ * @file
+ * @brief Timing of the phases of the robot initialisation.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace robot_fingers
+{
+/**
+ * @brief Durations of the phases of the robot initialisation.
+ *
+ * Durations are given in seconds.  Phases that were not executed (e.g. the
+ * end-stop search with a homing method that does not use the end stops) are
+ * NaN.
+ *
+ * The report can be serialised to JSON (@ref to_json), to compare startup
+ * times of different robots or software versions.
+ */
+struct InitializationReport
+{
+    //! @brief Duration of one move to the initial position.
+    struct Move
+    {
+        //! @brief Joints that were moved.
+        std::vector<size_t> joints;
+        double duration_s = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    //! @brief Time until all motor boards were ready.
+    double board_bring_up_s = std::numeric_limits<double>::quiet_NaN();
+    //! @brief Time until all joints reached the end stop.
+    double endstop_search_s = std::numeric_limits<double>::quiet_NaN();
+    //! @brief Time in which the motors were released after the end-stop
+    //!        search.
+    double zero_torque_release_s = std::numeric_limits<double>::quiet_NaN();
+    //! @brief Duration of the encoder index search.
+    double index_search_s = std::numeric_limits<double>::quiet_NaN();
+    //! @brief Moves to the initial position, in the order of execution.
+    std::vector<Move> initial_moves;
+    //! @brief Duration of the whole initialisation (without board bring-up).
+    double total_s = std::numeric_limits<double>::quiet_NaN();
+
+    //! @brief True if the homing was restored from the homing cache.
+    bool homing_restored_from_cache = false;
+    //! @brief True if the homing succeeded.
+    bool homing_succeeded = false;
+    //! @brief True if the initial position was reached.
+    bool reached_initial_position = false;
+
+    //! @brief Serialise the report to a JSON object (NaN is written as null).
+    std::string to_json() const
+    {
+        std::ostringstream json;
+        json << "{\n"
+             << "  \"board_bring_up_s\": " << number(board_bring_up_s) << ",\n"
+             << "  \"endstop_search_s\": " << number(endstop_search_s) << ",\n"
+             << "  \"zero_torque_release_s\": "
+             << number(zero_torque_release_s) << ",\n"
+             << "  \"index_search_s\": " << number(index_search_s) << ",\n"
+             << "  \"initial_moves\": [";
+        for (size_t i = 0; i < initial_moves.size(); i++)
+        {
+            json << (i == 0 ? "\n" : ",\n") << "    {\"joints\": [";
+            for (size_t j = 0; j < initial_moves[i].joints.size(); j++)
+            {
+                json << (j == 0 ? "" : ", ") << initial_moves[i].joints[j];
+            }
+            json << "], \"duration_s\": "
+                 << number(initial_moves[i].duration_s) << "}";
+        }
+        json << (initial_moves.empty() ? "" : "\n  ") << "],\n"
+             << "  \"total_s\": " << number(total_s) << ",\n"
+             << "  \"homing_restored_from_cache\": "
+             << boolean(homing_restored_from_cache) << ",\n"
+             << "  \"homing_succeeded\": " << boolean(homing_succeeded)
+             << ",\n"
+             << "  \"reached_initial_position\": "
+             << boolean(reached_initial_position) << "\n"
+             << "}";
+
+        return json.str();
+    }
+
+    /**
+     * @brief Write the report as JSON to the given file.
+     *
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void write_json(const std::string &filename) const
+    {
+        std::ofstream file(filename);
+        file << to_json() << "\n";
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write initialisation report " +
+                                     filename);
+        }
+    }
+
+private:
+    static std::string number(double value)
+    {
+        if (!std::isfinite(value))
+        {
+            return "null";
+        }
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(6) << value;
+        return s.str();
+    }
+
+    static const char *boolean(bool value)
+    {
+        return value ? "true" : "false";
+    }
+};
+
+}  // namespace robot_fingers
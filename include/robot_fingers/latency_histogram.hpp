@@ -0,0 +1,154 @@
+/**
+ * @file
+ * @brief Histogram for latency measurements.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace robot_fingers
+{
+/**
+ * @brief Histogram with logarithmic buckets for latency measurements.
+ *
+ * Uses the bucket layout of HDR histograms: values are grouped by their most
+ * significant bit and each of these groups is split into 2^SUB_BUCKET_BITS
+ * linear sub-buckets.  This way the relative error of the reported values is
+ * at most 2^-SUB_BUCKET_BITS (about 3 %) over the whole value range while the
+ * memory is fixed and small.  Small values (< 2^(SUB_BUCKET_BITS + 1)) are
+ * recorded exactly.
+ *
+ * Recording a value does not allocate memory.
+ */
+class LatencyHistogram
+{
+public:
+    //! @brief Number of bits used for the linear sub-buckets.
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int64_t SUB_BUCKET_COUNT = int64_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT =
+        (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    /**
+     * @brief Add a value to the histogram.
+     *
+     * @param value  The value.  Negative values are recorded as zero.
+     */
+    void record(int64_t value)
+    {
+        value = std::max(value, int64_t(0));
+
+        counts_[get_bucket_index(value)]++;
+        total_count_++;
+        sum_ += static_cast<double>(value);
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    //! @brief Remove all recorded values.
+    void reset()
+    {
+        *this = LatencyHistogram();
+    }
+
+    //! @brief Number of recorded values.
+    uint64_t get_count() const
+    {
+        return total_count_;
+    }
+
+    //! @brief Smallest recorded value (0 if histogram is empty).
+    int64_t get_min() const
+    {
+        return total_count_ == 0 ? 0 : min_;
+    }
+
+    //! @brief Largest recorded value (0 if histogram is empty).
+    int64_t get_max() const
+    {
+        return max_;
+    }
+
+    //! @brief Mean of all recorded values (0 if histogram is empty).
+    double get_mean() const
+    {
+        return total_count_ == 0 ? 0.0 : sum_ / total_count_;
+    }
+
+    /**
+     * @brief Get the value at the given percentile.
+     *
+     * @param percentile  Percentile in the range [0, 100].
+     * @return The highest value that is equivalent (i.e. in the same bucket)
+     *     to the value at the given percentile.  0 if the histogram is empty.
+     */
+    int64_t get_value_at_percentile(double percentile) const
+    {
+        if (total_count_ == 0)
+        {
+            return 0;
+        }
+
+        percentile = std::clamp(percentile, 0.0, 100.0);
+        const uint64_t target_count = std::max(
+            uint64_t(1),
+            static_cast<uint64_t>(percentile / 100.0 * total_count_ + 0.5));
+
+        uint64_t cumulative_count = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            cumulative_count += counts_[i];
+            if (cumulative_count >= target_count)
+            {
+                return std::min(get_highest_equivalent_value(i), max_);
+            }
+        }
+
+        return max_;
+    }
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> counts_ = {};
+    uint64_t total_count_ = 0;
+    double sum_ = 0;
+    int64_t min_ = std::numeric_limits<int64_t>::max();
+    int64_t max_ = 0;
+
+    static size_t get_bucket_index(int64_t value)
+    {
+        if (value < 2 * SUB_BUCKET_COUNT)
+        {
+            return static_cast<size_t>(value);
+        }
+
+        const int msb = 63 - __builtin_clzll(static_cast<uint64_t>(value));
+        const int shift = msb - SUB_BUCKET_BITS;
+        const int64_t mantissa = value >> shift;
+
+        return static_cast<size_t>((shift + 1) * SUB_BUCKET_COUNT + mantissa -
+                                   SUB_BUCKET_COUNT);
+    }
+
+    static int64_t get_highest_equivalent_value(size_t index)
+    {
+        if (static_cast<int64_t>(index) < 2 * SUB_BUCKET_COUNT)
+        {
+            return static_cast<int64_t>(index);
+        }
+
+        const int shift = static_cast<int>(index / SUB_BUCKET_COUNT) - 1;
+        const uint64_t mantissa = index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+        const uint64_t highest = ((mantissa + 1) << shift) - 1;
+
+        return static_cast<int64_t>(std::min(
+            highest,
+            static_cast<uint64_t>(std::numeric_limits<int64_t>::max())));
+    }
+};
+
+}  // namespace robot_fingers
@@ -0,0 +1,162 @@
+/**
+ * @file
+ * @brief Concurrent bring-up of multiple motor boards.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace robot_fingers
+{
+/**
+ * @brief Result of the bring-up of a single motor board.
+ */
+struct BoardStartupReport
+{
+    //! @brief CAN port of the board.
+    std::string can_port;
+    //! @brief True if the board reported to be ready before the timeout.
+    bool is_ready = false;
+    //! @brief Time from the start of the bring-up until the board was ready
+    //!        (or until giving up on it).
+    double duration_s = 0.0;
+    //! @brief Error message if setting up the board failed with an exception.
+    std::string error;
+};
+
+/**
+ * @brief Print the per-board readiness report.
+ */
+template <size_t N_BOARDS>
+void print_board_startup_report(
+    const std::array<BoardStartupReport, N_BOARDS> &reports)
+{
+    std::cout << "Motor board startup:" << std::endl;
+    for (const BoardStartupReport &report : reports)
+    {
+        std::cout << "\t " << report.can_port << ": ";
+        if (report.is_ready)
+        {
+            std::cout << "ready after ";
+        }
+        else if (!report.error.empty())
+        {
+            std::cout << "FAILED (" << report.error << ") after ";
+        }
+        else
+        {
+            std::cout << "NOT READY after ";
+        }
+        std::cout << std::fixed << std::setprecision(3) << report.duration_s
+                  << " s" << std::defaultfloat << std::endl;
+    }
+}
+
+/**
+ * @brief Set up motor boards concurrently and wait until all are ready.
+ *
+ * Each board is created and polled for readiness in its own thread, so the
+ * total startup time is given by the slowest board instead of the sum of all
+ * board handshakes.  A readiness report with the startup time of each board is
+ * printed in any case.
+ *
+ * @tparam Board  Type of the motor boards.  Needs to provide a method
+ *     `is_ready()`.
+ * @tparam N_BOARDS  Number of motor boards.
+ * @tparam CreateBoard  Callable with signature
+ *     `std::shared_ptr<Board>(const std::string &can_port)`.
+ *
+ * @param can_ports  CAN ports of the boards.
+ * @param create_board  Function creating the board for a given CAN port.
+ * @param timeout_s  Total time the boards have to get ready.  Use infinity to
+ *     wait forever.
+ * @param poll_interval_s  Interval in which `is_ready()` is polled.
+ *
+ * @return The motor boards, in the same order as can_ports.
+ *
+ * @throws std::runtime_error if not all boards are ready within the timeout.
+ *     The message lists the CAN ports of the boards that are not ready.
+ */
+template <typename Board, size_t N_BOARDS, typename CreateBoard>
+std::array<std::shared_ptr<Board>, N_BOARDS> bring_up_motor_boards(
+    const std::array<std::string, N_BOARDS> &can_ports,
+    CreateBoard create_board,
+    double timeout_s,
+    double poll_interval_s = 0.01)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const auto start = Clock::now();
+    auto elapsed_s = [start]() {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    std::array<std::shared_ptr<Board>, N_BOARDS> boards;
+    std::array<BoardStartupReport, N_BOARDS> reports;
+    std::array<std::future<void>, N_BOARDS> startups;
+
+    for (size_t i = 0; i < N_BOARDS; i++)
+    {
+        reports[i].can_port = can_ports[i];
+
+        // Each task only writes its own entries of boards and reports.
+        startups[i] = std::async(std::launch::async, [&, i]() {
+            try
+            {
+                boards[i] = create_board(can_ports[i]);
+
+                while (!boards[i]->is_ready() && elapsed_s() < timeout_s)
+                {
+                    std::this_thread::sleep_for(
+                        std::chrono::duration<double>(poll_interval_s));
+                }
+                reports[i].is_ready = boards[i]->is_ready();
+            }
+            catch (const std::exception &e)
+            {
+                reports[i].error = e.what();
+            }
+            reports[i].duration_s = elapsed_s();
+        });
+    }
+
+    for (auto &startup : startups)
+    {
+        startup.wait();
+    }
+
+    print_board_startup_report(reports);
+
+    std::string not_ready_ports;
+    for (const BoardStartupReport &report : reports)
+    {
+        if (!report.is_ready)
+        {
+            not_ready_ports += (not_ready_ports.empty() ? "" : ", ") +
+                               report.can_port;
+        }
+    }
+    if (!not_ready_ports.empty())
+    {
+        std::ostringstream msg;
+        msg << "Motor boards not ready after " << elapsed_s()
+            << " s (timeout: " << timeout_s << " s): " << not_ready_ports;
+        throw std::runtime_error(msg.str());
+    }
+
+    return boards;
+}
+
+}  // namespace robot_fingers
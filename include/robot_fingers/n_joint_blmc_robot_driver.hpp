@@ -7,10 +7,22 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <yaml-cpp/yaml.h>
 #include <Eigen/Eigen>
@@ -21,7 +33,18 @@
 #include <yaml_utils/yaml_eigen.hpp>
 
 #include <blmc_drivers/blmc_joint_module.hpp>
+#include <robot_fingers/background_log_writer.hpp>
 #include <robot_fingers/clamp.hpp>
+#include <robot_fingers/config_snapshot.hpp>
+#include <robot_fingers/cycle_timing_trace.hpp>
+#include <robot_fingers/homing_cache.hpp>
+#include <robot_fingers/initialization_report.hpp>
+#include <robot_fingers/motor_board_startup.hpp>
+#include <robot_fingers/parallel_board_sender.hpp>
+#include <robot_fingers/periodic_scheduler.hpp>
+#include <robot_fingers/stall_detector.hpp>
+#include <robot_fingers/trajectory.hpp>
+#include <robot_fingers/triple_buffer.hpp>
 
 namespace robot_fingers
 {
@@ -50,8 +73,13 @@ struct MotorParameters
  *
  * @tparam N_JOINTS Number of joints.
  * @tparam N_MOTOR_BOARDS Number of motor control boards that are used.
+ * @tparam MotorBoardType Type of the motor boards.  Only to be changed for
+ *     testing, e.g. to run the driver with simulated boards.
  */
-template <typename Observation, size_t N_JOINTS, size_t N_MOTOR_BOARDS>
+template <typename Observation,
+          size_t N_JOINTS,
+          size_t N_MOTOR_BOARDS,
+          typename MotorBoardType = blmc_drivers::CanBusMotorBoard>
 class NJointBlmcRobotDriver
     : public robot_interfaces::RobotDriver<
           typename robot_interfaces::NJointAction<N_JOINTS>,
@@ -66,14 +94,142 @@ public:
         Types;
 
     typedef typename Action::Vector Vector;
+    /**
+     * @brief Values of all joints over T time steps (one row per time step).
+     *
+     * Row-major, so the values of one time step are contiguous in memory (a
+     * row-major matrix with only one column is not allowed by Eigen).
+     */
+    typedef Eigen::Matrix<double,
+                          Eigen::Dynamic,
+                          N_JOINTS,
+                          N_JOINTS == 1 ? Eigen::ColMajor : Eigen::RowMajor>
+        JointTrajectory;
     typedef std::array<std::shared_ptr<blmc_drivers::MotorInterface>, N_JOINTS>
         Motors;
-    typedef std::array<std::shared_ptr<blmc_drivers::CanBusMotorBoard>,
-                       N_MOTOR_BOARDS>
-        MotorBoards;
+    typedef MotorBoardType MotorBoard;
+    typedef std::array<std::shared_ptr<MotorBoard>, N_MOTOR_BOARDS> MotorBoards;
 
     struct Config;  // actual declaration see below
 
+    /**
+     * @brief Error state of the robot.
+     *
+     * Fixed-size representation of all errors that are checked by @ref
+     * get_error.  It can be filled without allocating memory, so it can be
+     * used in the real-time loop.  The human-readable message is only
+     * generated when calling @ref to_string.
+     */
+    struct ErrorState
+    {
+        /**
+         * @brief Error code reported by each motor board.
+         *
+         * See blmc_drivers::MotorBoardStatus::ErrorCodes.  Zero means no error.
+         */
+        std::array<uint8_t, N_MOTOR_BOARDS> board_error_codes = {};
+
+        //! @brief True if the joint positions exceed the hard limits.
+        bool position_limits_exceeded = false;
+
+        //! @brief True if any error is set.
+        bool has_error() const
+        {
+            if (position_limits_exceeded)
+            {
+                return true;
+            }
+            for (uint8_t error_code : board_error_codes)
+            {
+                if (error_code != 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Get human-readable description of the errors.
+         *
+         * Each board error is prepended with the index of the corresponding
+         * board.
+         *
+         * @return Description of all errors or an empty string if there is no
+         *     error.
+         */
+        std::string to_string() const;
+    };
+
+    /**
+     * @brief Result of the shutdown trajectory.
+     *
+     * See @ref get_shutdown_status.
+     */
+    struct ShutdownStatus
+    {
+        //! @brief True if shutdown() was executed.
+        bool is_shut_down = false;
+
+        //! @brief True if all steps of the shutdown trajectory were reached.
+        bool reached_rest_position = false;
+
+        //! @brief True if the trajectory was aborted because
+        //!        Config::shutdown_timeout_s was exceeded.
+        bool deadline_exceeded = false;
+
+        //! @brief Index of the trajectory step that was not reached (-1 if
+        //!        all steps were reached).
+        int failed_step = -1;
+
+        //! @brief Position error w.r.t. the target of the failed step (zero if
+        //!        all steps were reached).
+        Vector position_error = Vector::Zero();
+
+        //! @brief Duration of the shutdown trajectory [s].
+        double duration_s = 0.0;
+
+        /**
+         * @brief Get human-readable description of the status.
+         */
+        std::string to_string() const;
+    };
+
+    /**
+     * @brief Parameters that can be changed while the robot is running.
+     *
+     * See set_runtime_parameters().  Initialised from the corresponding
+     * values of the Config.
+     */
+    struct RuntimeParameters
+    {
+        //! @brief See Config::position_control_gains.
+        Vector position_control_kp = Vector::Zero();
+        //! @brief See Config::position_control_gains.
+        Vector position_control_kd = Vector::Zero();
+        //! @brief See Config::safety_kd.
+        Vector safety_kd = Vector::Zero();
+        //! @brief See Config::soft_position_limits_lower.
+        Vector soft_position_limits_lower =
+            Vector::Constant(-std::numeric_limits<double>::infinity());
+        //! @brief See Config::soft_position_limits_upper.
+        Vector soft_position_limits_upper =
+            Vector::Constant(std::numeric_limits<double>::infinity());
+
+        //! @brief Get the parameters from the given configuration.
+        static RuntimeParameters from_config(const Config &config);
+
+        /**
+         * @brief Check if the parameters are valid.
+         *
+         * Gains need to be non-negative and the lower soft limits must not be
+         * greater than the upper ones.
+         *
+         * @throws std::invalid_argument if a parameter is invalid.
+         */
+        void validate() const;
+    };
+
     /**
      * @brief True if the joints have mechanical end stops, false if not.
      *
@@ -88,10 +244,27 @@ public:
      */
     const bool has_endstop_;
 
+    /**
+     * @param motor_boards  The motor boards of the robot.
+     * @param motors  The motors, in the order of the joints.
+     * @param motor_parameters  Parameters of the motors.
+     * @param config  Configuration of the robot.  It is validated here as
+     *     well, as it may not have been loaded from a file.
+     * @param board_bring_up_s  Time it took to bring up the motor boards
+     *     (see create_motor_boards()).  Only used for the initialisation
+     *     report.
+     *
+     * @throws std::invalid_argument if Config::initial_move_groups are
+     *     invalid (see Config::validate_initial_move_groups()) or if a step
+     *     of Config::shutdown_trajectory is invalid (see
+     *     Config::validate_shutdown_trajectory()).
+     */
     NJointBlmcRobotDriver(const MotorBoards &motor_boards,
                           const Motors &motors,
                           const MotorParameters &motor_parameters,
-                          const Config &config)
+                          const Config &config,
+                          double board_bring_up_s =
+                              std::numeric_limits<double>::quiet_NaN())
         : robot_interfaces::RobotDriver<Action, Observation>(),
           has_endstop_(config.has_endstop),
           joint_modules_(motors,
@@ -104,13 +277,96 @@ public:
           max_torque_Nm_(config.max_current_A *
                          motor_parameters.torque_constant_NmpA *
                          motor_parameters.gear_ratio),
-          config_(config)
+          config_(config),
+          control_loop_scheduler_(config.control_period_s),
+          stall_detector_(
+              std::max(std::lround(STALL_WINDOW_DURATION_S /
+                                   config.control_period_s),
+                       1l),
+              STALL_VELOCITY_RADPS,
+              std::lround(MIN_ENDSTOP_SEARCH_DURATION_S /
+                          config.control_period_s)),
+          runtime_parameters_(RuntimeParameters::from_config(config)),
+          latest_runtime_parameters_(RuntimeParameters::from_config(config))
     {
+        // configurations created in code do not pass parse_config(), so
+        // check the parts that would only fail late (i.e. in initialize() or
+        // shutdown())
+        if (config.initial_move_order == Config::InitialMoveOrder::GROUPS)
+        {
+            Config::validate_initial_move_groups(config.initial_move_groups);
+        }
+        config.validate_shutdown_trajectory();
+
         pause_motors();
+
+        initialization_report_.board_bring_up_s = board_bring_up_s;
+
+        if (config.enable_timing_trace)
+        {
+            timing_trace_ = std::make_unique<CycleTimingTrace>(
+                TIMING_TRACE_BUFFER_CAPACITY, config.timing_trace_file);
+            timing_trace_->start();
+        }
+
+        if (!config.run_duration_logfiles.empty())
+        {
+            run_duration_log_writer_ = std::make_unique<BackgroundLogWriter>();
+        }
+
+        if (config.parallel_can_send)
+        {
+            parallel_board_sender_ =
+                std::make_unique<ParallelBoardSender<MotorBoard>>(
+                    std::vector<std::shared_ptr<MotorBoard>>(
+                        motor_boards.begin(), motor_boards.end()),
+                    config.can_send_cpus);
+        }
+
+        // precompute the profiles of the configured moves (the duration of
+        // velocity-limited moves is only known when they are executed)
+        std::vector<uint32_t> profile_steps = {config.calibration.move_steps};
+        for (const auto &step : config.shutdown_trajectory)
+        {
+            profile_steps.push_back(step.move_steps);
+        }
+        for (uint32_t steps : profile_steps)
+        {
+            if (steps > 0 && min_jerk_profiles_.count(steps) == 0)
+            {
+                min_jerk_profiles_.emplace(
+                    steps,
+                    Trajectory::min_jerk_profile(steps,
+                                                 config.control_period_s));
+            }
+        }
     }
 
-    static MotorBoards create_motor_boards(
-        const std::array<std::string, N_MOTOR_BOARDS> &can_ports);
+    //! @brief Motor boards created by create_motor_boards().
+    struct MotorBoardSetup
+    {
+        MotorBoards boards;
+        //! @brief Time it took to bring up the boards [s].
+        double bring_up_s = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    /**
+     * @brief Set up the motor boards and wait until they are ready.
+     *
+     * The boards are brought up concurrently and a readiness report is printed
+     * (see @ref bring_up_motor_boards).
+     *
+     * @param can_ports  CAN ports of the boards.
+     * @param ready_timeout_s  Total time the boards have to get ready.
+     *
+     * @return The boards and the duration of the bring-up (pass the latter to
+     *     the constructor, so it is included in the initialisation report).
+     * @throws std::runtime_error if not all boards are ready within the
+     *     timeout.
+     */
+    static MotorBoardSetup create_motor_boards(
+        const std::array<std::string, N_MOTOR_BOARDS> &can_ports,
+        double ready_timeout_s = std::numeric_limits<double>::infinity());
 
     Vector get_max_torques() const
     {
@@ -139,7 +395,28 @@ public:
 
     virtual Observation get_latest_observation() override = 0;
     Action apply_action(const Action &desired_action) override;
+
+    /**
+     * @brief Get description of the current error (if any).
+     *
+     * The message is only generated if there actually is an error, so this
+     * does not allocate memory as long as everything is fine.
+     *
+     * @return Error message or an empty string if there is no error.
+     * @see get_error_state
+     */
     std::string get_error() override;
+
+    /**
+     * @brief Check the motor boards and joint positions for errors.
+     *
+     * This does not allocate memory.
+     */
+    ErrorState get_error_state() const;
+
+    //! @brief Get the error message for the given motor board error code.
+    static const char *get_board_error_message(uint8_t error_code);
+
     void shutdown() override;
 
     /**
@@ -197,6 +474,88 @@ public:
         const Vector &upper_position_limits =
             Vector::Constant(std::numeric_limits<double>::infinity()));
 
+    /**
+     * @brief Actions of T time steps in structure-of-arrays layout.
+     *
+     * Each member contains the corresponding values of the actions, one row
+     * per time step.
+     */
+    struct ActionBatch
+    {
+        JointTrajectory torque;
+        JointTrajectory position;
+        JointTrajectory position_kp;
+        JointTrajectory position_kd;
+
+        //! @brief Number of time steps in the batch.
+        Eigen::Index size() const
+        {
+            return torque.rows();
+        }
+    };
+
+    /**
+     * @brief Apply process_desired_action() to a batch of time steps.
+     *
+     * This is meant for offline processing of large amounts of data, e.g. to
+     * verify the applied actions of a robot log.  The time steps are split
+     * into chunks which are processed in parallel.  For each time step, the
+     * result is exactly the same as when calling process_desired_action() with
+     * the corresponding action and observation.
+     *
+     * @param desired_actions  Desired actions of all time steps.
+     * @param observed_positions  Observed joint positions of all time steps.
+     * @param observed_velocities  Observed joint velocities of all time steps.
+     * @param max_torque_Nm  See process_desired_action().
+     * @param safety_kd  See process_desired_action().
+     * @param default_position_control_kp  See process_desired_action().
+     * @param default_position_control_kd  See process_desired_action().
+     * @param lower_position_limits  See process_desired_action().
+     * @param upper_position_limits  See process_desired_action().
+     * @param num_threads  Number of threads that are used.  If zero, the
+     *     number of hardware threads is used.
+     *
+     * @return The resulting actions of all time steps.
+     * @throws std::invalid_argument if the number of time steps in the inputs
+     *     does not match.
+     */
+    static ActionBatch process_desired_action_batch(
+        const ActionBatch &desired_actions,
+        const JointTrajectory &observed_positions,
+        const JointTrajectory &observed_velocities,
+        const double max_torque_Nm,
+        const Vector &safety_kd,
+        const Vector &default_position_control_kp,
+        const Vector &default_position_control_kd,
+        const Vector &lower_position_limits =
+            Vector::Constant(-std::numeric_limits<double>::infinity()),
+        const Vector &upper_position_limits =
+            Vector::Constant(std::numeric_limits<double>::infinity()),
+        unsigned int num_threads = 0);
+
+    /**
+     * @brief Number of steps of a minimum jerk move respecting the limits.
+     *
+     * The peak velocity of a minimum jerk trajectory of duration T over the
+     * distance D is 1.875 D/T, the peak acceleration is 10/sqrt(3) D/T^2.
+     * The duration is chosen as the shortest one for which both stay within
+     * the given limits on all joints (but never longer than max_steps).
+     *
+     * @param distance  Distance to move for each joint.
+     * @param max_velocity  Maximum joint velocity [rad/s].
+     * @param max_acceleration  Maximum joint acceleration [rad/s^2].
+     * @param control_period_s  Duration of one step [s].
+     * @param max_steps  Upper bound for the number of steps.  Returned as is if
+     *     neither limit is finite.
+     *
+     * @return Number of steps of the move.
+     */
+    static uint32_t get_min_jerk_duration_steps(const Vector &distance,
+                                                const double max_velocity,
+                                                const double max_acceleration,
+                                                const double control_period_s,
+                                                const uint32_t max_steps);
+
     /**
      * @brief Check if the joint position is within the hard limits.
      *
@@ -204,6 +563,72 @@ public:
      */
     bool is_within_hard_position_limits(const Observation &observation) const;
 
+    //! @brief Configuration the driver was created with.
+    const Config &get_config() const
+    {
+        return config_;
+    }
+
+    /**
+     * @brief Get the scheduler that is used to time the control loop.
+     *
+     * Can be used to access the overrun counters of the control loop.
+     */
+    const PeriodicScheduler &get_control_loop_scheduler() const
+    {
+        return control_loop_scheduler_;
+    }
+
+    /**
+     * @brief Number of cycles in which no new measurement arrived in time.
+     *
+     * Only counted if Config::wait_for_new_measurement is enabled.
+     */
+    uint64_t get_missed_measurement_count() const
+    {
+        return missed_measurement_count_;
+    }
+
+    /**
+     * @brief Result of the shutdown trajectory.
+     *
+     * Only valid once shutdown() returned.
+     */
+    const ShutdownStatus &get_shutdown_status() const
+    {
+        return shutdown_status_;
+    }
+
+    /**
+     * @brief Durations of the phases of the initialisation.
+     *
+     * Only valid once initialize() returned.  The report is also written to
+     * Config::initialization_report_file if set.
+     */
+    const InitializationReport &get_initialization_report() const
+    {
+        return initialization_report_;
+    }
+
+    /**
+     * @brief Change gains and soft limits while the robot is running.
+     *
+     * The parameters are validated and then handed over to the control loop
+     * without locking, they are used starting with the next call of
+     * apply_action().  This way they can be tuned without restarting the
+     * robot.
+     *
+     * Must not be called from the control thread.
+     *
+     * @throws std::invalid_argument if the parameters are invalid (see
+     *     RuntimeParameters::validate()).  The current parameters are kept in
+     *     this case.
+     */
+    void set_runtime_parameters(const RuntimeParameters &parameters);
+
+    //! @brief Parameters that were set last (see set_runtime_parameters()).
+    RuntimeParameters get_runtime_parameters() const;
+
 protected:
     blmc_drivers::BlmcJointModules<N_JOINTS> joint_modules_;
     MotorBoards motor_boards_;
@@ -227,21 +652,160 @@ protected:
     //! \brief Counter for the number of actions sent to the robot.
     uint32_t action_counter_ = 0;
 
+    /**
+     * @brief Scheduler for timing the control loop.
+     *
+     * The scheduler is started with the first action and stopped at the end of
+     * the initialisation (as there may be an arbitrary long pause between
+     * initialisation and the first action sent by the backend).
+     */
+    PeriodicScheduler control_loop_scheduler_;
+
+    //! @brief Duration of the window for averaging the velocity when
+    //!        detecting stalled joints in move_until_blocking().
+    static constexpr double STALL_WINDOW_DURATION_S = 0.1;
+    //! @brief Velocity below which a joint is considered to be stalled.
+    static constexpr double STALL_VELOCITY_RADPS = 0.01;
+    //! @brief Absolute velocity of the joints during the encoder index
+    //!        search.
+    static constexpr double INDEX_SEARCH_VELOCITY_RADPS = 0.3;
+    //! @brief Period of the loop in which
+    //!        blmc_drivers::BlmcJointModules::execute_homing() moves the
+    //!        joints (fixed to 1 kHz there, independent of
+    //!        Config::control_period_s).
+    static constexpr double JOINT_MODULES_HOMING_PERIOD_S = 0.001;
+    //! @brief Duration after which joints that did not move at all are
+    //!        accepted as stalled in move_until_blocking().
+    static constexpr double MIN_ENDSTOP_SEARCH_DURATION_S = 1.0;
+    //! @brief Maximum duration for which execute_trajectory() holds the
+    //!        target of a step without `move_steps` after its profile.
+    static constexpr double TRAJECTORY_HOLD_DURATION_S = 1.0;
+
+    //! @brief Detects stalled joints in move_until_blocking() (allocated once
+    //!        here, so the search loop does not allocate).
+    StallDetector<N_JOINTS> stall_detector_;
+
+    //! @brief Number of cycles the timing trace can buffer.
+    static constexpr size_t TIMING_TRACE_BUFFER_CAPACITY = 16384;
+
+    /**
+     * @brief Trace of the timing of each control cycle.
+     *
+     * Only set if enabled in the configuration (see
+     * Config::enable_timing_trace).
+     */
+    std::unique_ptr<CycleTimingTrace> timing_trace_;
+
+    /**
+     * @brief Sends torque commands to all boards in parallel.
+     *
+     * Only set if enabled in the configuration (see Config::parallel_can_send).
+     */
+    std::unique_ptr<ParallelBoardSender<MotorBoard>> parallel_board_sender_;
+
+    //! @brief Measurements that are awaited if Config::wait_for_new_measurement
+    //!        is set.
+    static constexpr std::array<
+        blmc_drivers::MotorBoardInterface::MeasurementIndex,
+        2>
+        AWAITED_MEASUREMENTS = {
+            blmc_drivers::MotorBoardInterface::MeasurementIndex::position_0,
+            blmc_drivers::MotorBoardInterface::MeasurementIndex::velocity_0};
+
+    //! @brief Time index of the last processed measurement of each board (see
+    //!        wait_for_new_measurements()).
+    std::array<std::array<time_series::Index, AWAITED_MEASUREMENTS.size()>,
+               N_MOTOR_BOARDS>
+        last_measurement_index_ = {};
+
+    //! @brief See get_missed_measurement_count().
+    uint64_t missed_measurement_count_ = 0;
+
+    //! @brief See get_shutdown_status().
+    ShutdownStatus shutdown_status_;
+
+    //! @brief See get_initialization_report().
+    InitializationReport initialization_report_;
+
+    /**
+     * @brief Hands over runtime parameters to the control loop.
+     *
+     * Written by set_runtime_parameters(), read by
+     * apply_action_uninitialized() at the beginning of each cycle.
+     */
+    TripleBuffer<RuntimeParameters> runtime_parameters_;
+    //! @brief Last parameters passed to set_runtime_parameters().
+    RuntimeParameters latest_runtime_parameters_;
+    //! @brief Serialises writers of the runtime parameters (never locked by
+    //!        the control loop).
+    mutable std::mutex runtime_parameters_mutex_;
+
+    /**
+     * @brief Writes the run duration logs.
+     *
+     * Only set if Config::run_duration_logfiles is not empty.  The file I/O
+     * is done by the writer thread, so it does not delay pausing the motors
+     * in shutdown().  shutdown() only waits for it at the very end.
+     */
+    std::unique_ptr<BackgroundLogWriter> run_duration_log_writer_;
+
+    /**
+     * @brief Wait until new measurements of all motor boards arrived.
+     *
+     * Waits for the measurements listed in AWAITED_MEASUREMENTS to advance
+     * beyond the time index that was seen in the previous call.  Gives up
+     * after one control period.
+     *
+     * @return True if new measurements of all boards arrived, false on
+     *     timeout.
+     */
+    bool wait_for_new_measurements();
+
     Action apply_action_uninitialized(const Action &desired_action);
 
     //! \brief Actual initialization that is called in a real-time thread in
     //!        initialize().
     void _initialize();
 
+    //! \brief Get the number of control cycles needed for the given duration.
+    uint32_t duration_to_steps(const double duration_s) const
+    {
+        return static_cast<uint32_t>(
+            std::lround(duration_s / config_.control_period_s));
+    }
+
+    //! @brief Result of @ref move_until_blocking.
+    struct MoveUntilBlockingResult
+    {
+        //! @brief True if all joints stalled before the timeout.
+        bool all_stalled = false;
+        //! @brief Time after which each joint stalled [s] (NaN if it did not).
+        Vector stall_time_s =
+            Vector::Constant(std::numeric_limits<double>::quiet_NaN());
+        //! @brief Total duration of the move [s].
+        double duration_s = 0.0;
+    };
+
     /**
      * @brief Move with constant torque until all joints are blocking.
      *
      * Applies a constant torque until all joints are reporting a velocity close
      * to zero.  This can be used to move against the end-stops.
      *
+     * Stalling is detected per joint (see @ref StallDetector), using only
+     * velocities measured after the joint started moving, so joints that
+     * start moving late are not missed.  Joints that do not move at all (e.g.
+     * because they already are at the end stop) are considered stalled after
+     * @ref MIN_ENDSTOP_SEARCH_DURATION_S.  What is done
+     * with a stalled joint while the others are still moving is set by
+     * Config::CalibrationParameters::endstop_stall_action.  The move ends as
+     * soon as all joints are stalled or after
+     * Config::CalibrationParameters::endstop_search_timeout_s.
+     *
      * @param torques_Nm Torques that are applied to the joints.
+     * @return Whether all joints stalled and when.
      */
-    void move_until_blocking(Vector torques_Nm);
+    MoveUntilBlockingResult move_until_blocking(const Vector &torques_Nm);
 
     /**
      * @brief Homing of all joints, based on the robot configuration.
@@ -266,30 +830,192 @@ protected:
      */
     bool homing();
 
+    /**
+     * @brief Restore the result of a previous homing from the homing cache.
+     *
+     * Only done if @ref Config::homing_cache_file is set and the cache is
+     * still valid for the current state of the robot (see @ref HomingCache).
+     * To check the latter, the joints are moved over their next encoder index
+     * (at most one motor revolution, see find_encoder_indices()) and back.
+     *
+     * @returns True if the zero angles were restored, false if the homing
+     *     needs to be done.
+     */
+    bool restore_homing_cache();
+
+    /**
+     * @brief Move the joints until each of them passed an encoder index.
+     *
+     * Joints for which no index was measured yet move with
+     * @ref INDEX_SEARCH_VELOCITY_RADPS in the direction of the index search
+     * of the homing, for at most one motor revolution.  Afterwards all joints
+     * move back to their start position.  Use get_measured_index_angles() to
+     * check if all indices were found.
+     */
+    void find_encoder_indices();
+
+    /**
+     * @brief Direction (+1/-1) of the encoder index search of each joint.
+     *
+     * Opposite to the end-stop search (see
+     * Config::CalibrationParameters::endstop_search_torques_Nm).
+     */
+    Vector get_index_search_direction() const;
+
+    /**
+     * @brief Store the current zero angles in the homing cache.
+     *
+     * Does nothing if @ref Config::homing_cache_file is not set.  Failure to
+     * write the file is reported but not considered an error.
+     */
+    void save_homing_cache();
+
+    //! @brief Current joint positions and index angles in the raw frame.
+    HomingCache<N_JOINTS> get_current_homing_state();
+
+    /**
+     * @brief Normalised minimum jerk profiles, by number of steps.
+     *
+     * Profiles for the moves given in the configuration are computed when
+     * constructing the driver.  Not modified afterwards, so the control loop
+     * never allocates memory for it.
+     */
+    std::map<uint32_t, Trajectory> min_jerk_profiles_;
+
+    /**
+     * @brief Get the phase of a minimum jerk move at the given step.
+     *
+     * Step t is sampled at its end, i.e. at `(t + 1) / num_steps` (see
+     * Trajectory), so the last step reaches the goal.  The precomputed
+     * profile is used if there is one for num_steps (see
+     * min_jerk_profiles_).  Otherwise (e.g. for durations derived from the
+     * velocity/acceleration limits) the phase is evaluated directly, so no
+     * memory is allocated.
+     *
+     * @param t  Step of the move, in [0, num_steps).
+     * @param num_steps  Number of steps of the move.
+     * @return Fraction of the distance that is covered after step t.
+     */
+    double get_min_jerk_phase(const uint32_t t, const uint32_t num_steps) const
+    {
+        auto it = min_jerk_profiles_.find(num_steps);
+        if (it != min_jerk_profiles_.end())
+        {
+            return it->second.positions()(t, 0);
+        }
+        return min_jerk_phase(static_cast<double>(t + 1) / num_steps);
+    }
+
+    //! @brief Result of @ref move_to_position.
+    struct MoveToPositionResult
+    {
+        //! @brief True if the goal position was reached.
+        bool reached_goal = false;
+        //! @brief Number of control cycles that were executed.
+        uint32_t executed_steps = 0;
+        //! @brief Time that was needed for the move [s].
+        double duration_s = 0.0;
+        //! @brief True if the move was aborted because the deadline passed.
+        bool deadline_exceeded = false;
+        //! @brief Remaining position error at the end of the move.
+        Vector position_error = Vector::Zero();
+    };
+
     /**
      * @brief Move to given goal position with a minimum jerk trajectory.
      *
      * Use a series of position actions to move to the given goal position on a
-     * minimum jerk trajectory.
+     * minimum jerk trajectory.  Each step scales the normalised profile (see
+     * get_min_jerk_phase()) to the actual distance.  The set point of step t
+     * is the one at the end of the step, i.e. at phase `(t + 1) / steps`, so
+     * the goal itself is commanded in the last step.
+     *
+     * If Config::move_to_position_max_velocity_radps and/or
+     * Config::move_to_position_max_acceleration_radps2 are set, the duration
+     * of the profile is derived from the distance to the goal (see
+     * get_min_jerk_duration_steps()), with time_steps as upper bound.  After
+     * the profile, the goal is held until all joints are within the tolerance
+     * or time_steps are used up in total.
+     *
+     * If Config::move_to_position_settled_velocity_radps is set, the move is
+     * ended early as soon as all joints are within the tolerance and slower
+     * than this velocity (e.g. if they are already at the goal).  This
+     * velocity condition then also applies to the end of the hold phase.
      *
      * @param goal_pos Angular goal position for each joint.
      * @param tolerance Allowed position error for reaching the goal.  This is
      *     checked per joint, that is the maximal possible error is +/-tolerance
      *     on each joint.
-     * @param time_steps Number of control loop cycles for reaching the goal.
-     *     The lower the number of steps, the faster the robot will move.
-     * @return True if goal position is reached, false if timeout is exceeded.
+     * @param time_steps Maximum number of control loop cycles for reaching the
+     *     goal (including the hold phase).  The lower the number of steps, the
+     *     faster the robot will move.
+     * @param deadline_ns Monotonic time (see get_monotonic_time_ns()) at which
+     *     the move is aborted, even if the trajectory is not finished yet.
+     * @return Whether the goal position was reached and the time needed.
+     */
+    MoveToPositionResult move_to_position(
+        const Vector &goal_pos,
+        const double tolerance,
+        const uint32_t time_steps,
+        const int64_t deadline_ns = std::numeric_limits<int64_t>::max());
+
+    //! @brief Result of @ref execute_trajectory.
+    struct ExecuteTrajectoryResult
+    {
+        //! @brief True if all steps reached their target position.
+        bool reached_goal = false;
+        //! @brief Number of control cycles that were executed.
+        uint32_t executed_steps = 0;
+        //! @brief Time that was needed for the trajectory [s].
+        double duration_s = 0.0;
+        //! @brief True if aborted because the deadline passed.
+        bool deadline_exceeded = false;
+        //! @brief Index of the step that failed (-1 if none failed).
+        int failed_step = -1;
+        //! @brief Position error of the failed step (zero for joints not
+        //!        moved by it).
+        Vector position_error = Vector::Zero();
+    };
+
+    /**
+     * @brief Move along the given trajectory.
+     *
+     * Each step is a minimum jerk move of its joints like in @ref
+     * move_to_position, starting from the target of the previous step of
+     * the joint (or the current position).  Steps are started as soon as the
+     * steps they depend on are finished (see
+     * Config::get_trajectory_dependencies()), so steps of different joints
+     * run concurrently.
+     *
+     * After its profile, the target of a step is held until all its joints
+     * are within the tolerance (and at rest if
+     * Config::move_to_position_settled_velocity_radps is set).  The target
+     * is held for at most TrajectoryStep::move_steps cycles (@ref
+     * TRAJECTORY_HOLD_DURATION_S if not set).  If the joints are not within
+     * the tolerance by then, the trajectory is aborted.
+     *
+     * @param trajectory  Steps of the trajectory.
+     * @param tolerance  Allowed position error for reaching a step target.
+     * @param deadline_ns  Monotonic time (see get_monotonic_time_ns()) at
+     *     which the trajectory is aborted.
      */
-    bool move_to_position(const Vector &goal_pos,
-                          const double tolerance,
-                          const uint32_t time_steps);
+    ExecuteTrajectoryResult execute_trajectory(
+        const std::vector<typename Config::TrajectoryStep> &trajectory,
+        const double tolerance,
+        const int64_t deadline_ns = std::numeric_limits<int64_t>::max());
 };
 
 /**
  * @brief Configuration of the robot that can be changed by the user.
  */
-template <typename Observation, size_t N_JOINTS, size_t N_MOTOR_BOARDS>
-struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
+template <typename Observation,
+          size_t N_JOINTS,
+          size_t N_MOTOR_BOARDS,
+          typename MotorBoardType>
+struct NJointBlmcRobotDriver<Observation,
+                             N_JOINTS,
+                             N_MOTOR_BOARDS,
+                             MotorBoardType>::Config
 {
     typedef std::array<std::string, N_MOTOR_BOARDS> CanPortArray;
 
@@ -299,8 +1025,44 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
         //! @brief Target position to which the joints should move.
         Vector target_position_rad = Vector::Zero();
 
-        //! @brief Number of time steps for reaching the target position.
+        /**
+         * @brief Number of time steps for reaching the target position.
+         *
+         * If @ref move_to_position_max_velocity_radps and/or @ref
+         * move_to_position_max_acceleration_radps2 are set, the duration is
+         * derived from the distance and this is only used as upper bound.
+         * Zero means no upper bound (only allowed if a limit is set).
+         *
+         * Also the maximum number of steps for which the target is held
+         * after the move if the joints did not reach it yet.
+         */
         uint32_t move_steps = 0;
+
+        /**
+         * @brief Joints that are moved by this step.
+         *
+         * Empty means all joints.  Other joints are not affected by the step
+         * (only the corresponding entries of @ref target_position_rad are
+         * used).
+         */
+        std::vector<size_t> joints;
+
+        //! @brief Check if the given joint is moved by this step.
+        bool moves_joint(size_t joint) const
+        {
+            return joints.empty() ||
+                   std::find(joints.begin(), joints.end(), joint) !=
+                       joints.end();
+        }
+
+        //! @brief Pass all members to the archive (see SnapshotWriter).
+        template <typename Archive>
+        void serialize(Archive &archive)
+        {
+            archive(target_position_rad);
+            archive(move_steps);
+            archive(joints);
+        }
     };
 
     //! @brief Different homing methods that can be selected.
@@ -358,6 +1120,36 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
         ENDSTOP_RELEASE,
     };
 
+    //! @brief What to do with joints that stalled during the end-stop search.
+    enum class EndstopStallAction
+    {
+        //! Keep pushing with the end-stop search torque.
+        PUSH,
+        //! Hold the joint at the position where it stalled.
+        HOLD,
+        //! Set the torque to zero.
+        ZERO_TORQUE,
+    };
+
+    //! @brief Order in which the joints move to the initial position.
+    enum class InitialMoveOrder
+    {
+        //! Move one joint after the other (in the order of the joint indices).
+        JOINT_BY_JOINT,
+
+        //! Move all joints at the same time.
+        SIMULTANEOUS,
+
+        /**
+         * @brief Move the joints in the groups given in @ref
+         * initial_move_groups.
+         *
+         * The groups are moved one after the other, all joints of a group at
+         * the same time.
+         */
+        GROUPS,
+    };
+
     // All parameters should have default values that should not result in
     // dangerous behaviour in case someone forgets to specify them.
 
@@ -374,6 +1166,32 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
     //! @brief Maximum current that can be sent to the motor [A].
     double max_current_A = 0.0;
 
+    /**
+     * @brief Duration of one cycle of the control loop [s].
+     *
+     * Note that all durations that are specified as number of steps (e.g.
+     * `move_steps`) are counted in control cycles, so their actual duration
+     * depends on this value.
+     */
+    double control_period_s = 0.001;
+
+    /**
+     * @brief Synchronise the control loop with the measurements of the boards.
+     *
+     * If enabled, each control cycle starts by waiting until new position and
+     * velocity measurements of all motor boards have arrived.  Torques are
+     * then computed and sent right away, instead of sleeping until the end of
+     * the period.  This reduces the latency between sensing and actuation to
+     * the processing time.  The rate of the control loop is then given by the
+     * rate at which the boards send measurements.  In the timing trace, the
+     * waiting time is part of the observation phase.
+     *
+     * If no new measurement arrives within one control period, the cycle
+     * continues with the last received values (see
+     * NJointBlmcRobotDriver::get_missed_measurement_count).
+     */
+    bool wait_for_new_measurement = false;
+
     /**
      * @brief Whether the joints have physical end stops or not.
      *
@@ -396,12 +1214,46 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
         Vector endstop_search_torques_Nm = Vector::Zero();
         //! @brief Number of time steps for reaching the initial position.
         uint32_t move_steps = 0;
+        //! @brief Maximum duration of the end-stop search [s].
+        double endstop_search_timeout_s = 10.0;
+        //! @brief What to do with joints that reached the end stop while
+        //!        others are still moving.
+        EndstopStallAction endstop_stall_action = EndstopStallAction::PUSH;
     } calibration;
 
     //! @brief Tolerance for reaching the target with
     //!        @ref NJointBlmcRobotDriver::move_to_position.
     double move_to_position_tolerance_rad = 0.0;
 
+    /**
+     * @brief Velocity limit for @ref NJointBlmcRobotDriver::move_to_position.
+     *
+     * If finite, the duration of a move is derived from the distance such
+     * that no joint exceeds this velocity.  The configured number of steps
+     * (e.g. `calibration.move_steps`) is then only used as upper bound.
+     */
+    double move_to_position_max_velocity_radps =
+        std::numeric_limits<double>::infinity();
+
+    /**
+     * @brief Acceleration limit for @ref
+     *        NJointBlmcRobotDriver::move_to_position.
+     *
+     * Same as @ref move_to_position_max_velocity_radps but for the
+     * acceleration.
+     */
+    double move_to_position_max_acceleration_radps2 =
+        std::numeric_limits<double>::infinity();
+
+    /**
+     * @brief Velocity below which a joint is considered to be at rest.
+     *
+     * @ref NJointBlmcRobotDriver::move_to_position ends as soon as all joints
+     * are within @ref move_to_position_tolerance_rad of the goal and slower
+     * than this.  Set to zero to always execute the full move.
+     */
+    double move_to_position_settled_velocity_radps = 0.0;
+
     //! @brief D-gain to dampen velocity.  Set to zero to disable damping.
     // set some rather high damping by default
     Vector safety_kd = Vector::Constant(0.1);
@@ -452,12 +1304,39 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
      */
     Vector initial_position_rad = Vector::Zero();
 
+    /**
+     * @brief Order in which the joints move to the initial position.
+     *
+     * Each move takes `calibration.move_steps` control cycles, so moving
+     * joints together shortens the initialisation accordingly.
+     */
+    InitialMoveOrder initial_move_order = InitialMoveOrder::JOINT_BY_JOINT;
+
+    /**
+     * @brief Groups of joints that move to the initial position together.
+     *
+     * Only used if @ref initial_move_order is `GROUPS`.  The groups are moved
+     * in the given order.  Each joint has to be contained in exactly one
+     * group.
+     *
+     * Example (TriFinger, moving the corresponding joints of all fingers
+     * together): `[[0, 3, 6], [1, 4, 7], [2, 5, 8]]`
+     */
+    std::vector<std::vector<size_t>> initial_move_groups;
+
     /**
      * @brief Trajectory which is executed in the shutdown method.
      *
      * Use this to move the robot to a "rest position" during shutdown of the
      * robot driver.  It can consist of arbitrarily many steps.  Leave it empty
      * to not move during shutdown.
+     *
+     * A step starts as soon as all previous steps that share a joint with it
+     * are finished (see get_trajectory_dependencies()).  This way steps that
+     * only move some of the joints (e.g. one finger) run concurrently with
+     * steps of other joints, while a step moving all joints waits for all
+     * previous steps.  Use the latter to enforce an order where concurrent
+     * moves could collide.
      */
     std::vector<TrajectoryStep> shutdown_trajectory;
 
@@ -472,6 +1351,85 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
      */
     std::vector<std::string> run_duration_logfiles;
 
+    /**
+     * @brief Maximum duration of the shutdown trajectory, in seconds.
+     *
+     * If the shutdown trajectory is not finished within this time, it is
+     * aborted and the motors are paused.  The step that was not reached is
+     * reported in the shutdown status (see
+     * NJointBlmcRobotDriver::get_shutdown_status).
+     */
+    double shutdown_timeout_s = std::numeric_limits<double>::infinity();
+
+    /**
+     * @brief Record the timing of each control cycle.
+     *
+     * If enabled, timestamps of the phases of each control cycle (acquiring the
+     * observation, processing the action, sending torques, sleeping) are
+     * recorded.  A summary of the phase durations is printed during shutdown.
+     * See @ref CycleTimingTrace.
+     */
+    bool enable_timing_trace = false;
+
+    /**
+     * @brief File to which the timestamps of all control cycles are written.
+     *
+     * Only used if @ref enable_timing_trace is set.  Leave empty to only print
+     * the summary.
+     */
+    std::string timing_trace_file;
+
+    /**
+     * @brief Send the torque commands to all motor boards in parallel.
+     *
+     * If enabled, one writer thread per motor board is started, so the CAN
+     * frames of all boards are sent at the same time instead of one after the
+     * other (see @ref ParallelBoardSender).
+     */
+    bool parallel_can_send = false;
+
+    /**
+     * @brief CPUs to which the CAN writer threads are pinned.
+     *
+     * Only used if @ref parallel_can_send is set.  Needs to contain one entry
+     * per motor board or be empty to not pin the threads.
+     */
+    std::vector<int> can_send_cpus;
+
+    /**
+     * @brief Time the motor boards have to get ready at startup, in seconds.
+     *
+     * All boards are brought up concurrently.  If any of them is not ready
+     * within this time, the driver fails with an error naming the CAN ports of
+     * the boards that are not ready.
+     */
+    double motor_board_ready_timeout_s = 30.0;
+
+    /**
+     * @brief File to which the initialisation report is written (as JSON).
+     *
+     * See NJointBlmcRobotDriver::get_initialization_report.  Leave empty to
+     * not write the report.
+     */
+    std::string initialization_report_file = "";
+
+    /**
+     * @brief File in which the result of the homing is cached.
+     *
+     * If set, the zero angles found by the homing are stored in this file and
+     * restored on the next start if the robot was not moved and the motor
+     * boards were not power-cycled in the meantime, in which case the homing is
+     * skipped.  Leave empty to always run the homing.
+     */
+    std::string homing_cache_file = "";
+
+    /**
+     * @brief Allowed deviation of the joint positions for the homing cache.
+     *
+     * See @ref homing_cache_file.
+     */
+    double homing_cache_tolerance_rad = 0.02;
+
     /**
      * @brief Check if the given position is within the hard limits.
      *
@@ -482,24 +1440,190 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
      */
     bool is_within_hard_position_limits(const Vector &position) const;
 
+    /**
+     * @brief Get the groups of joints in the order in which they move to the
+     *        initial position.
+     *
+     * Resolves @ref initial_move_order to an explicit list of groups.
+     */
+    std::vector<std::vector<size_t>> get_initial_move_plan() const;
+
+    /**
+     * @brief Check that the given joint groups are a valid move plan.
+     *
+     * @param groups  Groups of joint indices.
+     * @throws std::invalid_argument if a group is empty, contains an invalid
+     *     joint index or if not every joint is contained in exactly one
+     *     group.
+     */
+    static void validate_initial_move_groups(
+        const std::vector<std::vector<size_t>> &groups);
+
+    /**
+     * @brief Check that the given trajectory step can be executed.
+     *
+     * @param step  The step.
+     * @throws std::invalid_argument if @ref TrajectoryStep::joints contains
+     *     invalid or duplicate joint indices or if
+     *     @ref TrajectoryStep::move_steps is zero while no velocity or
+     *     acceleration limit is set (as the move would take forever).
+     */
+    void validate_trajectory_step(const TrajectoryStep &step) const;
+
+    /**
+     * @brief Check all steps of @ref shutdown_trajectory.
+     *
+     * See validate_trajectory_step().
+     *
+     * @throws std::invalid_argument if a step is invalid.
+     */
+    void validate_shutdown_trajectory() const;
+
+    /**
+     * @brief Get the steps each step of a trajectory has to wait for.
+     *
+     * A step depends on the last previous step of each of its joints, i.e.
+     * steps moving the same joint are executed in the given order while
+     * steps of disjoint sets of joints can be executed at the same time.
+     *
+     * @param trajectory  Steps of the trajectory.
+     * @return For each step, the indices of the steps that have to be
+     *     finished before it can start (sorted, without duplicates).
+     */
+    static std::vector<std::vector<size_t>> get_trajectory_dependencies(
+        const std::vector<TrajectoryStep> &trajectory);
+
     /**
      * @brief Print the given configuration in a human-readable way.
      */
     void print() const;
 
+    /**
+     * @brief Environment variable with the directory for config snapshots.
+     *
+     * See try_load_config().
+     */
+    static constexpr const char *CONFIG_CACHE_DIR_ENV =
+        "ROBOT_FINGERS_CONFIG_CACHE_DIR";
+
+    /**
+     * @brief Load driver configuration from file.
+     *
+     * Same as try_load_config() but if the configuration is invalid, the
+     * application exits with an error message listing all problems.
+     *
+     * @param config_file_name  Path/name of the configuration YAML file.
+     *
+     * @return Configuration
+     */
+    static Config load_config(const std::string &config_file_name);
+
     /**
      * @brief Load driver configuration from file.
      *
      * Load the configuration from the specified YAML file.  The file is
      * expected to have the same structure/key naming as the Config struct.
-     * If a value can not be read from the file, the application exists
-     * with an error message.
+     *
+     * If the environment variable @ref CONFIG_CACHE_DIR_ENV is set to a
+     * directory, a binary snapshot of the validated configuration is stored
+     * there, identified by a hash of the file content.  Later calls with an
+     * unchanged file memory-map this snapshot instead of parsing the YAML
+     * file.
      *
      * @param config_file_name  Path/name of the configuration YAML file.
      *
      * @return Configuration
+     * @throws std::invalid_argument if the file cannot be read or the
+     *     configuration is invalid.  The message lists all problems that
+     *     were found.
      */
-    static Config load_config(const std::string &config_file_name);
+    static Config try_load_config(const std::string &config_file_name);
+
+    /**
+     * @brief Get configuration from a parsed YAML file.
+     *
+     * Instead of stopping at the first invalid value, all problems are
+     * collected in errors.
+     *
+     * @param user_config  The YAML node.
+     * @param errors  Descriptions of all problems are appended to this list.
+     *
+     * @return Configuration.  Only valid if no errors were added.
+     */
+    static Config parse_config(const YAML::Node &user_config,
+                               std::vector<std::string> *errors);
+
+    /**
+     * @brief Write a binary snapshot of the configuration.
+     *
+     * @param filename  Path of the snapshot file.
+     * @param content_hash  Hash of the YAML file content (see fnv1a_hash()),
+     *     checked by load_snapshot().
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save_snapshot(const std::string &filename,
+                       uint64_t content_hash) const;
+
+    /**
+     * @brief Load a snapshot written by save_snapshot().
+     *
+     * @throws std::runtime_error if the file cannot be read or was written
+     *     by a different version, for a different robot type or for a
+     *     different content hash.
+     */
+    static Config load_snapshot(const std::string &filename,
+                                uint64_t content_hash);
+
+    //! @brief Path of the snapshot of the given file content.
+    static std::string get_snapshot_path(const std::string &cache_dir,
+                                         const std::string &content);
+
+    /**
+     * @brief Pass all members to the archive (see SnapshotWriter).
+     *
+     * @note When adding members to Config, add them here as well and
+     *     increment SNAPSHOT_VERSION.
+     */
+    template <typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(can_ports);
+        archive(max_current_A);
+        archive(control_period_s);
+        archive(wait_for_new_measurement);
+        archive(has_endstop);
+        archive(homing_method);
+        archive(calibration.endstop_search_torques_Nm);
+        archive(calibration.move_steps);
+        archive(calibration.endstop_search_timeout_s);
+        archive(calibration.endstop_stall_action);
+        archive(move_to_position_tolerance_rad);
+        archive(move_to_position_max_velocity_radps);
+        archive(move_to_position_max_acceleration_radps2);
+        archive(move_to_position_settled_velocity_radps);
+        archive(safety_kd);
+        archive(position_control_gains.kp);
+        archive(position_control_gains.kd);
+        archive(hard_position_limits_lower);
+        archive(hard_position_limits_upper);
+        archive(soft_position_limits_lower);
+        archive(soft_position_limits_upper);
+        archive(home_offset_rad);
+        archive(initial_position_rad);
+        archive(initial_move_order);
+        archive(initial_move_groups);
+        archive(shutdown_trajectory);
+        archive(run_duration_logfiles);
+        archive(shutdown_timeout_s);
+        archive(enable_timing_trace);
+        archive(timing_trace_file);
+        archive(parallel_can_send);
+        archive(can_send_cpus);
+        archive(motor_board_ready_timeout_s);
+        archive(initialization_report_file);
+        archive(homing_cache_file);
+        archive(homing_cache_tolerance_rad);
+    }
 
     /**
      * @brief Parse a homing method name.
@@ -542,6 +1666,104 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
         }
     }
 
+    /**
+     * @brief Parse an end-stop stall action name.
+     *
+     * @param action_name  Name of the action.
+     * @throws std::invalid_argument if the given string does not represent a
+     *     valid action.
+     *
+     * @return The corresponding action.
+     */
+    static EndstopStallAction parse_endstop_stall_action_name(
+        const std::string &action_name)
+    {
+        if (action_name == "push")
+        {
+            return EndstopStallAction::PUSH;
+        }
+        else if (action_name == "hold")
+        {
+            return EndstopStallAction::HOLD;
+        }
+        else if (action_name == "zero_torque")
+        {
+            return EndstopStallAction::ZERO_TORQUE;
+        }
+        else
+        {
+            throw std::invalid_argument("Invalid end-stop stall action " +
+                                        action_name);
+        }
+    }
+
+    //! @brief Get the name of the specified end-stop stall action.
+    static std::string get_endstop_stall_action_name(EndstopStallAction action)
+    {
+        switch (action)
+        {
+            case EndstopStallAction::PUSH:
+                return "push";
+            case EndstopStallAction::HOLD:
+                return "hold";
+            case EndstopStallAction::ZERO_TORQUE:
+                return "zero_torque";
+            default:
+                throw std::runtime_error(
+                    "No name for the given end-stop stall action.  This is a "
+                    "bug, please report to the maintainers of this package.");
+        }
+    }
+
+    /**
+     * @brief Parse an initial move order name.
+     *
+     * @param order_name  Name of the order.
+     * @throws std::invalid_argument if the given string does not represent a
+     *     valid order.
+     *
+     * @return The corresponding initial move order.
+     */
+    static InitialMoveOrder parse_initial_move_order_name(
+        const std::string &order_name)
+    {
+        if (order_name == "joint_by_joint")
+        {
+            return InitialMoveOrder::JOINT_BY_JOINT;
+        }
+        else if (order_name == "simultaneous")
+        {
+            return InitialMoveOrder::SIMULTANEOUS;
+        }
+        else if (order_name == "groups")
+        {
+            return InitialMoveOrder::GROUPS;
+        }
+        else
+        {
+            throw std::invalid_argument("Invalid initial move order " +
+                                        order_name);
+        }
+    }
+
+    //! @brief Get the name of the specified initial move order.
+    static std::string get_initial_move_order_name(InitialMoveOrder order)
+    {
+        switch (order)
+        {
+            case InitialMoveOrder::JOINT_BY_JOINT:
+                return "joint_by_joint";
+            case InitialMoveOrder::SIMULTANEOUS:
+                return "simultaneous";
+            case InitialMoveOrder::GROUPS:
+                return "groups";
+            default:
+                throw std::runtime_error(
+                    "No name for the given initial move order.  This is a "
+                    "bug, please report to the maintainers of this package.");
+        }
+    }
+
     //! @brief Get the name of the specified homing method.
     static std::string get_homing_method_name(HomingMethod method)
     {
@@ -567,6 +1789,11 @@ struct NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>::Config
     }
 
 private:
+    //! @brief Identifies config snapshot files ("RFCS").
+    static constexpr uint32_t SNAPSHOT_MAGIC = 0x53434652;
+    //! @brief Version of the snapshot layout (see serialize()).
+    static constexpr uint32_t SNAPSHOT_VERSION = 2;
+
     /**
      * \brief Set value from user configuration to var if specified.
      *
@@ -578,11 +1805,14 @@ private:
      * \param[out] var  Variable to which configuration is written.  Value
      * is unchanged if the specified field name does not exist in
      * user_config, i.e.  it can be initialized with a default value.
+     * \param[out] errors  An error message is appended if the value cannot
+     * be loaded.
      */
     template <typename T>
     static void set_config_value(const YAML::Node &user_config,
                                  const std::string &name,
-                                 T *var);
+                                 T *var,
+                                 std::vector<std::string> *errors);
 };
 
 /**
@@ -590,20 +1820,26 @@ private:
  *
  * @tparam N_JOINTS  Number of joints
  * @tparam N_MOTOR_BOARDS  Number of motor boards.
+ * @tparam MotorBoardType  Type of the motor boards (see
+ *     NJointBlmcRobotDriver).
  */
-template <size_t N_JOINTS, size_t N_MOTOR_BOARDS = (N_JOINTS + 1) / 2>
+template <size_t N_JOINTS,
+          size_t N_MOTOR_BOARDS = (N_JOINTS + 1) / 2,
+          typename MotorBoardType = blmc_drivers::CanBusMotorBoard>
 class SimpleNJointBlmcRobotDriver
     : public NJointBlmcRobotDriver<
           robot_interfaces::NJointObservation<N_JOINTS>,
           N_JOINTS,
-          N_MOTOR_BOARDS>
+          N_MOTOR_BOARDS,
+          MotorBoardType>
 {
 public:
     typedef robot_interfaces::NJointObservation<N_JOINTS> Observation;
 
     using NJointBlmcRobotDriver<robot_interfaces::NJointObservation<N_JOINTS>,
                                 N_JOINTS,
-                                N_MOTOR_BOARDS>::NJointBlmcRobotDriver;
+                                N_MOTOR_BOARDS,
+                                MotorBoardType>::NJointBlmcRobotDriver;
 
     Observation get_latest_observation() override;
 };
@@ -615,7 +1851,8 @@ public:
  *     NJointBlmcRobotDriver.
  *
  * @param robot_data  Instance of RobotData used for communication.
- * @param config  Driver configuration.
+ * @param driver  The driver.  Keep a reference to it to change parameters at
+ *     runtime (see NJointBlmcRobotDriver::set_runtime_parameters).
  * @param first_action_timeout  Duration for which the backend waits for the
  *     first action to arrive.  If exceeded, the backend shuts down.
  * @param max_number_of_actions  Number of actions after which the backend
@@ -626,21 +1863,22 @@ public:
 template <typename Driver>
 typename Driver::Types::BackendPtr create_backend(
     typename Driver::Types::BaseDataPtr robot_data,
-    const typename Driver::Config &config,
+    std::shared_ptr<Driver> driver,
     const double first_action_timeout = std::numeric_limits<double>::infinity(),
     const uint32_t max_number_of_actions = 0)
 {
-    constexpr double MAX_ACTION_DURATION_S = 0.003;
-    constexpr double MAX_INTER_ACTION_DURATION_S = 0.005;
+    // timeouts of the MonitoredRobotDriver in multiples of the control period
+    constexpr double MAX_ACTION_DURATION_PERIODS = 3.0;
+    constexpr double MAX_INTER_ACTION_DURATION_PERIODS = 5.0;
 
-    config.print();
+    const double control_period_s = driver->get_config().control_period_s;
 
     // wrap the actual robot driver directly in a MonitoredRobotDriver
     auto monitored_driver =
         std::make_shared<robot_interfaces::MonitoredRobotDriver<Driver>>(
-            std::make_shared<Driver>(config),
-            MAX_ACTION_DURATION_S,
-            MAX_INTER_ACTION_DURATION_S);
+            driver,
+            MAX_ACTION_DURATION_PERIODS * control_period_s,
+            MAX_INTER_ACTION_DURATION_PERIODS * control_period_s);
 
     constexpr bool real_time_mode = true;
     auto backend = std::make_shared<typename Driver::Types::Backend>(
@@ -654,6 +1892,26 @@ typename Driver::Types::BackendPtr create_backend(
     return backend;
 }
 
+/**
+ * @brief Create backend using the specified driver.
+ *
+ * Overloaded version that creates the driver from the given configuration.
+ */
+template <typename Driver>
+typename Driver::Types::BackendPtr create_backend(
+    typename Driver::Types::BaseDataPtr robot_data,
+    const typename Driver::Config &config,
+    const double first_action_timeout = std::numeric_limits<double>::infinity(),
+    const uint32_t max_number_of_actions = 0)
+{
+    config.print();
+
+    return create_backend<Driver>(robot_data,
+                                  std::make_shared<Driver>(config),
+                                  first_action_timeout,
+                                  max_number_of_actions);
+}
+
 /**
  * @brief Create backend using the specified driver.
  *
@@ -5,9 +5,13 @@
  *            Gesellschaft.
  */
 
-#define TPL_NJBRD \
-    template <typename Observation, size_t N_JOINTS, size_t N_MOTOR_BOARDS>
-#define NJBRD NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS>
+#define TPL_NJBRD                    \
+    template <typename Observation,  \
+              size_t N_JOINTS,       \
+              size_t N_MOTOR_BOARDS, \
+              typename MotorBoardType>
+#define NJBRD \
+    NJointBlmcRobotDriver<Observation, N_JOINTS, N_MOTOR_BOARDS, MotorBoardType>
 
 namespace robot_fingers
 {
@@ -18,6 +22,154 @@ bool NJBRD::Config::is_within_hard_position_limits(const Vector &position) const
            (position.array() <= hard_position_limits_upper.array()).all();
 }
 
+TPL_NJBRD
+auto NJBRD::Config::get_initial_move_plan() const
+    -> std::vector<std::vector<size_t>>
+{
+    std::vector<std::vector<size_t>> plan;
+
+    switch (initial_move_order)
+    {
+        case InitialMoveOrder::JOINT_BY_JOINT:
+            for (size_t i = 0; i < N_JOINTS; i++)
+            {
+                plan.push_back({i});
+            }
+            break;
+
+        case InitialMoveOrder::SIMULTANEOUS:
+            plan.emplace_back();
+            for (size_t i = 0; i < N_JOINTS; i++)
+            {
+                plan[0].push_back(i);
+            }
+            break;
+
+        case InitialMoveOrder::GROUPS:
+            plan = initial_move_groups;
+            break;
+    }
+
+    return plan;
+}
+
+TPL_NJBRD
+void NJBRD::Config::validate_initial_move_groups(
+    const std::vector<std::vector<size_t>> &groups)
+{
+    std::array<bool, N_JOINTS> is_in_group = {};
+
+    for (const std::vector<size_t> &group : groups)
+    {
+        if (group.empty())
+        {
+            throw std::invalid_argument(
+                "Initial move groups must not be empty.");
+        }
+
+        for (size_t joint : group)
+        {
+            if (joint >= N_JOINTS)
+            {
+                throw std::invalid_argument(
+                    "Invalid joint index " + std::to_string(joint) +
+                    " in initial move groups.");
+            }
+            if (is_in_group[joint])
+            {
+                throw std::invalid_argument(
+                    "Joint " + std::to_string(joint) +
+                    " is contained in multiple initial move groups.");
+            }
+            is_in_group[joint] = true;
+        }
+    }
+
+    for (size_t i = 0; i < N_JOINTS; i++)
+    {
+        if (!is_in_group[i])
+        {
+            throw std::invalid_argument("Joint " + std::to_string(i) +
+                                        " is not contained in any initial "
+                                        "move group.");
+        }
+    }
+}
+
+TPL_NJBRD
+void NJBRD::Config::validate_trajectory_step(const TrajectoryStep &step) const
+{
+    std::array<bool, N_JOINTS> is_used = {};
+    for (size_t joint : step.joints)
+    {
+        if (joint >= N_JOINTS || is_used[joint])
+        {
+            throw std::invalid_argument("Invalid or duplicate joint " +
+                                        std::to_string(joint) + ".");
+        }
+        is_used[joint] = true;
+    }
+
+    // without a limit, the duration of the move would be unbounded
+    if (step.move_steps == 0 &&
+        std::isinf(move_to_position_max_velocity_radps) &&
+        std::isinf(move_to_position_max_acceleration_radps2))
+    {
+        throw std::invalid_argument(
+            "'move_steps' is required if no velocity or acceleration limit is "
+            "set for move_to_position.");
+    }
+}
+
+TPL_NJBRD
+void NJBRD::Config::validate_shutdown_trajectory() const
+{
+    for (size_t i = 0; i < shutdown_trajectory.size(); i++)
+    {
+        try
+        {
+            validate_trajectory_step(shutdown_trajectory[i]);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            throw std::invalid_argument("shutdown_trajectory[" +
+                                        std::to_string(i) + "]: " + e.what());
+        }
+    }
+}
+
+TPL_NJBRD
+auto NJBRD::Config::get_trajectory_dependencies(
+    const std::vector<TrajectoryStep> &trajectory)
+    -> std::vector<std::vector<size_t>>
+{
+    std::vector<std::vector<size_t>> dependencies(trajectory.size());
+    // index + 1 of the last step moving each joint (0 if none)
+    std::array<size_t, N_JOINTS> last_step = {};
+
+    for (size_t i = 0; i < trajectory.size(); i++)
+    {
+        for (size_t joint = 0; joint < N_JOINTS; joint++)
+        {
+            if (trajectory[i].moves_joint(joint))
+            {
+                if (last_step[joint] > 0)
+                {
+                    dependencies[i].push_back(last_step[joint] - 1);
+                }
+                last_step[joint] = i + 1;
+            }
+        }
+
+        std::sort(dependencies[i].begin(), dependencies[i].end());
+        dependencies[i].erase(
+            std::unique(dependencies[i].begin(), dependencies[i].end()),
+            dependencies[i].end());
+    }
+
+    return dependencies;
+}
+
 TPL_NJBRD
 void NJBRD::Config::print() const
 {
@@ -29,15 +181,29 @@ void NJBRD::Config::print() const
     }
     std::cout << "\n"
               << "\t max_current_A: " << max_current_A << "\n"
+              << "\t control_period_s: " << control_period_s << "\n"
+              << "\t wait_for_new_measurement: " << wait_for_new_measurement
+              << "\n"
               << "\t has_endstop: " << has_endstop << "\n"
               << "\t move_to_position_tolerance_rad: "
               << move_to_position_tolerance_rad << "\n"
+              << "\t move_to_position_max_velocity_radps: "
+              << move_to_position_max_velocity_radps << "\n"
+              << "\t move_to_position_max_acceleration_radps2: "
+              << move_to_position_max_acceleration_radps2 << "\n"
+              << "\t move_to_position_settled_velocity_radps: "
+              << move_to_position_settled_velocity_radps << "\n"
               << "\t homing_method: " << get_homing_method_name(homing_method)
               << "\n"
               << "\t calibration:\n"
               << "\t\t endstop_search_torques_Nm: "
               << calibration.endstop_search_torques_Nm.transpose() << "\n"
               << "\t\t move_steps: " << calibration.move_steps << "\n"
+              << "\t\t endstop_search_timeout_s: "
+              << calibration.endstop_search_timeout_s << "\n"
+              << "\t\t endstop_stall_action: "
+              << get_endstop_stall_action_name(calibration.endstop_stall_action)
+              << "\n"
               << "\t safety_kd: " << safety_kd.transpose() << "\n"
               << "\t position_control_gains:\n"
               << "\t\t kp: " << position_control_gains.kp.transpose() << "\n"
@@ -55,6 +221,19 @@ void NJBRD::Config::print() const
               << "\t home_offset_rad: " << home_offset_rad.transpose() << "\n"
               << "\t initial_position_rad: " << initial_position_rad.transpose()
               << "\n"
+              << "\t initial_move_order: "
+              << get_initial_move_order_name(initial_move_order) << "\n"
+              << "\t initial_move_groups:";
+    for (const std::vector<size_t> &group : initial_move_groups)
+    {
+        std::cout << " [";
+        for (size_t j = 0; j < group.size(); j++)
+        {
+            std::cout << (j > 0 ? ", " : "") << group[j];
+        }
+        std::cout << "]";
+    }
+    std::cout << "\n"
               << "\t shutdown_trajectory:\n";
 
     if (shutdown_trajectory.empty())
@@ -68,6 +247,15 @@ void NJBRD::Config::print() const
             std::cout << "\t\t - target: "
                       << step.target_position_rad.transpose() << "\n"
                       << "\t\t   move_steps: " << step.move_steps << "\n";
+            if (!step.joints.empty())
+            {
+                std::cout << "\t\t   joints: [";
+                for (size_t i = 0; i < step.joints.size(); i++)
+                {
+                    std::cout << (i == 0 ? "" : ", ") << step.joints[i];
+                }
+                std::cout << "]\n";
+            }
         }
     }
 
@@ -83,26 +271,33 @@ void NJBRD::Config::print() const
             std::cout << "\t\t - " << filename << "\n";
         }
     }
+    std::cout << "\t shutdown_timeout_s: " << shutdown_timeout_s << "\n";
+
+    std::cout << "\t enable_timing_trace: " << enable_timing_trace << "\n"
+              << "\t timing_trace_file: " << timing_trace_file << "\n"
+              << "\t parallel_can_send: " << parallel_can_send << "\n"
+              << "\t can_send_cpus:";
+    for (int cpu : can_send_cpus)
+    {
+        std::cout << " " << cpu;
+    }
+    std::cout << "\n"
+              << "\t motor_board_ready_timeout_s: "
+              << motor_board_ready_timeout_s << "\n"
+              << "\t initialization_report_file: "
+              << initialization_report_file << "\n"
+              << "\t homing_cache_file: " << homing_cache_file << "\n"
+              << "\t homing_cache_tolerance_rad: "
+              << homing_cache_tolerance_rad << "\n";
 
     std::cout << std::endl;
 }
 
 TPL_NJBRD
-auto NJBRD::Config::load_config(const std::string &config_file_name) -> Config
+auto NJBRD::Config::parse_config(const YAML::Node &user_config,
+                                 std::vector<std::string> *errors) -> Config
 {
     NJBRD::Config config;
-    YAML::Node user_config;
-
-    try
-    {
-        user_config = YAML::LoadFile(config_file_name);
-    }
-    catch (...)
-    {
-        std::cout << "FATAL: Failed to load configuration from '"
-                  << config_file_name << "'." << std::endl;
-        std::exit(1);
-    }
 
     // replace values from the default config with the ones given in the
     // users config file
@@ -120,35 +315,52 @@ auto NJBRD::Config::load_config(const std::string &config_file_name) -> Config
     }
     catch (...)
     {
-        std::cerr << "FATAL: Failed to load parameter 'can_ports' from "
-                     "configuration file"
-                  << std::endl;
-        std::exit(1);
+        errors->push_back("Failed to load parameter 'can_ports'.");
+    }
+
+    set_config_value(
+        user_config, "max_current_A", &config.max_current_A, errors);
+    set_config_value(user_config, "has_endstop", &config.has_endstop, errors);
+
+    // control period is optional
+    if (user_config["control_period_s"])
+    {
+        set_config_value(
+            user_config, "control_period_s", &config.control_period_s, errors);
+
+        if (!(config.control_period_s > 0))
+        {
+            errors->push_back(
+                "Parameter 'control_period_s' must be greater than zero.");
+        }
     }
 
-    set_config_value(user_config, "max_current_A", &config.max_current_A);
-    set_config_value(user_config, "has_endstop", &config.has_endstop);
+    if (user_config["wait_for_new_measurement"])
+    {
+        set_config_value(user_config,
+                         "wait_for_new_measurement",
+                         &config.wait_for_new_measurement,
+                         errors);
+    }
 
     if (user_config["homing_with_index"])
     {
-        std::cout << "FATAL: The configuration option 'homing_with_index' is "
-                     "obsolete.  Use 'homing_method' instead."
-                  << std::endl;
-        std::exit(1);
+        errors->push_back(
+            "The configuration option 'homing_with_index' is obsolete.  Use "
+            "'homing_method' instead.");
     }
 
     if (user_config["homing_method"])
     {
         std::string method_name;
-        set_config_value(user_config, "homing_method", &method_name);
+        set_config_value(user_config, "homing_method", &method_name, errors);
         try
         {
             config.homing_method = parse_homing_method_name(method_name);
         }
         catch (const std::invalid_argument &e)
         {
-            std::cout << "FATAL: " << e.what() << std::endl;
-            std::exit(1);
+            errors->push_back(e.what());
         }
     }
     else
@@ -170,7 +382,35 @@ auto NJBRD::Config::load_config(const std::string &config_file_name) -> Config
 
     set_config_value(user_config,
                      "move_to_position_tolerance_rad",
-                     &config.move_to_position_tolerance_rad);
+                     &config.move_to_position_tolerance_rad,
+                     errors);
+    // limits for move_to_position are optional
+    if (user_config["move_to_position_max_velocity_radps"])
+    {
+        set_config_value(user_config,
+                         "move_to_position_max_velocity_radps",
+                         &config.move_to_position_max_velocity_radps,
+                         errors);
+    }
+    if (user_config["move_to_position_max_acceleration_radps2"])
+    {
+        set_config_value(user_config,
+                         "move_to_position_max_acceleration_radps2",
+                         &config.move_to_position_max_acceleration_radps2,
+                         errors);
+    }
+    if (user_config["move_to_position_settled_velocity_radps"])
+    {
+        set_config_value(user_config,
+                         "move_to_position_settled_velocity_radps",
+                         &config.move_to_position_settled_velocity_radps,
+                         errors);
+    }
+    if (!(config.move_to_position_max_velocity_radps > 0) ||
+        !(config.move_to_position_max_acceleration_radps2 > 0))
+    {
+        errors->push_back("Limits for move_to_position need to be positive.");
+    }
 
     if (user_config["calibration"])
     {
@@ -178,44 +418,115 @@ auto NJBRD::Config::load_config(const std::string &config_file_name) -> Config
 
         set_config_value(calib,
                          "endstop_search_torques_Nm",
-                         &config.calibration.endstop_search_torques_Nm);
-        set_config_value(calib, "move_steps", &config.calibration.move_steps);
+                         &config.calibration.endstop_search_torques_Nm,
+                         errors);
+        set_config_value(
+            calib, "move_steps", &config.calibration.move_steps, errors);
+
+        // end-stop search parameters are optional
+        if (calib["endstop_search_timeout_s"])
+        {
+            set_config_value(calib,
+                             "endstop_search_timeout_s",
+                             &config.calibration.endstop_search_timeout_s,
+                             errors);
+        }
+        if (calib["endstop_stall_action"])
+        {
+            std::string action_name;
+            set_config_value(
+                calib, "endstop_stall_action", &action_name, errors);
+            try
+            {
+                config.calibration.endstop_stall_action =
+                    parse_endstop_stall_action_name(action_name);
+            }
+            catch (const std::invalid_argument &e)
+            {
+                errors->push_back(e.what());
+            }
+        }
     }
 
-    set_config_value(user_config, "safety_kd", &config.safety_kd);
+    set_config_value(user_config, "safety_kd", &config.safety_kd, errors);
 
     if (user_config["position_control_gains"])
     {
         YAML::Node pos_ctrl = user_config["position_control_gains"];
 
-        set_config_value(pos_ctrl, "kp", &config.position_control_gains.kp);
-        set_config_value(pos_ctrl, "kd", &config.position_control_gains.kd);
+        set_config_value(
+            pos_ctrl, "kp", &config.position_control_gains.kp, errors);
+        set_config_value(
+            pos_ctrl, "kd", &config.position_control_gains.kd, errors);
     }
 
     set_config_value(user_config,
                      "hard_position_limits_lower",
-                     &config.hard_position_limits_lower);
+                     &config.hard_position_limits_lower,
+                     errors);
     set_config_value(user_config,
                      "hard_position_limits_upper",
-                     &config.hard_position_limits_upper);
+                     &config.hard_position_limits_upper,
+                     errors);
 
     // soft limits are optional
     if (user_config["soft_position_limits_lower"])
     {
         set_config_value(user_config,
                          "soft_position_limits_lower",
-                         &config.soft_position_limits_lower);
+                         &config.soft_position_limits_lower,
+                         errors);
     }
     if (user_config["soft_position_limits_upper"])
     {
         set_config_value(user_config,
                          "soft_position_limits_upper",
-                         &config.soft_position_limits_upper);
+                         &config.soft_position_limits_upper,
+                         errors);
     }
 
-    set_config_value(user_config, "home_offset_rad", &config.home_offset_rad);
     set_config_value(
-        user_config, "initial_position_rad", &config.initial_position_rad);
+        user_config, "home_offset_rad", &config.home_offset_rad, errors);
+    set_config_value(user_config,
+                     "initial_position_rad",
+                     &config.initial_position_rad,
+                     errors);
+
+    // move order is optional
+    if (user_config["initial_move_order"])
+    {
+        std::string order_name;
+        set_config_value(
+            user_config, "initial_move_order", &order_name, errors);
+        try
+        {
+            config.initial_move_order =
+                parse_initial_move_order_name(order_name);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            errors->push_back(e.what());
+        }
+    }
+    if (user_config["initial_move_groups"])
+    {
+        set_config_value(user_config,
+                         "initial_move_groups",
+                         &config.initial_move_groups,
+                         errors);
+    }
+    if (config.initial_move_order == InitialMoveOrder::GROUPS)
+    {
+        try
+        {
+            validate_initial_move_groups(config.initial_move_groups);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            errors->push_back(std::string("Invalid 'initial_move_groups': ") +
+                              e.what());
+        }
+    }
 
     if (user_config["shutdown_trajectory"])
     {
@@ -223,19 +534,72 @@ auto NJBRD::Config::load_config(const std::string &config_file_name) -> Config
 
         if (!trajectory.IsSequence())
         {
-            std::cerr << "FATAL: Parameter 'shutdown_trajectory' from "
-                         "configuration file is not a list."
-                      << std::endl;
-            std::exit(1);
+            errors->push_back("Parameter 'shutdown_trajectory' is not a list.");
         }
 
-        for (size_t i = 0; i < trajectory.size(); i++)
+        for (size_t i = 0; trajectory.IsSequence() && i < trajectory.size();
+             i++)
         {
             TrajectoryStep step;
-            set_config_value(trajectory[i],
-                             "target_position_rad",
-                             &step.target_position_rad);
-            set_config_value(trajectory[i], "move_steps", &step.move_steps);
+            const std::string prefix =
+                "shutdown_trajectory[" + std::to_string(i) + "]: ";
+
+            if (trajectory[i]["joints"])
+            {
+                set_config_value(
+                    trajectory[i], "joints", &step.joints, errors);
+
+                if (step.joints.empty())
+                {
+                    errors->push_back(prefix + "'joints' must not be empty.");
+                }
+            }
+
+            if (step.joints.empty())
+            {
+                set_config_value(trajectory[i],
+                                 "target_position_rad",
+                                 &step.target_position_rad,
+                                 errors);
+            }
+            else
+            {
+                // only the targets of the given joints are specified
+                std::vector<double> target;
+                set_config_value(
+                    trajectory[i], "target_position_rad", &target, errors);
+                if (target.size() != step.joints.size())
+                {
+                    errors->push_back(prefix +
+                                      "'target_position_rad' needs to have "
+                                      "one entry per joint in 'joints'.");
+                }
+                const size_t n = std::min(target.size(), step.joints.size());
+                for (size_t k = 0; k < n; k++)
+                {
+                    if (step.joints[k] < N_JOINTS)
+                    {
+                        step.target_position_rad[step.joints[k]] = target[k];
+                    }
+                }
+            }
+
+            // without move_steps, the duration is derived from the limits
+            if (trajectory[i]["move_steps"])
+            {
+                set_config_value(
+                    trajectory[i], "move_steps", &step.move_steps, errors);
+            }
+
+            try
+            {
+                config.validate_trajectory_step(step);
+            }
+            catch (const std::invalid_argument &e)
+            {
+                errors->push_back(prefix + e.what());
+            }
+
             config.shutdown_trajectory.push_back(step);
         }
     }
@@ -246,13 +610,11 @@ auto NJBRD::Config::load_config(const std::string &config_file_name) -> Config
 
         if (!logfiles.IsSequence())
         {
-            std::cerr << "FATAL: Parameter 'run_duration_logfiles' from "
-                         "configuration file is not a list."
-                      << std::endl;
-            std::exit(1);
+            errors->push_back(
+                "Parameter 'run_duration_logfiles' is not a list.");
         }
 
-        for (size_t i = 0; i < logfiles.size(); i++)
+        for (size_t i = 0; logfiles.IsSequence() && i < logfiles.size(); i++)
         {
             try
             {
@@ -261,71 +623,285 @@ auto NJBRD::Config::load_config(const std::string &config_file_name) -> Config
             }
             catch (const YAML::Exception &e)
             {
-                std::cerr
-                    << "FATAL: Failed to load run_duration_logfiles entry " << i
-                    << " from configuration file" << std::endl;
-                std::exit(1);
+                errors->push_back(
+                    "Failed to load run_duration_logfiles entry " +
+                    std::to_string(i) + ".");
             };
         }
     }
 
+    if (user_config["shutdown_timeout_s"])
+    {
+        set_config_value(user_config,
+                         "shutdown_timeout_s",
+                         &config.shutdown_timeout_s,
+                         errors);
+        if (!(config.shutdown_timeout_s > 0))
+        {
+            errors->push_back("shutdown_timeout_s needs to be positive.");
+        }
+    }
+
+    // timing trace is optional
+    if (user_config["enable_timing_trace"])
+    {
+        set_config_value(user_config,
+                         "enable_timing_trace",
+                         &config.enable_timing_trace,
+                         errors);
+    }
+    if (user_config["timing_trace_file"])
+    {
+        set_config_value(user_config,
+                         "timing_trace_file",
+                         &config.timing_trace_file,
+                         errors);
+    }
+
+    // parallel sending is optional
+    if (user_config["parallel_can_send"])
+    {
+        set_config_value(user_config,
+                         "parallel_can_send",
+                         &config.parallel_can_send,
+                         errors);
+    }
+    if (user_config["can_send_cpus"])
+    {
+        set_config_value(
+            user_config, "can_send_cpus", &config.can_send_cpus, errors);
+
+        if (!config.can_send_cpus.empty() &&
+            config.can_send_cpus.size() != N_MOTOR_BOARDS)
+        {
+            errors->push_back(
+                "Parameter 'can_send_cpus' needs to have one entry per motor "
+                "board.");
+        }
+    }
+
+    if (user_config["motor_board_ready_timeout_s"])
+    {
+        set_config_value(user_config,
+                         "motor_board_ready_timeout_s",
+                         &config.motor_board_ready_timeout_s,
+                         errors);
+    }
+    if (user_config["initialization_report_file"])
+    {
+        set_config_value(user_config,
+                         "initialization_report_file",
+                         &config.initialization_report_file,
+                         errors);
+    }
+
+    if (user_config["homing_cache_file"])
+    {
+        set_config_value(user_config,
+                         "homing_cache_file",
+                         &config.homing_cache_file,
+                         errors);
+    }
+    if (user_config["homing_cache_tolerance_rad"])
+    {
+        set_config_value(user_config,
+                         "homing_cache_tolerance_rad",
+                         &config.homing_cache_tolerance_rad,
+                         errors);
+    }
+
     return config;
 }
 
 TPL_NJBRD
-template <typename T>
-void NJBRD::Config::set_config_value(const YAML::Node &user_config,
-                                     const std::string &name,
-                                     T *var)
+auto NJBRD::Config::load_config(const std::string &config_file_name) -> Config
 {
     try
     {
-        *var = user_config[name].as<T>();
+        return try_load_config(config_file_name);
     }
-    catch (const YAML::Exception &e)
+    catch (const std::invalid_argument &e)
     {
-        std::cerr << "FATAL: Failed to load parameter '" << name
-                  << "' from configuration file" << std::endl;
+        std::cerr << "FATAL: " << e.what() << std::endl;
         std::exit(1);
-    };
+    }
 }
 
 TPL_NJBRD
-auto NJBRD::create_motor_boards(
-    const std::array<std::string, N_MOTOR_BOARDS> &can_ports) -> MotorBoards
+auto NJBRD::Config::try_load_config(const std::string &config_file_name)
+    -> Config
 {
-    // setup can buses -----------------------------------------------------
-    std::array<std::shared_ptr<blmc_drivers::CanBus>, N_MOTOR_BOARDS> can_buses;
-    for (size_t i = 0; i < can_buses.size(); i++)
+    std::string content;
     {
-        can_buses[i] = std::make_shared<blmc_drivers::CanBus>(can_ports[i]);
+        std::ifstream file(config_file_name);
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        if (!file)
+        {
+            throw std::invalid_argument("Failed to load configuration from '" +
+                                        config_file_name + "'.");
+        }
+        content = buffer.str();
     }
 
-    // set up motor boards -------------------------------------------------
-    MotorBoards motor_boards;
-    for (size_t i = 0; i < motor_boards.size(); i++)
+    // Snapshots are identified by the content of the file, so they are not
+    // used anymore as soon as the file is changed.
+    std::string snapshot_file;
+    const char *cache_dir = std::getenv(CONFIG_CACHE_DIR_ENV);
+    if (cache_dir && cache_dir[0] != '\0')
     {
-        motor_boards[i] = std::make_shared<blmc_drivers::CanBusMotorBoard>(
-            can_buses[i], 1000, 10);
-        /// \TODO: reduce the timeout further!!
+        snapshot_file = get_snapshot_path(cache_dir, content);
+        try
+        {
+            return load_snapshot(snapshot_file, fnv1a_hash(content));
+        }
+        catch (const std::exception &)
+        {
+            // no valid snapshot yet, fall back to parsing the file
+        }
     }
 
-    for (size_t i = 0; i < motor_boards.size(); i++)
+    std::vector<std::string> errors;
+    Config config;
+    try
+    {
+        config = parse_config(YAML::Load(content), &errors);
+    }
+    catch (const YAML::Exception &e)
     {
-        motor_boards[i]->wait_until_ready();
+        errors.push_back(e.what());
     }
 
-    return motor_boards;
-}
+    if (!errors.empty())
+    {
+        std::string msg = "Invalid configuration '" + config_file_name + "':";
+        for (const std::string &error : errors)
+        {
+            msg += "\n  - " + error;
+        }
+        throw std::invalid_argument(msg);
+    }
 
-TPL_NJBRD
-void NJBRD::pause_motors()
-{
-    for (size_t i = 0; i < motor_boards_.size(); i++)
+    if (!snapshot_file.empty())
     {
-        motor_boards_[i]->pause_motors();
+        try
+        {
+            config.save_snapshot(snapshot_file, fnv1a_hash(content));
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "WARNING: " << e.what() << std::endl;
+        }
     }
-}
+
+    return config;
+}
+
+TPL_NJBRD
+std::string NJBRD::Config::get_snapshot_path(const std::string &cache_dir,
+                                             const std::string &content)
+{
+    std::ostringstream path;
+    path << cache_dir << "/robot_fingers_config_" << N_JOINTS << "_"
+         << N_MOTOR_BOARDS << "_" << std::hex << fnv1a_hash(content)
+         << ".bin";
+    return path.str();
+}
+
+TPL_NJBRD
+void NJBRD::Config::save_snapshot(const std::string &filename,
+                                  uint64_t content_hash) const
+{
+    SnapshotWriter writer;
+    writer(SNAPSHOT_MAGIC);
+    writer(SNAPSHOT_VERSION);
+    writer(static_cast<uint32_t>(N_JOINTS));
+    writer(static_cast<uint32_t>(N_MOTOR_BOARDS));
+    writer(content_hash);
+    writer(*this);
+    writer.save(filename);
+}
+
+TPL_NJBRD
+auto NJBRD::Config::load_snapshot(const std::string &filename,
+                                  uint64_t content_hash) -> Config
+{
+    MappedFile file(filename);
+    SnapshotReader reader(file.data(), file.size());
+
+    uint32_t magic, version, n_joints, n_motor_boards;
+    uint64_t hash;
+    reader(magic);
+    reader(version);
+    reader(n_joints);
+    reader(n_motor_boards);
+    reader(hash);
+    if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION ||
+        n_joints != N_JOINTS || n_motor_boards != N_MOTOR_BOARDS ||
+        hash != content_hash)
+    {
+        throw std::runtime_error("Snapshot " + filename + " does not match.");
+    }
+
+    Config config;
+    reader(config);
+    if (!reader.at_end())
+    {
+        throw std::runtime_error("Snapshot " + filename + " is corrupted.");
+    }
+
+    return config;
+}
+
+TPL_NJBRD
+template <typename T>
+void NJBRD::Config::set_config_value(const YAML::Node &user_config,
+                                     const std::string &name,
+                                     T *var,
+                                     std::vector<std::string> *errors)
+{
+    try
+    {
+        *var = user_config[name].as<T>();
+    }
+    catch (const YAML::Exception &e)
+    {
+        errors->push_back("Failed to load parameter '" + name + "'.");
+    };
+}
+
+TPL_NJBRD
+auto NJBRD::create_motor_boards(
+    const std::array<std::string, N_MOTOR_BOARDS> &can_ports,
+    double ready_timeout_s) -> MotorBoardSetup
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    MotorBoardSetup setup;
+    setup.boards = bring_up_motor_boards<MotorBoard>(
+        can_ports,
+        [](const std::string &can_port) {
+            auto can_bus = std::make_shared<blmc_drivers::CanBus>(can_port);
+            /// \TODO: reduce the timeout further!!
+            return std::make_shared<MotorBoard>(can_bus, 1000, 10);
+        },
+        ready_timeout_s);
+
+    setup.bring_up_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+
+    return setup;
+}
+
+TPL_NJBRD
+void NJBRD::pause_motors()
+{
+    for (size_t i = 0; i < motor_boards_.size(); i++)
+    {
+        motor_boards_[i]->pause_motors();
+    }
+}
 
 TPL_NJBRD
 auto NJBRD::get_measured_index_angles() const -> Vector
@@ -351,6 +927,21 @@ void NJBRD::initialize()
         },
         this);
     realtime_thread.join();
+
+    // write the report here, so the file I/O is not done in the real-time
+    // thread
+    if (!config_.initialization_report_file.empty())
+    {
+        try
+        {
+            initialization_report_.write_json(
+                config_.initialization_report_file);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "WARNING: " << e.what() << std::endl;
+        }
+    }
 }
 
 TPL_NJBRD
@@ -373,68 +964,30 @@ auto NJBRD::apply_action(const NJBRD::Action &desired_action) -> Action
 }
 
 TPL_NJBRD
-std::string NJBRD::get_error()
+std::string NJBRD::ErrorState::to_string() const
 {
-    // Checks each board for errors and translates the error codes into
-    // human-readable strings.  If multiple boards have errors, the messages
-    // are concatenated.  Each message is prepended with the index of the
-    // corresponding board.
+    // If multiple boards have errors, the messages are concatenated.  Each
+    // message is prepended with the index of the corresponding board.
 
     std::string error_msg = "";
 
-    for (size_t i = 0; i < motor_boards_.size(); i++)
+    for (size_t i = 0; i < board_error_codes.size(); i++)
     {
-        auto status_timeseries = motor_boards_[i]->get_status();
-        if (status_timeseries->length() > 0)
+        if (board_error_codes[i] != 0)
         {
-            std::string board_error_msg = "";
-            using ErrorCodes = blmc_drivers::MotorBoardStatus::ErrorCodes;
-            switch (status_timeseries->newest_element().error_code)
+            if (!error_msg.empty())
             {
-                case ErrorCodes::NONE:
-                    break;
-                case ErrorCodes::ENCODER:
-                    board_error_msg = "Encoder Error";
-                    break;
-                case ErrorCodes::CAN_RECV_TIMEOUT:
-                    board_error_msg = "CAN Receive Timeout";
-                    break;
-                case ErrorCodes::CRIT_TEMP:
-                    board_error_msg = "Critical Temperature";
-                    break;
-                case ErrorCodes::POSCONV:
-                    board_error_msg =
-                        "Error in SpinTAC Position Convert module";
-                    break;
-                case ErrorCodes::POS_ROLLOVER:
-                    board_error_msg = "Position Rollover";
-                    break;
-                case ErrorCodes::OTHER:
-                    board_error_msg = "Other Error";
-                    break;
-                default:
-                    board_error_msg = "Unknown Error";
-                    break;
+                error_msg += "  ";
             }
 
-            if (!board_error_msg.empty())
-            {
-                if (!error_msg.empty())
-                {
-                    error_msg += "  ";
-                }
-
-                // error of the board with board index to the error message
-                // string
-                error_msg +=
-                    "[Board " + std::to_string(i) + "] " + board_error_msg;
-            }
+            // error of the board with board index to the error message
+            // string
+            error_msg += "[Board " + std::to_string(i) + "] " +
+                         get_board_error_message(board_error_codes[i]);
         }
     }
 
-    // check if position is within the limits
-    Vector position = this->joint_modules_.get_measured_angles();
-    if (!config_.is_within_hard_position_limits(position))
+    if (position_limits_exceeded)
     {
         if (!error_msg.empty())
         {
@@ -447,52 +1000,237 @@ std::string NJBRD::get_error()
     return error_msg;
 }
 
+
 TPL_NJBRD
-void NJBRD::shutdown()
+auto NJBRD::RuntimeParameters::from_config(const Config &config)
+    -> RuntimeParameters
+{
+    RuntimeParameters parameters;
+    parameters.position_control_kp = config.position_control_gains.kp;
+    parameters.position_control_kd = config.position_control_gains.kd;
+    parameters.safety_kd = config.safety_kd;
+    parameters.soft_position_limits_lower = config.soft_position_limits_lower;
+    parameters.soft_position_limits_upper = config.soft_position_limits_upper;
+
+    return parameters;
+}
+
+TPL_NJBRD
+void NJBRD::RuntimeParameters::validate() const
+{
+    // written such that NaN is rejected as well
+    auto is_non_negative = [](const Vector &v) {
+        return (v.array() >= 0).all();
+    };
+
+    if (!is_non_negative(position_control_kp) ||
+        !is_non_negative(position_control_kd))
+    {
+        throw std::invalid_argument(
+            "Position control gains must not be negative.");
+    }
+    if (!is_non_negative(safety_kd))
+    {
+        throw std::invalid_argument("safety_kd must not be negative.");
+    }
+    if (!(soft_position_limits_lower.array() <=
+          soft_position_limits_upper.array())
+             .all())
+    {
+        throw std::invalid_argument(
+            "Lower soft position limits must not be greater than the upper "
+            "ones.");
+    }
+}
+
+TPL_NJBRD
+void NJBRD::set_runtime_parameters(const RuntimeParameters &parameters)
+{
+    parameters.validate();
+
+    std::lock_guard<std::mutex> lock(runtime_parameters_mutex_);
+    latest_runtime_parameters_ = parameters;
+    runtime_parameters_.write(parameters);
+}
+
+TPL_NJBRD
+auto NJBRD::get_runtime_parameters() const -> RuntimeParameters
+{
+    std::lock_guard<std::mutex> lock(runtime_parameters_mutex_);
+    return latest_runtime_parameters_;
+}
+
+TPL_NJBRD
+std::string NJBRD::ShutdownStatus::to_string() const
+{
+    if (!is_shut_down)
+    {
+        return "Not shut down yet.";
+    }
+    if (reached_rest_position)
+    {
+        return "Reached rest position.";
+    }
+
+    std::ostringstream msg;
+    msg << "Failed to reach step " << failed_step
+        << " of the shutdown trajectory";
+    if (deadline_exceeded)
+    {
+        msg << " within the shutdown timeout";
+    }
+    msg << " (position error: " << position_error.transpose()
+        << ").  Robot may be blocked.";
+
+    return msg.str();
+}
+
+TPL_NJBRD
+const char *NJBRD::get_board_error_message(uint8_t error_code)
 {
-    // Move on the shutdown trajectory step by step.  If no shutdown trajectory
-    // is configured, the list of steps will be empty, so nothing will happen.
-    bool success = true;
-    for (const auto &step : config_.shutdown_trajectory)
+    using ErrorCodes = blmc_drivers::MotorBoardStatus::ErrorCodes;
+    switch (error_code)
     {
-        success &=
-            this->move_to_position(step.target_position_rad,
-                                   this->config_.move_to_position_tolerance_rad,
-                                   step.move_steps);
+        case ErrorCodes::NONE:
+            return "";
+        case ErrorCodes::ENCODER:
+            return "Encoder Error";
+        case ErrorCodes::CAN_RECV_TIMEOUT:
+            return "CAN Receive Timeout";
+        case ErrorCodes::CRIT_TEMP:
+            return "Critical Temperature";
+        case ErrorCodes::POSCONV:
+            return "Error in SpinTAC Position Convert module";
+        case ErrorCodes::POS_ROLLOVER:
+            return "Position Rollover";
+        case ErrorCodes::OTHER:
+            return "Other Error";
+        default:
+            return "Unknown Error";
+    }
+}
 
-        // do not continue if one step failed
-        if (!success)
+TPL_NJBRD
+auto NJBRD::get_error_state() const -> ErrorState
+{
+    ErrorState error_state;
+
+    for (size_t i = 0; i < motor_boards_.size(); i++)
+    {
+        auto status_timeseries = motor_boards_[i]->get_status();
+        if (status_timeseries->length() > 0)
         {
-            break;
+            error_state.board_error_codes[i] =
+                status_timeseries->newest_element().error_code;
         }
     }
 
+    // check if position is within the limits
+    error_state.position_limits_exceeded =
+        !config_.is_within_hard_position_limits(
+            joint_modules_.get_measured_angles());
+
+    return error_state;
+}
+
+TPL_NJBRD
+std::string NJBRD::get_error()
+{
+    const ErrorState error_state = get_error_state();
+
+    // only generate the message if there actually is an error (constructing an
+    // empty string does not allocate memory)
+    if (!error_state.has_error())
+    {
+        return std::string();
+    }
+
+    return error_state.to_string();
+}
+
+TPL_NJBRD
+void NJBRD::shutdown()
+{
+    const int64_t start_time_ns = get_monotonic_time_ns();
+    const int64_t deadline_ns =
+        std::isinf(config_.shutdown_timeout_s)
+            ? std::numeric_limits<int64_t>::max()
+            : start_time_ns +
+                  static_cast<int64_t>(config_.shutdown_timeout_s * 1e9);
+
+    // Move on the shutdown trajectory.  If no shutdown trajectory is
+    // configured, the list of steps will be empty, so nothing will happen.
+    const ExecuteTrajectoryResult result =
+        execute_trajectory(config_.shutdown_trajectory,
+                           config_.move_to_position_tolerance_rad,
+                           deadline_ns);
+
+    ShutdownStatus status;
+    status.reached_rest_position = result.reached_goal;
+    status.deadline_exceeded = result.deadline_exceeded;
+    status.failed_step = result.failed_step;
+    status.position_error = result.position_error;
+
     pause_motors();
 
-    if (!success)
+    status.is_shut_down = true;
+    status.duration_s = (get_monotonic_time_ns() - start_time_ns) * 1e-9;
+    shutdown_status_ = status;
+
+    // store the final position, so the cache is valid on the next start
+    if (is_initialized_)
     {
-        // TODO: report this somehow as this probably means that someone
-        // needs to disentangle the robot manually.
-        std::cerr << "Failed to reach rest position.  Robot may be blocked."
-                  << std::endl;
+        save_homing_cache();
     }
 
-    // write number of actions to the run duration logs
-    int timestamp =
-        static_cast<int>(real_time_tools::Timer::get_current_time_sec());
-    for (const std::string &logfile_name : config_.run_duration_logfiles)
+    // the scheduler is only used if the loop is not synchronised with the
+    // measurements
+    if (config_.wait_for_new_measurement)
     {
-        std::cout << "Write run duration log " << logfile_name << std::endl;
-        std::ofstream file(logfile_name, std::ios_base::app);
-        if (!file)
-        {
-            std::cerr << "Failed to open file " << logfile_name
-                      << " for writing." << std::endl;
-        }
-        else
+        rt_printf("Control loop: No new measurement in %lu cycles.\n",
+                  static_cast<unsigned long>(missed_measurement_count_));
+    }
+    else
+    {
+        rt_printf(
+            "Control loop: %lu of %lu cycles exceeded the period (%lu periods "
+            "skipped).\n",
+            static_cast<unsigned long>(
+                control_loop_scheduler_.get_overrun_count()),
+            static_cast<unsigned long>(
+                control_loop_scheduler_.get_cycle_count()),
+            static_cast<unsigned long>(
+                control_loop_scheduler_.get_skipped_slot_count()));
+    }
+
+    if (timing_trace_)
+    {
+        timing_trace_->stop();
+        timing_trace_->print_summary(std::cout);
+    }
+
+    if (!status.reached_rest_position)
+    {
+        rt_printf("%s\n", status.to_string().c_str());
+    }
+
+    // Write number of actions to the run duration logs.  This is done by a
+    // background thread, so slow file systems do not delay the motors being
+    // paused and the status being set above.
+    if (run_duration_log_writer_)
+    {
+        const std::string line =
+            std::to_string(static_cast<int>(
+                real_time_tools::Timer::get_current_time_sec())) +
+            "\t" + std::to_string(action_counter_);
+        for (const std::string &logfile_name : config_.run_duration_logfiles)
         {
-            file << timestamp << "\t" << action_counter_ << std::endl;
+            rt_printf("Write run duration log %s\n", logfile_name.c_str());
+            run_duration_log_writer_->append(logfile_name, line);
         }
+        // make sure the logs are written when shutdown() returns, as the
+        // process may be terminated right afterwards
+        run_duration_log_writer_->flush();
     }
 }
 
@@ -507,103 +1245,233 @@ auto NJBRD::process_desired_action(const Action &desired_action,
                                    const Vector &upper_position_limits)
     -> Action
 {
-    Action processed_action = desired_action;
+    // All steps are computed joint-wise in a single fused pass over the
+    // fixed-size vectors.  Instead of data-dependent branches, only
+    // conditional selects and non-short-circuit boolean operators are used, so
+    // the compiler can vectorise the loop or at least emit mostly branch-free
+    // code.  Note that the results need to be bit-identical to a
+    // straightforward implementation of the steps described in the
+    // documentation (see the reference implementation in
+    // test/test_process_action.cpp), so take care when changing the order of
+    // operations (e.g. the comparisons in the clamping match the semantics of
+    // Eigen's cwiseMin/cwiseMax).
+
+    const double *desired_torque = desired_action.torque.data();
+    const double *desired_position = desired_action.position.data();
+    const double *desired_kp = desired_action.position_kp.data();
+    const double *desired_kd = desired_action.position_kd.data();
+    const double *observed_position = latest_observation.position.data();
+    const double *velocity = latest_observation.velocity.data();
+    const double *lower = lower_position_limits.data();
+    const double *upper = upper_position_limits.data();
+    const double *default_kp = default_position_control_kp.data();
+    const double *default_kd = default_position_control_kd.data();
 
-    // Position Limits
-    // ---------------
-    // If a joint exceeds the soft position limit, replace the command for that
-    // joint with a position command to the limit
+    // Run the position controller only if a target position is set for at
+    // least one joint.  This is the case if a position is given in the
+    // desired action or if a joint exceeds the position limits (see below).
+    bool has_target_position = false;
     for (std::size_t i = 0; i < N_JOINTS; i++)
     {
-        // Clamp position commands to the allowed range (note that if position
-        // is NaN both conditions are false, so the NaN is preserved).
-        if (processed_action.position[i] < lower_position_limits[i])
-        {
-            processed_action.position[i] = lower_position_limits[i];
-        }
-        else if (processed_action.position[i] > upper_position_limits[i])
-        {
-            processed_action.position[i] = upper_position_limits[i];
-        }
+        has_target_position |= !std::isnan(desired_position[i]) |
+                               (observed_position[i] < lower[i]) |
+                               (observed_position[i] > upper[i]);
+    }
 
-        auto set_limit_action = [&](double sign, double limit) {
-            // Discard torque command if it pushes further out of the valid
-            // range.
-            if (processed_action.torque[i] * sign > 0)
-            {
-                processed_action.torque[i] = 0;
-            }
+    Action processed_action = desired_action;
+    double *torque = processed_action.torque.data();
+    double *position = processed_action.position.data();
+    double *kp = processed_action.position_kp.data();
+    double *kd = processed_action.position_kd.data();
+    for (std::size_t i = 0; i < N_JOINTS; i++)
+    {
+        // Load all values up front, so the selects below operate on registers
+        // and can be compiled without branches.
+        const double lower_i = lower[i];
+        const double upper_i = upper[i];
+        const double observed_position_i = observed_position[i];
+        const double velocity_i = velocity[i];
+        const double default_kp_i = default_kp[i];
+        const double default_kd_i = default_kd[i];
+        const double safety_kd_i = safety_kd[i];
+
+        // Position Limits
+        // ---------------
+        // If a joint exceeds the soft position limit, replace the command for
+        // that joint with a position command to the limit.
+        const bool below_limit = observed_position_i < lower_i;
+        const bool above_limit =
+            !below_limit & (observed_position_i > upper_i);
+        const bool exceeds_limit = below_limit | above_limit;
 
-            // If no position is set, set it to the limit value (otherwise it
-            // will already be clamped to the limit range, so it will be fine).
-            if (std::isnan(processed_action.position[i]))
-            {
-                processed_action.position[i] = limit;
-            }
+        // Clamp position commands to the allowed range (note that if position
+        // is NaN both conditions are false, so the NaN is preserved).  The
+        // upper limit is only checked if the lower one is not exceeded (this
+        // makes a difference if the lower limit is above the upper one).
+        double target = desired_position[i];
+        const bool target_below_limit = target < lower_i;
+        const bool target_above_limit =
+            !target_below_limit & (target > upper_i);
+        target = target_below_limit ? lower_i : target;
+        target = target_above_limit ? upper_i : target;
+
+        // If no position is set, set it to the limit value (otherwise it will
+        // already be clamped to the limit range, so it will be fine).
+        const double limit = below_limit ? lower_i : upper_i;
+        target = exceeds_limit & std::isnan(target) ? limit : target;
+
+        // Discard torque command if it pushes further out of the valid range.
+        double joint_torque = desired_torque[i];
+        const bool discard_torque = (below_limit & (joint_torque < 0)) |
+                                    (above_limit & (joint_torque > 0));
+        joint_torque = discard_torque ? 0.0 : joint_torque;
+
+        // do not allow custom gains
+        double joint_kp = exceeds_limit ? default_kp_i : desired_kp[i];
+        double joint_kd = exceeds_limit ? default_kd_i : desired_kd[i];
+
+        // Position Controller
+        // -------------------
+        // Replace NaN-values with default gains
+        const double control_kp =
+            std::isnan(joint_kp) ? default_kp_i : joint_kp;
+        const double control_kd =
+            std::isnan(joint_kd) ? default_kd_i : joint_kd;
 
-            // do not allow custom gains
-            processed_action.position_kp[i] = default_position_control_kp[i];
-            processed_action.position_kd[i] = default_position_control_kd[i];
-        };
+        // simple PD controller
+        const double position_error = target - observed_position_i;
+        double position_control_torque =
+            control_kp * position_error - control_kd * velocity_i;
 
-        if (latest_observation.position[i] < lower_position_limits[i])
-        {
-            set_limit_action(-1, lower_position_limits[i]);
-        }
-        else if (latest_observation.position[i] > upper_position_limits[i])
-        {
-            set_limit_action(+1, upper_position_limits[i]);
-        }
+        // position_control_torque is NaN for joints where target position is
+        // set to NaN!  Set the torque to zero instead.
+        position_control_torque = std::isnan(position_control_torque)
+                                      ? 0.0
+                                      : position_control_torque;
+
+        // Add result of position controller to the torque command
+        joint_torque = has_target_position
+                           ? joint_torque + position_control_torque
+                           : joint_torque;
+        joint_kp = has_target_position ? control_kp : joint_kp;
+        joint_kd = has_target_position ? control_kd : joint_kd;
+
+        // Safety Checks
+        // -------------
+        // limit to configured maximum torque
+        joint_torque =
+            max_torque_Nm < joint_torque ? max_torque_Nm : joint_torque;
+        joint_torque =
+            joint_torque < -max_torque_Nm ? -max_torque_Nm : joint_torque;
+        // velocity damping to prevent too fast movements
+        joint_torque -= safety_kd_i * velocity_i;
+        // after applying checks, make sure we are still below the max. torque
+        joint_torque =
+            max_torque_Nm < joint_torque ? max_torque_Nm : joint_torque;
+        joint_torque =
+            joint_torque < -max_torque_Nm ? -max_torque_Nm : joint_torque;
+
+        torque[i] = joint_torque;
+        position[i] = target;
+        kp[i] = joint_kp;
+        kd[i] = joint_kd;
     }
 
-    // Position Controller
-    // -------------------
+    return processed_action;
+}
 
-    // Run the position controller only if a target position is set for at
-    // least one joint.
-    if (!processed_action.position.array().isNaN().all())
+TPL_NJBRD
+auto NJBRD::process_desired_action_batch(
+    const ActionBatch &desired_actions,
+    const JointTrajectory &observed_positions,
+    const JointTrajectory &observed_velocities,
+    const double max_torque_Nm,
+    const Vector &safety_kd,
+    const Vector &default_position_control_kp,
+    const Vector &default_position_control_kd,
+    const Vector &lower_position_limits,
+    const Vector &upper_position_limits,
+    unsigned int num_threads) -> ActionBatch
+{
+    const Eigen::Index num_steps = desired_actions.size();
+    if (desired_actions.position.rows() != num_steps ||
+        desired_actions.position_kp.rows() != num_steps ||
+        desired_actions.position_kd.rows() != num_steps ||
+        observed_positions.rows() != num_steps ||
+        observed_velocities.rows() != num_steps)
     {
-        // Replace NaN-values with default gains
-        processed_action.position_kp =
-            processed_action.position_kp.array().isNaN().select(
-                default_position_control_kp, processed_action.position_kp);
-        processed_action.position_kd =
-            processed_action.position_kd.array().isNaN().select(
-                default_position_control_kd, processed_action.position_kd);
+        throw std::invalid_argument(
+            "Number of time steps of actions and observations does not "
+            "match.");
+    }
 
-        Vector position_error =
-            processed_action.position - latest_observation.position;
+    ActionBatch processed_actions;
+    processed_actions.torque.resize(num_steps, N_JOINTS);
+    processed_actions.position.resize(num_steps, N_JOINTS);
+    processed_actions.position_kp.resize(num_steps, N_JOINTS);
+    processed_actions.position_kd.resize(num_steps, N_JOINTS);
 
-        // simple PD controller
-        Vector position_control_torque =
-            processed_action.position_kp.cwiseProduct(position_error) -
-            processed_action.position_kd.cwiseProduct(
-                latest_observation.velocity);
-
-        // position_control_torque contains NaN for joints where target
-        // position is set to NaN!  Filter those out and set the torque to
-        // zero instead.
-        position_control_torque =
-            position_control_torque.array().isNaN().select(
-                0, position_control_torque);
+    auto process_range = [&](Eigen::Index begin, Eigen::Index end) {
+        Observation observation;
+        for (Eigen::Index t = begin; t < end; t++)
+        {
+            const Action desired_action(
+                desired_actions.torque.row(t).transpose(),
+                desired_actions.position.row(t).transpose(),
+                desired_actions.position_kp.row(t).transpose(),
+                desired_actions.position_kd.row(t).transpose());
+            observation.position = observed_positions.row(t).transpose();
+            observation.velocity = observed_velocities.row(t).transpose();
+
+            const Action action =
+                process_desired_action(desired_action,
+                                       observation,
+                                       max_torque_Nm,
+                                       safety_kd,
+                                       default_position_control_kp,
+                                       default_position_control_kd,
+                                       lower_position_limits,
+                                       upper_position_limits);
+
+            processed_actions.torque.row(t) = action.torque.transpose();
+            processed_actions.position.row(t) = action.position.transpose();
+            processed_actions.position_kp.row(t) =
+                action.position_kp.transpose();
+            processed_actions.position_kd.row(t) =
+                action.position_kd.transpose();
+        }
+    };
 
-        // Add result of position controller to the torque command
-        processed_action.torque += position_control_torque;
+    if (num_threads == 0)
+    {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    // not worth starting threads for only a few steps each
+    constexpr Eigen::Index MIN_STEPS_PER_THREAD = 1024;
+    num_threads = static_cast<unsigned int>(
+        std::min<Eigen::Index>(num_threads,
+                               std::max<Eigen::Index>(
+                                   num_steps / MIN_STEPS_PER_THREAD, 1)));
+
+    const Eigen::Index chunk_size =
+        (num_steps + num_threads - 1) / num_threads;
+
+    // process the first chunk in the calling thread
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < num_threads; i++)
+    {
+        const Eigen::Index begin = std::min(i * chunk_size, num_steps);
+        const Eigen::Index end = std::min(begin + chunk_size, num_steps);
+        threads.emplace_back(process_range, begin, end);
     }
+    process_range(0, std::min(chunk_size, num_steps));
 
-    // Safety Checks
-    // -------------
-    // limit to configured maximum torque
-    processed_action.torque =
-        clamp(processed_action.torque, -max_torque_Nm, max_torque_Nm);
-    // velocity damping to prevent too fast movements
-    processed_action.torque -=
-        safety_kd.cwiseProduct(latest_observation.velocity);
-    // after applying checks, make sure we are still below the max. torque
-    processed_action.torque =
-        clamp(processed_action.torque, -max_torque_Nm, max_torque_Nm);
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
 
-    return processed_action;
+    return processed_actions;
 }
 
 TPL_NJBRD
@@ -616,48 +1484,152 @@ TPL_NJBRD
 auto NJBRD::apply_action_uninitialized(const NJBRD::Action &desired_action)
     -> Action
 {
-    double start_time_sec = real_time_tools::Timer::get_current_time_sec();
+    CycleTimingTrace::CycleTimestamps timestamps;
+    const bool trace_timing = static_cast<bool>(timing_trace_);
+    if (trace_timing)
+    {
+        timestamps.cycle = action_counter_;
+        timestamps.start_ns = get_monotonic_time_ns();
+    }
+
+    if (config_.wait_for_new_measurement)
+    {
+        if (!wait_for_new_measurements())
+        {
+            missed_measurement_count_++;
+        }
+    }
+    else if (!control_loop_scheduler_.is_running())
+    {
+        control_loop_scheduler_.start();
+    }
 
     Observation observation = get_latest_observation();
 
+    if (trace_timing)
+    {
+        timestamps.observation_ns = get_monotonic_time_ns();
+    }
+
+    // take over parameters changed via set_runtime_parameters()
+    runtime_parameters_.update();
+    const RuntimeParameters &parameters = runtime_parameters_.read();
+
     // Only enable soft position limits once initialization is done (i.e. no
     // limits during homing).
     Vector lower_limits =
         is_initialized_
-            ? config_.soft_position_limits_lower
+            ? parameters.soft_position_limits_lower
             : Vector::Constant(-std::numeric_limits<double>::infinity());
     Vector upper_limits =
         is_initialized_
-            ? config_.soft_position_limits_upper
+            ? parameters.soft_position_limits_upper
             : Vector::Constant(std::numeric_limits<double>::infinity());
 
     Action applied_action =
         process_desired_action(desired_action,
                                observation,
                                max_torque_Nm_,
-                               config_.safety_kd,
-                               config_.position_control_gains.kp,
-                               config_.position_control_gains.kd,
+                               parameters.safety_kd,
+                               parameters.position_control_kp,
+                               parameters.position_control_kd,
                                lower_limits,
                                upper_limits);
 
+    if (trace_timing)
+    {
+        timestamps.processing_ns = get_monotonic_time_ns();
+    }
+
     joint_modules_.set_torques(applied_action.torque);
-    joint_modules_.send_torques();
+    if (parallel_board_sender_)
+    {
+        parallel_board_sender_->send();
+    }
+    else
+    {
+        joint_modules_.send_torques();
+    }
+
+    if (trace_timing)
+    {
+        timestamps.send_ns = get_monotonic_time_ns();
+    }
 
     action_counter_++;
 
-    real_time_tools::Timer::sleep_until_sec(start_time_sec + 0.001);
+    // in event-driven mode, the next cycle is triggered by the measurements
+    if (!config_.wait_for_new_measurement)
+    {
+        control_loop_scheduler_.wait_for_next_period();
+    }
+
+    if (trace_timing)
+    {
+        timestamps.end_ns = get_monotonic_time_ns();
+        timing_trace_->record(timestamps);
+    }
 
     return applied_action;
 }
 
+TPL_NJBRD
+bool NJBRD::wait_for_new_measurements()
+{
+    const int64_t deadline_ns =
+        get_monotonic_time_ns() +
+        static_cast<int64_t>(config_.control_period_s * 1e9);
+
+    bool all_arrived = true;
+    for (size_t i = 0; i < motor_boards_.size(); i++)
+    {
+        for (size_t j = 0; j < AWAITED_MEASUREMENTS.size(); j++)
+        {
+            auto measurement =
+                motor_boards_[i]->get_measurement(AWAITED_MEASUREMENTS[j]);
+
+            const double remaining_s =
+                std::max(deadline_ns - get_monotonic_time_ns(), int64_t(0)) /
+                1e9;
+            all_arrived &= measurement->wait_for_timeindex(
+                last_measurement_index_[i][j] + 1, remaining_s);
+
+            if (measurement->length() > 0)
+            {
+                last_measurement_index_[i][j] =
+                    measurement->newest_timeindex(false);
+            }
+        }
+    }
+
+    return all_arrived;
+}
+
 TPL_NJBRD
 void NJBRD::_initialize()
 {
+    const int64_t start_time_ns = get_monotonic_time_ns();
+
+    // start with a fresh report but keep the board bring-up, which happens
+    // before
+    const double board_bring_up_s = initialization_report_.board_bring_up_s;
+    InitializationReport &report = initialization_report_;
+    report = InitializationReport();
+    report.board_bring_up_s = board_bring_up_s;
+
     joint_modules_.set_position_control_gains(
         config_.position_control_gains.kp, config_.position_control_gains.kd);
 
-    bool homing_succeeded = homing();
+    bool homing_succeeded = restore_homing_cache();
+    report.homing_restored_from_cache = homing_succeeded;
+    if (!homing_succeeded)
+    {
+        homing_succeeded = homing();
+        if (homing_succeeded)
+        {
+            save_homing_cache();
+        }
+    }
     pause_motors();
 
     // NOTE: do not set is_initialized_ yet as we want to allow move_to_position
@@ -667,17 +1639,34 @@ void NJBRD::_initialize()
     {
         Vector waypoint = get_latest_observation().position;
 
-        bool reached_goal = false;
-        for (size_t i = 0; i < N_JOINTS; i++)
+        MoveToPositionResult move_result;
+        double move_duration_s = 0.0;
+        for (const std::vector<size_t> &group :
+             config_.get_initial_move_plan())
         {
-            waypoint[i] = config_.initial_position_rad[i];
+            for (size_t joint : group)
+            {
+                waypoint[joint] = config_.initial_position_rad[joint];
+            }
 
-            reached_goal =
+            move_result =
                 move_to_position(waypoint,
                                  config_.move_to_position_tolerance_rad,
                                  config_.calibration.move_steps);
+            move_duration_s += move_result.duration_s;
+
+            InitializationReport::Move move;
+            move.joints = group;
+            move.duration_s = move_result.duration_s;
+            report.initial_moves.push_back(move);
         }
-        if (!reached_goal)
+        report.reached_initial_position = move_result.reached_goal;
+        if (move_result.reached_goal)
+        {
+            rt_printf("Reached initial position after %.3f s.\n",
+                      move_duration_s);
+        }
+        else
         {
             rt_printf("Failed to reach initial position, timeout exceeded.\n");
         }
@@ -685,45 +1674,223 @@ void NJBRD::_initialize()
 
     pause_motors();
 
+    // there is a pause of unknown duration between initialisation and the
+    // first action of the backend, so restart the timing with the next action
+    control_loop_scheduler_.stop();
+
+    report.homing_succeeded = homing_succeeded;
+    report.total_s = (get_monotonic_time_ns() - start_time_ns) * 1e-9;
+    rt_printf("Initialisation finished after %.3f s.\n", report.total_s);
+
     is_initialized_ = homing_succeeded;
 }
 
 TPL_NJBRD
-void NJBRD::move_until_blocking(NJBRD::Vector torques_Nm)
+auto NJBRD::move_until_blocking(const NJBRD::Vector &torques_Nm)
+    -> MoveUntilBlockingResult
 {
-    //! Min. number of steps when moving to the end stop.
-    constexpr uint32_t MIN_STEPS_MOVE_TO_END_STOP = 1000;
-    //! Size of the window when computing average velocity.
-    constexpr uint32_t SIZE_VELOCITY_WINDOW = 100;
-    //! Velocity limit at which the joints are considered to be stopped.
-    constexpr double STOP_VELOCITY = 0.01;
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
 
-    static_assert(MIN_STEPS_MOVE_TO_END_STOP > SIZE_VELOCITY_WINDOW,
-                  "MIN_STEPS_MOVE_TO_END_STOP has to be bigger than"
-                  " SIZE_VELOCITY_WINDOW to ensure correct computation"
-                  " of average velocity.");
+    const uint32_t max_steps =
+        std::isinf(config_.calibration.endstop_search_timeout_s)
+            ? std::numeric_limits<uint32_t>::max()
+            : duration_to_steps(config_.calibration.endstop_search_timeout_s);
 
-    // Move until velocity drops to almost zero (= joints hit the end
-    // stops) but at least for MIN_STEPS_MOVE_TO_END_STOP time steps.
-    // TODO: add timeout to this loop?
-    std::vector<Vector> running_velocities(SIZE_VELOCITY_WINDOW);
-    Vector summed_velocities = Vector::Zero();
+    MoveUntilBlockingResult result;
+    Vector hold_position = Vector::Constant(NaN);
+    Vector torque = torques_Nm;
     uint32_t step_count = 0;
-    while (
-        step_count < MIN_STEPS_MOVE_TO_END_STOP ||
-        (summed_velocities.maxCoeff() / SIZE_VELOCITY_WINDOW > STOP_VELOCITY))
+    size_t num_stalled = 0;
+
+    // Move until all joints stopped (= hit the end stops).  See StallDetector
+    // for when a joint is considered as stalled.
+    stall_detector_.reset();
+    while (num_stalled < N_JOINTS && step_count < max_steps)
     {
-        apply_action_uninitialized(torques_Nm);
-        Vector abs_velocities = get_latest_observation().velocity.cwiseAbs();
+        // NaN for position, kp and kd means pure torque control for joints that
+        // are not held
+        apply_action_uninitialized(Action(torque,
+                                          hold_position,
+                                          Vector::Constant(NaN),
+                                          Vector::Constant(NaN)));
+        step_count++;
+
+        const Observation observation = get_latest_observation();
+        stall_detector_.update(observation.velocity);
 
-        uint32_t running_index = step_count % SIZE_VELOCITY_WINDOW;
-        if (step_count >= SIZE_VELOCITY_WINDOW)
+        for (size_t i = 0; i < N_JOINTS; i++)
         {
-            summed_velocities -= running_velocities[running_index];
+            if (stall_detector_.is_stalled(i) &&
+                std::isnan(result.stall_time_s[i]))
+            {
+                result.stall_time_s[i] = step_count * config_.control_period_s;
+                num_stalled++;
+
+                switch (config_.calibration.endstop_stall_action)
+                {
+                    case Config::EndstopStallAction::PUSH:
+                        break;
+                    case Config::EndstopStallAction::HOLD:
+                        torque[i] = 0;
+                        hold_position[i] = observation.position[i];
+                        break;
+                    case Config::EndstopStallAction::ZERO_TORQUE:
+                        torque[i] = 0;
+                        break;
+                }
+            }
         }
-        running_velocities[running_index] = abs_velocities;
-        summed_velocities += abs_velocities;
-        step_count++;
+    }
+
+    result.all_stalled = num_stalled == N_JOINTS;
+    result.duration_s = step_count * config_.control_period_s;
+
+    return result;
+}
+
+TPL_NJBRD
+auto NJBRD::get_current_homing_state() -> HomingCache<N_JOINTS>
+{
+    HomingCache<N_JOINTS> state;
+    state.homing_method = Config::get_homing_method_name(config_.homing_method);
+    state.home_offset_rad = config_.home_offset_rad;
+    state.zero_angles = joint_modules_.get_zero_angles();
+    // measured positions are relative to the zero angles, index angles are
+    // reported by the boards without offset
+    state.raw_position = get_latest_observation().position + state.zero_angles;
+    state.raw_index_angles = get_measured_index_angles();
+
+    return state;
+}
+
+TPL_NJBRD
+bool NJBRD::restore_homing_cache()
+{
+    if (config_.homing_cache_file.empty())
+    {
+        return false;
+    }
+
+    HomingCache<N_JOINTS> cache;
+    try
+    {
+        cache = HomingCache<N_JOINTS>::load(config_.homing_cache_file);
+    }
+    catch (const std::exception &e)
+    {
+        rt_printf("Homing cache not used: %s\n", e.what());
+        return false;
+    }
+
+    const double index_spacing_rad = 2 * M_PI / motor_parameters_.gear_ratio;
+    const HomingCache<N_JOINTS> current = get_current_homing_state();
+    std::string reason;
+    if (!cache.is_valid(current.homing_method,
+                        current.home_offset_rad,
+                        current.raw_position,
+                        current.raw_index_angles,
+                        config_.homing_cache_tolerance_rad,
+                        index_spacing_rad,
+                        &reason))
+    {
+        rt_printf("Homing cache not used: %s\n", reason.c_str());
+        return false;
+    }
+
+    // The position alone does not show if the robot was moved while the
+    // driver was not running, so also check that the encoder indices are
+    // still where they were.  They are only measured when passed, so move
+    // over them first.
+    if (cache.raw_index_angles.array().isNaN().any())
+    {
+        rt_printf("Homing cache not used: No encoder indices stored.\n");
+        return false;
+    }
+    find_encoder_indices();
+    if (!cache.matches_index_angles(get_measured_index_angles(),
+                                    config_.homing_cache_tolerance_rad,
+                                    index_spacing_rad,
+                                    &reason))
+    {
+        rt_printf("Homing cache not used: %s\n", reason.c_str());
+        return false;
+    }
+
+    joint_modules_.set_zero_angles(cache.zero_angles);
+    rt_printf("Restored homing from cache %s.\n",
+              config_.homing_cache_file.c_str());
+
+    return true;
+}
+
+TPL_NJBRD
+void NJBRD::find_encoder_indices()
+{
+    const double index_spacing_rad = 2 * M_PI / motor_parameters_.gear_ratio;
+    const double step_size_rad =
+        INDEX_SEARCH_VELOCITY_RADPS * config_.control_period_s;
+    const uint32_t max_steps =
+        static_cast<uint32_t>(std::ceil(index_spacing_rad / step_size_rad));
+    const Vector step = step_size_rad * get_index_search_direction();
+
+    const Vector start_position = get_latest_observation().position;
+    Vector position = start_position;
+
+    // Move the joints that did not pass an index yet.  The indices are one
+    // motor revolution apart, so there is one within max_steps.
+    for (uint32_t t = 0; t < max_steps; t++)
+    {
+        const Vector index_angles = get_measured_index_angles();
+        if (!index_angles.array().isNaN().any())
+        {
+            break;
+        }
+
+        for (size_t i = 0; i < N_JOINTS; i++)
+        {
+            if (std::isnan(index_angles[i]))
+            {
+                position[i] += step[i];
+            }
+        }
+        apply_action_uninitialized(Action::Position(position));
+    }
+
+    move_to_position(start_position,
+                     config_.move_to_position_tolerance_rad,
+                     max_steps);
+}
+
+TPL_NJBRD
+auto NJBRD::get_index_search_direction() const -> Vector
+{
+    // opposite to the end-stop search
+    Vector direction = Vector::Ones();
+    for (size_t i = 0; i < N_JOINTS; i++)
+    {
+        if (config_.calibration.endstop_search_torques_Nm[i] > 0)
+        {
+            direction[i] = -1;
+        }
+    }
+    return direction;
+}
+
+TPL_NJBRD
+void NJBRD::save_homing_cache()
+{
+    if (config_.homing_cache_file.empty())
+    {
+        return;
+    }
+
+    try
+    {
+        get_current_homing_state().save(config_.homing_cache_file);
+    }
+    catch (const std::exception &e)
+    {
+        rt_printf("WARNING: %s\n", e.what());
     }
 }
 
@@ -755,8 +1922,30 @@ bool NJBRD::homing()
                 return false;
             }
 
-            move_until_blocking(config_.calibration.endstop_search_torques_Nm);
-            rt_printf("Reached end stop.\n");
+            const MoveUntilBlockingResult result = move_until_blocking(
+                config_.calibration.endstop_search_torques_Nm);
+            if (!result.all_stalled)
+            {
+                const Vector velocity = stall_detector_.get_average_velocity();
+                rt_printf(
+                    "End-stop search failed: Not all joints stopped within "
+                    "%.3f s.\n",
+                    result.duration_s);
+                for (size_t i = 0; i < N_JOINTS; i++)
+                {
+                    if (std::isnan(result.stall_time_s[i]))
+                    {
+                        rt_printf(
+                            "\tJoint %zu still moving (average velocity: %.4f "
+                            "rad/s).\n",
+                            i,
+                            velocity[i]);
+                    }
+                }
+                return false;
+            }
+            rt_printf("Reached end stop after %.3f s.\n", result.duration_s);
+            initialization_report_.endstop_search_s = result.duration_s;
 
             break;
         }
@@ -785,7 +1974,11 @@ bool NJBRD::homing()
             const double INDEX_SEARCH_DISTANCE_LIMIT_RAD =
                 (1.5 / motor_parameters_.gear_ratio) * 2 * M_PI;
             //! Absolute step size when moving for encoder index search.
-            constexpr double INDEX_SEARCH_STEP_SIZE_RAD = 0.0003;
+            //! The steps are applied by the homing loop of the joint modules,
+            //! not by the control loop, so they are independent of
+            //! Config::control_period_s.
+            constexpr double INDEX_SEARCH_STEP_SIZE_RAD =
+                INDEX_SEARCH_VELOCITY_RADPS * JOINT_MODULES_HOMING_PERIOD_S;
 
             if (config_.calibration.endstop_search_torques_Nm.isZero())
             {
@@ -798,22 +1991,16 @@ bool NJBRD::homing()
                 return false;
             }
 
-            // Set the search direction for each joint opposite to the end-stop
-            // search direction.
-            Vector index_search_step_sizes;
-            for (unsigned int i = 0; i < N_JOINTS; i++)
-            {
-                index_search_step_sizes[i] = INDEX_SEARCH_STEP_SIZE_RAD;
-                if (config_.calibration.endstop_search_torques_Nm[i] > 0)
-                {
-                    index_search_step_sizes[i] *= -1;
-                }
-            }
+            const Vector index_search_step_sizes =
+                INDEX_SEARCH_STEP_SIZE_RAD * get_index_search_direction();
 
+            const int64_t index_search_start_ns = get_monotonic_time_ns();
             homing_status =
                 joint_modules_.execute_homing(INDEX_SEARCH_DISTANCE_LIMIT_RAD,
                                               config_.home_offset_rad,
                                               index_search_step_sizes);
+            initialization_report_.index_search_s =
+                (get_monotonic_time_ns() - index_search_start_ns) * 1e-9;
 
             break;
         }
@@ -834,15 +2021,20 @@ bool NJBRD::homing()
             // First set motors to zero torque (so they are not actively pushing
             // anymore), then home at current position.
 
-            constexpr uint32_t NUM_ZERO_TORQUE_STEPS = 1000;
+            constexpr double ZERO_TORQUE_DURATION_S = 1.0;
+            const uint32_t NUM_ZERO_TORQUE_STEPS =
+                duration_to_steps(ZERO_TORQUE_DURATION_S);
 
             // release motors (set torque = 0) for a moment, so it is not
             // actively pressing against the end-stop anymore.
+            const int64_t release_start_ns = get_monotonic_time_ns();
             Vector zero = Vector::Zero();
             for (uint32_t i = 0; i < NUM_ZERO_TORQUE_STEPS; i++)
             {
                 apply_action_uninitialized(zero);
             }
+            initialization_report_.zero_torque_release_s =
+                (get_monotonic_time_ns() - release_start_ns) * 1e-9;
 
             // home at the current position (which should be at the end-stop)
             homing_status = joint_modules_.execute_homing_at_current_position(
@@ -857,37 +2049,299 @@ bool NJBRD::homing()
 }
 
 TPL_NJBRD
-bool NJBRD::move_to_position(const NJBRD::Vector &goal_pos,
+uint32_t NJBRD::get_min_jerk_duration_steps(const Vector &distance,
+                                            const double max_velocity,
+                                            const double max_acceleration,
+                                            const double control_period_s,
+                                            const uint32_t max_steps)
+{
+    constexpr double PEAK_VELOCITY_FACTOR = 1.875;
+    // 10 / sqrt(3)
+    constexpr double PEAK_ACCELERATION_FACTOR = 5.773502691896258;
+
+    if (std::isinf(max_velocity) && std::isinf(max_acceleration))
+    {
+        return max_steps;
+    }
+
+    const double max_distance = distance.cwiseAbs().maxCoeff();
+    const double duration_s =
+        std::max(PEAK_VELOCITY_FACTOR * max_distance / max_velocity,
+                 std::sqrt(PEAK_ACCELERATION_FACTOR * max_distance /
+                           max_acceleration));
+    const double steps = std::ceil(duration_s / control_period_s);
+
+    // also covers NaN
+    if (!(steps < max_steps))
+    {
+        return max_steps;
+    }
+    return static_cast<uint32_t>(steps);
+}
+
+TPL_NJBRD
+auto NJBRD::move_to_position(const NJBRD::Vector &goal_pos,
                              const double tolerance,
-                             const uint32_t time_steps)
+                             const uint32_t time_steps,
+                             const int64_t deadline_ns) -> MoveToPositionResult
 {
     // move to the goal position on a minium jerk trajectory, see
     // https://web.archive.org/web/20200715015252/https://mika-s.github.io/python/control-theory/trajectory-generation/2017/12/06/trajectory-generation-with-a-minimum-jerk-trajectory.html
 
-    const auto initial_position = get_latest_observation().position;
+    MoveToPositionResult result;
+    const int64_t start_time_ns = get_monotonic_time_ns();
+
+    const bool early_exit = config_.move_to_position_settled_velocity_radps > 0;
+    auto is_settled = [&](const Observation &observation) {
+        return ((goal_pos - observation.position).array().abs() < tolerance)
+                   .all() &&
+               (!early_exit ||
+                (observation.velocity.array().abs() <
+                 config_.move_to_position_settled_velocity_radps)
+                    .all());
+    };
 
+    Observation observation = get_latest_observation();
+    const Vector initial_position = observation.position;
+    const Vector distance = goal_pos - initial_position;
+
+    const uint32_t steps = get_min_jerk_duration_steps(
+        distance,
+        config_.move_to_position_max_velocity_radps,
+        config_.move_to_position_max_acceleration_radps2,
+        config_.control_period_s,
+        time_steps);
+
+    // Follow the profile, then keep commanding the goal until the joints
+    // settled there (the joints lag behind the set point, so they are usually
+    // not at the goal when the profile ends).  Both together take at most
+    // time_steps.
     for (uint32_t t = 0; t < time_steps; t++)
     {
-        double alpha = (double)t / (double)time_steps;
-        auto step_goal = initial_position + (goal_pos - initial_position) *
-                                                (10.0 * std::pow(alpha, 3) -
-                                                 15.0 * std::pow(alpha, 4) +
-                                                 6.0 * std::pow(alpha, 5));
+        if ((early_exit || t >= steps) && is_settled(observation))
+        {
+            break;
+        }
+        if (get_monotonic_time_ns() >= deadline_ns)
+        {
+            result.deadline_exceeded = true;
+            break;
+        }
+
+        const double phase = t < steps ? get_min_jerk_phase(t, steps) : 1.0;
+        Vector step_goal = initial_position + distance * phase;
 
         apply_action_uninitialized(Action::Position(step_goal));
+        result.executed_steps++;
+
+        observation = get_latest_observation();
     }
 
     // check if the goal was really reached
-    const Vector position_error = goal_pos - get_latest_observation().position;
-    bool reached_goal = (position_error.array().abs() < tolerance).all();
+    result.position_error = goal_pos - get_latest_observation().position;
+    result.reached_goal =
+        (result.position_error.array().abs() < tolerance).all();
+    result.duration_s = (get_monotonic_time_ns() - start_time_ns) * 1e-9;
+
+    return result;
+}
+
+TPL_NJBRD
+auto NJBRD::execute_trajectory(
+    const std::vector<typename Config::TrajectoryStep> &trajectory,
+    const double tolerance,
+    const int64_t deadline_ns) -> ExecuteTrajectoryResult
+{
+    enum class StepState
+    {
+        PENDING,
+        ACTIVE,
+        DONE
+    };
+
+    ExecuteTrajectoryResult result;
+    result.reached_goal = true;
+    const int64_t start_time_ns = get_monotonic_time_ns();
+
+    const std::vector<std::vector<size_t>> dependencies =
+        Config::get_trajectory_dependencies(trajectory);
+    std::vector<StepState> state(trajectory.size(), StepState::PENDING);
+    std::vector<uint32_t> start_cycle(trajectory.size(), 0);
+    std::vector<uint32_t> duration(trajectory.size(), 0);
+    std::vector<uint32_t> hold_steps(trajectory.size(), 0);
+    std::vector<Vector> origin(trajectory.size(), Vector::Zero());
+    size_t num_done = 0;
+
+    const bool early_exit = config_.move_to_position_settled_velocity_radps > 0;
+
+    // position error on the joints of the given step
+    auto get_step_error = [&](size_t i, const Observation &observation) {
+        Vector error = Vector::Zero();
+        for (size_t joint = 0; joint < N_JOINTS; joint++)
+        {
+            if (trajectory[i].moves_joint(joint))
+            {
+                error[joint] = trajectory[i].target_position_rad[joint] -
+                               observation.position[joint];
+            }
+        }
+        return error;
+    };
+    auto is_settled = [&](size_t i, const Observation &observation) {
+        for (size_t joint = 0; early_exit && joint < N_JOINTS; joint++)
+        {
+            if (trajectory[i].moves_joint(joint) &&
+                !(std::abs(observation.velocity[joint]) <
+                  config_.move_to_position_settled_velocity_radps))
+            {
+                return false;
+            }
+        }
+        return (get_step_error(i, observation).array().abs() < tolerance)
+            .all();
+    };
+
+    // If the step does not specify a number of steps (i.e. the duration is
+    // derived from the limits), the target is held for a fixed duration.
+    const uint32_t default_hold_steps = static_cast<uint32_t>(
+        std::ceil(TRAJECTORY_HOLD_DURATION_S / config_.control_period_s));
+
+    Observation observation = get_latest_observation();
+    Vector command = observation.position;
+
+    for (uint32_t t = 0; num_done < trajectory.size(); t++)
+    {
+        // Finish steps that reached their target.  After the profile, the
+        // target is held until the joints settled there (they lag behind the
+        // set point), so a step only fails if the hold phase is over as well.
+        for (size_t i = 0; i < trajectory.size(); i++)
+        {
+            if (state[i] != StepState::ACTIVE)
+            {
+                continue;
+            }
+
+            const uint32_t s = t - start_cycle[i];
+            if (!((early_exit || s >= duration[i]) &&
+                  is_settled(i, observation)))
+            {
+                if (s >= static_cast<uint64_t>(duration[i]) + hold_steps[i])
+                {
+                    result.reached_goal = false;
+                    result.failed_step = static_cast<int>(i);
+                    result.position_error = get_step_error(i, observation);
+                    break;
+                }
+                continue;
+            }
+
+            for (size_t joint = 0; joint < N_JOINTS; joint++)
+            {
+                if (trajectory[i].moves_joint(joint))
+                {
+                    command[joint] = trajectory[i].target_position_rad[joint];
+                }
+            }
+            state[i] = StepState::DONE;
+            num_done++;
+        }
+        if (!result.reached_goal || num_done == trajectory.size())
+        {
+            break;
+        }
+
+        // start all steps whose dependencies are finished
+        for (size_t i = 0; i < trajectory.size(); i++)
+        {
+            if (state[i] != StepState::PENDING ||
+                !std::all_of(dependencies[i].begin(),
+                             dependencies[i].end(),
+                             [&](size_t k) {
+                                 return state[k] == StepState::DONE;
+                             }))
+            {
+                continue;
+            }
+
+            Vector distance = Vector::Zero();
+            for (size_t joint = 0; joint < N_JOINTS; joint++)
+            {
+                if (trajectory[i].moves_joint(joint))
+                {
+                    distance[joint] =
+                        trajectory[i].target_position_rad[joint] -
+                        command[joint];
+                }
+            }
+
+            origin[i] = command;
+            start_cycle[i] = t;
+            duration[i] = get_min_jerk_duration_steps(
+                distance,
+                config_.move_to_position_max_velocity_radps,
+                config_.move_to_position_max_acceleration_radps2,
+                config_.control_period_s,
+                trajectory[i].move_steps > 0
+                    ? trajectory[i].move_steps
+                    : std::numeric_limits<uint32_t>::max());
+            hold_steps[i] = trajectory[i].move_steps > 0
+                                ? trajectory[i].move_steps
+                                : default_hold_steps;
+            state[i] = StepState::ACTIVE;
+        }
+
+        if (get_monotonic_time_ns() >= deadline_ns)
+        {
+            // report the first unfinished step as failed
+            const size_t i = static_cast<size_t>(
+                std::find(state.begin(), state.end(), StepState::ACTIVE) -
+                state.begin());
+            result.reached_goal = false;
+            result.deadline_exceeded = true;
+            if (i < trajectory.size())
+            {
+                result.failed_step = static_cast<int>(i);
+                result.position_error = get_step_error(i, observation);
+            }
+            break;
+        }
+
+        for (size_t i = 0; i < trajectory.size(); i++)
+        {
+            const uint32_t s = t - start_cycle[i];
+            if (state[i] != StepState::ACTIVE)
+            {
+                continue;
+            }
+            // hold the target after the profile
+            const double p =
+                s < duration[i] ? get_min_jerk_phase(s, duration[i]) : 1.0;
+            for (size_t joint = 0; joint < N_JOINTS; joint++)
+            {
+                if (trajectory[i].moves_joint(joint))
+                {
+                    command[joint] =
+                        origin[i][joint] +
+                        (trajectory[i].target_position_rad[joint] -
+                         origin[i][joint]) *
+                            p;
+                }
+            }
+        }
+
+        apply_action_uninitialized(Action::Position(command));
+        result.executed_steps++;
+        observation = get_latest_observation();
+    }
+
+    result.duration_s = (get_monotonic_time_ns() - start_time_ns) * 1e-9;
 
-    return reached_goal;
+    return result;
 }
 
-template <size_t N_JOINTS, size_t N_MOTOR_BOARDS>
-auto SimpleNJointBlmcRobotDriver<N_JOINTS,
-                                 N_MOTOR_BOARDS>::get_latest_observation()
-    -> Observation
+template <size_t N_JOINTS, size_t N_MOTOR_BOARDS, typename MotorBoardType>
+auto SimpleNJointBlmcRobotDriver<N_JOINTS, N_MOTOR_BOARDS, MotorBoardType>::
+    get_latest_observation() -> Observation
 {
     Observation observation;
 
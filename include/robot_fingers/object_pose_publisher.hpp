@@ -0,0 +1,187 @@
+/**
+ * @file
+ * @brief Separate time series with only the object pose of the cameras.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <robot_interfaces/sensors/sensor_data.hpp>
+#include <time_series/interface.hpp>
+#include <trifinger_object_tracking/object_pose.hpp>
+#include <trifinger_object_tracking/tricamera_object_observation.hpp>
+
+namespace robot_fingers
+{
+/**
+ * @brief Object pose of one camera observation.
+ *
+ * Contains only the result of the object tracker but not the images, so it is
+ * cheap to copy out of shared memory.
+ */
+struct ObjectPoseObservation
+{
+    //! @brief Pose of the object as detected in the camera images.
+    trifinger_object_tracking::ObjectPose object_pose;
+    //! @brief Filtered pose of the object.
+    trifinger_object_tracking::ObjectPose filtered_object_pose;
+    //! @brief Time index of the camera observation in the camera time series.
+    time_series::Index camera_timeindex = -1;
+    //! @brief Timestamp of the camera observation in the camera time series.
+    time_series::Timestamp camera_timestamp_ms = 0;
+
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(object_pose,
+                filtered_object_pose,
+                camera_timeindex,
+                camera_timestamp_ms);
+    }
+};
+
+typedef robot_interfaces::SensorData<ObjectPoseObservation> ObjectPoseData;
+typedef robot_interfaces::SingleProcessSensorData<ObjectPoseObservation>
+    SingleProcessObjectPoseData;
+typedef robot_interfaces::MultiProcessSensorData<ObjectPoseObservation>
+    MultiProcessObjectPoseData;
+
+/**
+ * @brief Copies the object poses of camera observations to a separate time
+ *        series.
+ *
+ * Runs a thread that appends the object pose of each new camera observation
+ * to the object pose data.  This way, users that only need the pose (e.g. a
+ * controller) can read it from the small object pose time series instead of
+ * copying the full camera observation including the images (see
+ * T_TriFingerPlatformFrontend::get_object_pose).
+ *
+ * Observations that are dropped from the camera time series before the
+ * publisher could read them are skipped.  If an unexpected error occurs (e.g.
+ * when accessing the shared memory), it is printed and the thread stops.
+ */
+class ObjectPosePublisher
+{
+public:
+    typedef trifinger_object_tracking::TriCameraObjectObservation
+        CameraObservation;
+
+    //! @brief Default ID of the shared memory used for the object pose data.
+    static constexpr const char *DEFAULT_SHARED_MEMORY_ID = "object_pose";
+
+    /**
+     * @param camera_data  Data of the camera backend (with object tracker).
+     * @param object_pose_data  Data to which the object poses are written.
+     */
+    ObjectPosePublisher(
+        std::shared_ptr<robot_interfaces::SensorData<CameraObservation>>
+            camera_data,
+        std::shared_ptr<ObjectPoseData> object_pose_data)
+        : camera_data_(camera_data), object_pose_data_(object_pose_data)
+    {
+        // Start with the latest observation (or the first one, if there is
+        // none yet).  This is determined here and not in the thread, so it
+        // does not depend on when the thread starts running.
+        time_series::Index t =
+            camera_data_->observation->newest_timeindex(false);
+        if (t == time_series::EMPTY)
+        {
+            t = 0;
+        }
+
+        thread_ = std::thread(&ObjectPosePublisher::loop, this, t);
+    }
+
+    ~ObjectPosePublisher()
+    {
+        is_running_ = false;
+        thread_.join();
+    }
+
+    ObjectPosePublisher(const ObjectPosePublisher &) = delete;
+    ObjectPosePublisher &operator=(const ObjectPosePublisher &) = delete;
+
+    /**
+     * @brief Append the object pose of camera observation t to the poses.
+     *
+     * If t was already dropped from the camera time series, the oldest
+     * observation that is still available is used instead.
+     *
+     * @param cameras  The camera time series.  Observation t must exist.
+     * @param poses  The time series to which the pose is appended.
+     * @param t  Time index of the camera observation.
+     *
+     * @return Time index of the next camera observation to publish.
+     * @throws std::invalid_argument if the observation is dropped while
+     *     reading it.
+     */
+    static time_series::Index publish(
+        time_series::TimeSeriesInterface<CameraObservation> &cameras,
+        time_series::TimeSeriesInterface<ObjectPoseObservation> &poses,
+        time_series::Index t)
+    {
+        // skip observations that were already dropped
+        t = std::max(t, cameras.oldest_timeindex());
+
+        const CameraObservation observation = cameras[t];
+
+        ObjectPoseObservation pose;
+        pose.object_pose = observation.object_pose;
+        pose.filtered_object_pose = observation.filtered_object_pose;
+        pose.camera_timeindex = t;
+        pose.camera_timestamp_ms = cameras.timestamp_ms(t);
+        poses.append(pose);
+
+        return t + 1;
+    }
+
+private:
+    //! @brief Maximum time the thread waits before checking for stop [s].
+    static constexpr double WAIT_TIMEOUT_S = 0.1;
+
+    std::shared_ptr<robot_interfaces::SensorData<CameraObservation>>
+        camera_data_;
+    std::shared_ptr<ObjectPoseData> object_pose_data_;
+    std::atomic<bool> is_running_ = {true};
+    std::thread thread_;
+
+    void loop(time_series::Index t)
+    {
+        auto &cameras = *camera_data_->observation;
+
+        while (is_running_)
+        {
+            try
+            {
+                if (cameras.wait_for_timeindex(t, WAIT_TIMEOUT_S))
+                {
+                    t = publish(cameras, *object_pose_data_->observation, t);
+                }
+            }
+            catch (const std::invalid_argument &e)
+            {
+                // observation was dropped while reading it, try again with
+                // the oldest one
+                std::cerr << "ObjectPosePublisher: " << e.what() << std::endl;
+            }
+            catch (const std::exception &e)
+            {
+                // do not let the exception terminate the process but do not
+                // keep retrying either
+                std::cerr << "ObjectPosePublisher: Stopping due to error: "
+                          << e.what() << std::endl;
+                break;
+            }
+        }
+    }
+};
+
+}  // namespace robot_fingers
@@ -0,0 +1,221 @@
+/**
+ * @file
+ * @brief Send the control inputs of multiple motor boards in parallel.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <atomic>
+#include <cerrno>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace robot_fingers
+{
+/**
+ * @brief Sends the control inputs of multiple motor boards in parallel.
+ *
+ * Each board is on its own CAN bus, but sending the control inputs of all
+ * boards from the control thread writes the frames one after the other, so the
+ * duration of the send phase grows linearly with the number of boards.
+ *
+ * This class starts one writer thread per board.  @ref send wakes up all
+ * writers at the same time, each of which calls `send_if_input_changed()` of
+ * its board, and blocks until all of them are done.  This way the frames of
+ * all boards are sent (nearly) simultaneously.
+ *
+ * The writers are woken up via POSIX semaphores, so @ref send does not
+ * allocate memory or lock a mutex.  If possible, the writer threads are run
+ * with real-time priority.  They can optionally be pinned to specific CPUs.
+ *
+ * @tparam Board  Type of the motor boards.  Needs to provide a method
+ *     `send_if_input_changed()`.
+ */
+template <typename Board>
+class ParallelBoardSender
+{
+public:
+    //! @brief Real-time priority of the writer threads (SCHED_FIFO).
+    static constexpr int WRITER_THREAD_PRIORITY = 80;
+
+    /**
+     * @param boards  The motor boards.
+     * @param cpus  CPUs to which the writer threads are pinned (one per
+     *     board).  Leave empty to not pin the threads.
+     * @throws std::invalid_argument if cpus is not empty but its size does not
+     *     match the number of boards.
+     */
+    explicit ParallelBoardSender(
+        const std::vector<std::shared_ptr<Board>> &boards,
+        const std::vector<int> &cpus = {})
+        : boards_(boards), writers_(boards.size())
+    {
+        if (!cpus.empty() && cpus.size() != boards.size())
+        {
+            throw std::invalid_argument(
+                "Number of CPUs does not match the number of boards.");
+        }
+
+        sem_init(&done_, 0, 0);
+        for (size_t i = 0; i < writers_.size(); i++)
+        {
+            sem_init(&writers_[i].start, 0, 0);
+        }
+
+        is_running_ = true;
+        for (size_t i = 0; i < writers_.size(); i++)
+        {
+            writers_[i].thread =
+                std::thread(&ParallelBoardSender::loop, this, i);
+            configure_thread(writers_[i].thread,
+                             cpus.empty() ? -1 : cpus[i]);
+        }
+    }
+
+    ~ParallelBoardSender()
+    {
+        is_running_ = false;
+        for (Writer &writer : writers_)
+        {
+            sem_post(&writer.start);
+        }
+        for (Writer &writer : writers_)
+        {
+            writer.thread.join();
+            sem_destroy(&writer.start);
+        }
+        sem_destroy(&done_);
+    }
+
+    ParallelBoardSender(const ParallelBoardSender &) = delete;
+    ParallelBoardSender &operator=(const ParallelBoardSender &) = delete;
+
+    /**
+     * @brief Send the control inputs of all boards in parallel.
+     *
+     * Blocks until all boards are done.  Must only be called by one thread at
+     * a time.
+     *
+     * If sending fails for one of the boards, the exception thrown by its
+     * `send_if_input_changed()` is rethrown here (after all boards are done,
+     * so the sender can still be used afterwards).  If several boards fail,
+     * only the exception of the first one is rethrown.
+     */
+    void send()
+    {
+        for (Writer &writer : writers_)
+        {
+            sem_post(&writer.start);
+        }
+        for (size_t i = 0; i < writers_.size(); i++)
+        {
+            wait(&done_);
+        }
+
+        // errors are only set by the writers before posting done_, so they
+        // can safely be accessed here
+        std::exception_ptr error;
+        for (Writer &writer : writers_)
+        {
+            if (writer.error && !error)
+            {
+                error = writer.error;
+            }
+            writer.error = nullptr;
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    //! @brief Number of boards (and writer threads).
+    size_t size() const
+    {
+        return boards_.size();
+    }
+
+private:
+    struct Writer
+    {
+        sem_t start;
+        std::thread thread;
+        //! @brief Exception thrown by the last send of the board (if any).
+        std::exception_ptr error;
+    };
+
+    std::vector<std::shared_ptr<Board>> boards_;
+    std::vector<Writer> writers_;
+    sem_t done_;
+    std::atomic<bool> is_running_ = {false};
+
+    void loop(size_t index)
+    {
+        while (true)
+        {
+            wait(&writers_[index].start);
+            if (!is_running_)
+            {
+                break;
+            }
+
+            // Always report back, otherwise send() would wait forever.
+            try
+            {
+                boards_[index]->send_if_input_changed();
+            }
+            catch (...)
+            {
+                writers_[index].error = std::current_exception();
+            }
+
+            sem_post(&done_);
+        }
+    }
+
+    //! @brief Wait on the semaphore (retry if interrupted by a signal).
+    static void wait(sem_t *semaphore)
+    {
+        while (sem_wait(semaphore) != 0 && errno == EINTR)
+        {
+        }
+    }
+
+    /**
+     * @brief Try to set real-time priority and CPU affinity of the thread.
+     *
+     * Failing to set the priority (e.g. due to missing permissions) is not an
+     * error, the thread is then run with normal priority.  Failing to set the
+     * affinity only prints a warning.
+     */
+    static void configure_thread(std::thread &thread, int cpu)
+    {
+        sched_param param;
+        param.sched_priority = WRITER_THREAD_PRIORITY;
+        pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param);
+
+        if (cpu >= 0)
+        {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(cpu, &cpuset);
+            int ret = pthread_setaffinity_np(
+                thread.native_handle(), sizeof(cpuset), &cpuset);
+            if (ret != 0)
+            {
+                std::cerr << "WARNING: Failed to pin CAN writer thread to CPU "
+                          << cpu << "." << std::endl;
+            }
+        }
+    }
+};
+
+}  // namespace robot_fingers
@@ -0,0 +1,187 @@
+/**
+ * @file
+ * @brief Scheduler for periodic loops with absolute deadlines.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <stdexcept>
+
+namespace robot_fingers
+{
+//! @brief Get the current time of `CLOCK_MONOTONIC` in nanoseconds.
+inline int64_t get_monotonic_time_ns()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * @brief Scheduler for periodic loops with absolute deadlines.
+ *
+ * Keeps an absolute deadline for the end of the current cycle (on
+ * `CLOCK_MONOTONIC`) and sleeps until it is reached using `clock_nanosleep`
+ * with `TIMER_ABSTIME`.  The next deadline is computed by adding the period to
+ * the previous deadline (not to the time of wake up), so the wake up latency of
+ * one cycle does not accumulate over time and the loop keeps its nominal rate.
+ *
+ * If a cycle takes longer than one period, the deadline is already passed when
+ * @ref wait_for_next_period is called.  In this case the method returns
+ * immediately and the overrun is counted.  If the delay is so large that whole
+ * periods were missed, these slots are skipped explicitly (i.e. the scheduler
+ * does not try to catch up by running several cycles without sleeping) and
+ * they are counted as well.
+ *
+ * This class is not thread-safe.  It is expected to be used only by the thread
+ * that runs the loop.
+ */
+class PeriodicScheduler
+{
+public:
+    /**
+     * @param period_s  Period of the loop in seconds.
+     * @throws std::invalid_argument if period_s is not positive.
+     */
+    explicit PeriodicScheduler(double period_s)
+        : period_ns_(static_cast<int64_t>(period_s * 1e9))
+    {
+        if (!(period_ns_ > 0))
+        {
+            throw std::invalid_argument("Period must be greater than zero.");
+        }
+    }
+
+    /**
+     * @brief Start a new periodic sequence at the current time.
+     *
+     * The deadline of the current cycle is set to now + period.  Call this
+     * at the beginning of the first cycle of the loop, or to re-synchronise
+     * after the loop was paused (otherwise the pause would be counted as
+     * overrun).
+     */
+    void start()
+    {
+        next_deadline_ns_ = get_monotonic_time_ns() + period_ns_;
+        is_running_ = true;
+    }
+
+    /**
+     * @brief Stop the periodic sequence.
+     *
+     * Use this if the loop is paused for an unknown duration.  The next call of
+     * @ref wait_for_next_period will then implicitly call @ref start.
+     */
+    void stop()
+    {
+        is_running_ = false;
+    }
+
+    //! @brief True if a periodic sequence is running, see @ref start.
+    bool is_running() const
+    {
+        return is_running_;
+    }
+
+    /**
+     * @brief Sleep until the deadline of the current cycle is reached.
+     *
+     * If the scheduler is not running yet, it is started (so this returns
+     * after one period).
+     *
+     * @return True if the deadline was met, false if it was already passed
+     *     when this method was called.
+     */
+    bool wait_for_next_period()
+    {
+        if (!is_running_)
+        {
+            start();
+        }
+
+        bool deadline_met = true;
+        const int64_t now = get_monotonic_time_ns();
+
+        if (now > next_deadline_ns_)
+        {
+            deadline_met = false;
+            overrun_count_++;
+
+            // Skip all slots that have completely passed already, so the next
+            // deadline is the end of the slot we are currently in.
+            const int64_t missed_slots = (now - next_deadline_ns_) / period_ns_;
+            next_deadline_ns_ += missed_slots * period_ns_;
+            skipped_slot_count_ += static_cast<uint64_t>(missed_slots);
+        }
+        else
+        {
+            const timespec deadline = to_timespec(next_deadline_ns_);
+            // clock_nanosleep returns the error code instead of setting errno.
+            while (clock_nanosleep(
+                       CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) ==
+                   EINTR)
+            {
+            }
+        }
+
+        next_deadline_ns_ += period_ns_;
+        cycle_count_++;
+
+        return deadline_met;
+    }
+
+    //! @brief Get the period in seconds.
+    double get_period_s() const
+    {
+        return static_cast<double>(period_ns_) * 1e-9;
+    }
+
+    //! @brief Number of cycles that were completed by wait_for_next_period.
+    uint64_t get_cycle_count() const
+    {
+        return cycle_count_;
+    }
+
+    //! @brief Number of cycles in which the deadline was missed.
+    uint64_t get_overrun_count() const
+    {
+        return overrun_count_;
+    }
+
+    //! @brief Number of whole periods that were skipped due to overruns.
+    uint64_t get_skipped_slot_count() const
+    {
+        return skipped_slot_count_;
+    }
+
+    //! @brief Reset cycle, overrun and skipped slot counters to zero.
+    void reset_counters()
+    {
+        cycle_count_ = 0;
+        overrun_count_ = 0;
+        skipped_slot_count_ = 0;
+    }
+
+private:
+    int64_t period_ns_;
+    int64_t next_deadline_ns_ = 0;
+    bool is_running_ = false;
+
+    uint64_t cycle_count_ = 0;
+    uint64_t overrun_count_ = 0;
+    uint64_t skipped_slot_count_ = 0;
+
+    static timespec to_timespec(int64_t time_ns)
+    {
+        timespec t;
+        t.tv_sec = time_ns / 1000000000;
+        t.tv_nsec = time_ns % 1000000000;
+        return t;
+    }
+};
+
+}  // namespace robot_fingers
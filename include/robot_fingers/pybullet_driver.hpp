@@ -37,9 +37,13 @@ class BasePyBulletFingerDriver
     : public robot_interfaces::RobotDriver<Action, Observation>
 {
 protected:
-    //! @brief If true, step simulation at 1 kHz, otherwise as fast as possible
+    //! @brief If true, step simulation in real time, otherwise as fast as
+    //!        possible.
     bool real_time_mode_;
 
+    //! @brief Duration of one simulation step/control cycle [s].
+    double control_period_s_;
+
     //! @brief If true, pyBullet GUI for visualization is started.
     bool visualize_;
 
@@ -54,8 +58,12 @@ protected:
 public:
     typedef typename Observation::JointVector JointVector;
 
-    BasePyBulletFingerDriver(bool real_time_mode, bool visualize)
-        : real_time_mode_(real_time_mode), visualize_(visualize)
+    BasePyBulletFingerDriver(bool real_time_mode,
+                             bool visualize,
+                             double control_period_s = 0.001)
+        : real_time_mode_(real_time_mode),
+          control_period_s_(control_period_s),
+          visualize_(visualize)
     {
         // initialize Python interpreter if not already done
         if (!Py_IsInitialized())
@@ -105,8 +113,10 @@ public:
 
         if (real_time_mode_)
         {
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_until(start_time + 1ms);
+            std::this_thread::sleep_until(
+                start_time +
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::duration<double>(control_period_s_)));
         }
 
         return applied_action;
@@ -137,6 +147,7 @@ public:
  * @param visualize If true, pyBullet's GUI is started for visualization.
  * @param first_action_timeout  See RobotBackend
  * @param max_number_of_actions  See RobotBackend
+ * @param control_period_s  Duration of one simulation step [s].
  *
  * @return Backend using a driver of the specified type.
  */
@@ -146,9 +157,11 @@ typename Types::BackendPtr create_finger_backend(
     const bool real_time_mode,
     const bool visualize,
     const double first_action_timeout = std::numeric_limits<double>::infinity(),
-    const uint32_t max_number_of_actions = 0)
+    const uint32_t max_number_of_actions = 0,
+    const double control_period_s = 0.001)
 {
-    auto robot = std::make_shared<Driver>(real_time_mode, visualize);
+    auto robot =
+        std::make_shared<Driver>(real_time_mode, visualize, control_period_s);
     auto backend =
         std::make_shared<typename Types::Backend>(robot,
                                                   robot_data,
@@ -194,8 +207,8 @@ public:
 
         py::module sim_finger =
             py::module::import("trifinger_simulation.sim_finger");
-        sim_finger_ =
-            sim_finger.attr("SimFinger")("fingerone", 0.001, visualize_);
+        sim_finger_ = sim_finger.attr("SimFinger")(
+            "fingerone", control_period_s_, visualize_);
 
         JointVector initial_position;
         initial_position << 0, -0.7, -1.5;
@@ -226,8 +239,8 @@ public:
 
         py::module sim_finger =
             py::module::import("trifinger_simulation.sim_finger");
-        sim_finger_ =
-            sim_finger.attr("SimFinger")("trifingerpro", 0.001, visualize_);
+        sim_finger_ = sim_finger.attr("SimFinger")(
+            "trifingerpro", control_period_s_, visualize_);
 
         JointVector initial_position;
         initial_position << 0, 0.9, -1.7, 0, 0.9, -1.7, 0, 0.9, -1.7;
@@ -17,7 +17,10 @@ class RealFingerDriver : public NFingerDriver<1>
 {
 public:
     RealFingerDriver(const Config &config)
-        : RealFingerDriver(create_motor_boards(config.can_ports), config)
+        : RealFingerDriver(
+              create_motor_boards(config.can_ports,
+                                  config.motor_board_ready_timeout_s),
+              config)
     {
     }
 
@@ -27,15 +30,16 @@ private:
 // the warning until then).
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
-    RealFingerDriver(const MotorBoards &motor_boards, const Config &config)
-        : NFingerDriver<1>(motor_boards,
-                           create_motors(motor_boards),
+    RealFingerDriver(const MotorBoardSetup &boards, const Config &config)
+        : NFingerDriver<1>(boards.boards,
+                           create_motors(boards.boards),
                            {
                                // MotorParameters
                                .torque_constant_NmpA = 0.02,
                                .gear_ratio = 9.0,
                            },
-                           config)
+                           config,
+                           boards.bring_up_s)
     {
     }
 #pragma GCC diagnostic pop
@@ -20,7 +20,10 @@ class SoloEightDriver : public SimpleNJointBlmcRobotDriver<8, 4>
 {
 public:
     SoloEightDriver(const Config &config)
-        : SoloEightDriver(create_motor_boards(config.can_ports), config)
+        : SoloEightDriver(
+              create_motor_boards(config.can_ports,
+                                  config.motor_board_ready_timeout_s),
+              config)
     {
     }
 
@@ -30,15 +33,16 @@ private:
 // the warning until then).
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
-    SoloEightDriver(const MotorBoards &motor_boards, const Config &config)
-        : SimpleNJointBlmcRobotDriver<8, 4>(motor_boards,
-                                            create_motors(motor_boards),
+    SoloEightDriver(const MotorBoardSetup &boards, const Config &config)
+        : SimpleNJointBlmcRobotDriver<8, 4>(boards.boards,
+                                            create_motors(boards.boards),
                                             {
                                                 // MotorParameters
                                                 .torque_constant_NmpA = 0.02,
                                                 .gear_ratio = 9.0,
                                             },
-                                            config)
+                                            config,
+                                            boards.bring_up_s)
     {
     }
 #pragma GCC diagnostic pop
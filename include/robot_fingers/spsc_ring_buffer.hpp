@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace robot_fingers
+{
+/**
+ * @brief Lock-free ring buffer for one producer and one consumer thread.
+ *
+ * The memory for all elements is allocated in the constructor, so neither
+ * @ref try_push nor @ref try_pop allocate or block.  This makes it suitable for
+ * passing data out of a real-time thread.
+ *
+ * Only one thread may call @ref try_push and only one (other) thread may call
+ * @ref try_pop at the same time.
+ *
+ * @tparam T  Type of the elements.  Needs to be default-constructible and
+ *     copy-assignable.
+ */
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    /**
+     * @param capacity  Maximum number of elements that can be stored in the
+     *     buffer.
+     */
+    explicit SpscRingBuffer(size_t capacity) : buffer_(capacity + 1)
+    {
+    }
+
+    /**
+     * @brief Add an element to the buffer (producer side).
+     *
+     * @param element  The element that is added.
+     * @return True if the element was added, false if the buffer is full.
+     */
+    bool try_push(const T &element)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t next_head = increment(head);
+
+        if (next_head == tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        buffer_[head] = element;
+        head_.store(next_head, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest element from the buffer (consumer side).
+     *
+     * @param element  The element is written to this pointer.
+     * @return True if an element was taken, false if the buffer is empty (in
+     *     this case `element` is not modified).
+     */
+    bool try_pop(T *element)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail == head_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        *element = buffer_[tail];
+        tail_.store(increment(tail), std::memory_order_release);
+
+        return true;
+    }
+
+    //! @brief Maximum number of elements that can be stored in the buffer.
+    size_t capacity() const
+    {
+        return buffer_.size() - 1;
+    }
+
+private:
+    //! @brief Storage.  One slot is always left empty to distinguish "full"
+    //!        from "empty".
+    std::vector<T> buffer_;
+
+    //! @brief Index of the next slot to be written (owned by producer).
+    alignas(64) std::atomic<size_t> head_ = {0};
+    //! @brief Index of the next slot to be read (owned by consumer).
+    alignas(64) std::atomic<size_t> tail_ = {0};
+
+    size_t increment(size_t index) const
+    {
+        index++;
+        return index == buffer_.size() ? 0 : index;
+    }
+};
+
+}  // namespace robot_fingers
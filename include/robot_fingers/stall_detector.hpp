@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @brief Per-joint detection of stalled (blocked) joints.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Eigen>
+
+namespace robot_fingers
+{
+/**
+ * @brief Detects for each joint when it stops moving.
+ *
+ * Keeps the absolute joint velocities of the last `window_size` steps in a
+ * ring buffer and considers a joint as stalled once the average over the
+ * window drops below the stop velocity.
+ *
+ * Joints that need some time to start moving (e.g. due to friction) would be
+ * detected as stalled right away, so the window of a joint only starts once
+ * it was first seen moving (i.e. faster than the stop velocity).  A joint
+ * that does not move at all (e.g. because it is already blocked) is only
+ * considered as stalled after `min_steps_without_motion` steps.
+ *
+ * A joint that is detected as stalled stays stalled until @ref reset is
+ * called.
+ *
+ * The window is allocated in the constructor, @ref update and @ref reset do
+ * not allocate memory.
+ *
+ * @tparam N_JOINTS  Number of joints.
+ */
+template <size_t N_JOINTS>
+class StallDetector
+{
+public:
+    typedef Eigen::Matrix<double, N_JOINTS, 1> Vector;
+
+    /**
+     * @param window_size  Number of steps over which the velocity is averaged.
+     * @param stop_velocity  Average absolute velocity below which a joint is
+     *     considered to be stalled.
+     * @param min_steps_without_motion  Number of steps after which joints that
+     *     did not move at all are considered to be stalled.  At least
+     *     `window_size`.
+     * @throws std::invalid_argument if window_size is zero.
+     */
+    StallDetector(size_t window_size,
+                  double stop_velocity,
+                  size_t min_steps_without_motion)
+        : window_(window_size),
+          stop_velocity_(stop_velocity),
+          min_steps_without_motion_(
+              std::max(min_steps_without_motion, window_size))
+    {
+        if (window_size == 0)
+        {
+            throw std::invalid_argument("Window size must be positive.");
+        }
+        reset();
+    }
+
+    //! @brief Clear the window and the stalled state of all joints.
+    void reset()
+    {
+        sum_.setZero();
+        num_samples_ = 0;
+        motion_start_.fill(NOT_MOVED);
+        stalled_.fill(false);
+        num_stalled_ = 0;
+    }
+
+    /**
+     * @brief Add the velocities of a new step.
+     *
+     * @param velocity  Current joint velocities.
+     * @return True if all joints are stalled.
+     */
+    bool update(const Vector &velocity)
+    {
+        const size_t index = num_samples_ % window_.size();
+        const Vector abs_velocity = velocity.cwiseAbs();
+
+        if (num_samples_ >= window_.size())
+        {
+            sum_ -= window_[index];
+        }
+        window_[index] = abs_velocity;
+        sum_ += abs_velocity;
+        num_samples_++;
+
+        const double threshold = stop_velocity_ * window_.size();
+        for (size_t i = 0; i < N_JOINTS; i++)
+        {
+            if (motion_start_[i] == NOT_MOVED &&
+                abs_velocity[i] > stop_velocity_)
+            {
+                motion_start_[i] = num_samples_;
+            }
+
+            const bool window_done =
+                motion_start_[i] == NOT_MOVED
+                    ? num_samples_ >= min_steps_without_motion_
+                    : num_samples_ >= motion_start_[i] + window_.size();
+
+            if (!stalled_[i] && window_done && sum_[i] < threshold)
+            {
+                stalled_[i] = true;
+                num_stalled_++;
+            }
+        }
+
+        return all_stalled();
+    }
+
+    //! @brief Check if the given joint is stalled.
+    bool is_stalled(size_t joint) const
+    {
+        return stalled_[joint];
+    }
+
+    //! @brief Check if all joints are stalled.
+    bool all_stalled() const
+    {
+        return num_stalled_ == N_JOINTS;
+    }
+
+    //! @brief Average absolute velocity of each joint over the window.
+    Vector get_average_velocity() const
+    {
+        const size_t n = std::min(num_samples_, window_.size());
+        return n > 0 ? Vector(sum_ / n) : Vector::Zero();
+    }
+
+    //! @brief Number of steps over which the velocity is averaged.
+    size_t get_window_size() const
+    {
+        return window_.size();
+    }
+
+private:
+    static constexpr size_t NOT_MOVED = std::numeric_limits<size_t>::max();
+
+    std::vector<Vector> window_;
+    double stop_velocity_;
+    size_t min_steps_without_motion_;
+    Vector sum_;
+    size_t num_samples_;
+    //! @brief Step in which each joint was first seen moving.
+    std::array<size_t, N_JOINTS> motion_start_;
+    std::array<bool, N_JOINTS> stalled_;
+    size_t num_stalled_;
+};
+
+}  // namespace robot_fingers
@@ -0,0 +1,168 @@
+/**
+ * @file
+ * @brief Matching of time indices between time series by timestamp.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+namespace robot_fingers
+{
+/**
+ * @brief Finds the time index of a time series that matches a timestamp.
+ *
+ * For a given timestamp, find the highest time index t of a time series where
+ *
+ *     timestamp(t) <= stamp
+ *
+ * Timestamps of the series are expected to be non-decreasing.  Getting a
+ * timestamp may be expensive (e.g. a round trip to shared memory), so the
+ * search tries to read as few of them as possible:
+ *
+ * 1. The newest index is checked first.  When matching live data, this is
+ *    the result in most cases, so it is found with a single lookup.
+ * 2. Otherwise the search starts at the index found by the previous call
+ *    (the "cursor") and gallops from there (distances 1, 2, 4, ...) towards
+ *    the match, followed by a binary search in the last interval.  This way
+ *    consecutive queries for nearby times (e.g. when reading back through a
+ *    log) need O(log d) lookups, where d is the distance to the previous
+ *    match, and arbitrary historical queries need O(log n).
+ *
+ * Old entries may have been dropped from the time series (e.g. because the
+ * buffer is full).  The timestamp getter reports them as unavailable and they
+ * are treated as older than any timestamp.
+ *
+ * The cursor is only a hint for the search, so the matcher may be used from
+ * multiple threads at the same time.
+ */
+class TimeIndexMatcher
+{
+public:
+    //! @brief Same as time_series::Index.
+    typedef int64_t Index;
+
+    TimeIndexMatcher() = default;
+
+    // copies start with the cursor of the original
+    TimeIndexMatcher(const TimeIndexMatcher &other)
+        : cursor_(other.cursor_.load(std::memory_order_relaxed))
+    {
+    }
+
+    TimeIndexMatcher &operator=(const TimeIndexMatcher &other)
+    {
+        cursor_.store(other.cursor_.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+        return *this;
+    }
+
+    /**
+     * @brief Find the highest index whose timestamp is not after stamp.
+     *
+     * @param stamp  The timestamp to match.
+     * @param newest  Newest index of the time series.
+     * @param get_timestamp  Callable `bool(Index t, Timestamp *stamp)` which
+     *     sets the timestamp of index t and returns true, or returns false if
+     *     t is not available (anymore).  Only called for 0 <= t <= newest.
+     *
+     * @return The matching index.
+     * @throws std::out_of_range if no available index matches (i.e. all
+     *     available entries are newer than stamp).
+     */
+    template <typename Timestamp, typename GetTimestamp>
+    Index find(const Timestamp stamp,
+               const Index newest,
+               GetTimestamp &&get_timestamp)
+    {
+        // Search for the highest index for which is_before_or_at() is true.
+        // Unavailable indices are older than the available ones, so the
+        // predicate is monotonic: true up to the match, false after it.
+        bool is_available = false;
+        auto is_before_or_at = [&](Index t) {
+            Timestamp stamp_t;
+            is_available = t >= 0 && get_timestamp(t, &stamp_t);
+            return !is_available || !(stamp < stamp_t);
+        };
+
+        // invariant: the match is in [low, high), where low is -1 or an index
+        // known to be before or at stamp and high is an index known to be
+        // after it (or newest + 1)
+        Index low = -1;
+        bool low_is_available = false;
+        Index high = newest + 1;
+
+        auto check = [&](Index t) {
+            if (is_before_or_at(t))
+            {
+                low = t;
+                low_is_available = is_available;
+                return true;
+            }
+            high = t;
+            return false;
+        };
+
+        if (!check(newest))
+        {
+            // start from the previous match if it is still in range
+            Index start = cursor_.load(std::memory_order_relaxed);
+            if (start < 0 || start >= newest)
+            {
+                start = newest - 1;
+            }
+
+            if (check(start))
+            {
+                // gallop towards the newer entries
+                for (Index step = 1; low + step < high; step *= 2)
+                {
+                    if (!check(low + step))
+                    {
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                // gallop towards the older entries
+                for (Index step = 1; high - step > low; step *= 2)
+                {
+                    if (check(high - step))
+                    {
+                        break;
+                    }
+                }
+            }
+
+            while (high - low > 1)
+            {
+                check(low + (high - low) / 2);
+            }
+        }
+
+        if (!low_is_available)
+        {
+            throw std::out_of_range(
+                "No matching time index available for the given timestamp.");
+        }
+
+        cursor_.store(low, std::memory_order_relaxed);
+        return low;
+    }
+
+    //! @brief Forget the previous match.
+    void reset()
+    {
+        cursor_.store(-1, std::memory_order_relaxed);
+    }
+
+private:
+    //! @brief Index found by the previous call (-1 if none).
+    std::atomic<Index> cursor_ = {-1};
+};
+
+}  // namespace robot_fingers
@@ -0,0 +1,329 @@
+/**
+ * @file
+ * @brief Precomputed joint trajectories (minimum jerk, quintic, spline).
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+
+namespace robot_fingers
+{
+/**
+ * @brief Evaluate the minimum jerk phase polynomial.
+ *
+ * @param alpha  Normalised time in [0, 1].
+ * @return `10 alpha^3 - 15 alpha^4 + 6 alpha^5`, i.e. the fraction of the
+ *     distance that is covered at the given time.
+ */
+inline double min_jerk_phase(const double alpha)
+{
+    // Horner form of the polynomial
+    return alpha * alpha * alpha * (10.0 + alpha * (-15.0 + alpha * 6.0));
+}
+
+/**
+ * @brief Trajectory with positions and velocities precomputed for each step.
+ *
+ * The trajectory is sampled at the end of each step, i.e. step `t` holds the
+ * values at time `(t + 1) * step_duration`, so the first step is the first
+ * set point after the start and the last step is the goal.  Values of all
+ * steps are stored in one contiguous buffer per quantity (one row per step),
+ * so executing the trajectory only requires indexing into them.
+ *
+ * The trajectories are independent of the number of joints, so they can as
+ * well be used for other quantities (e.g. end-effector positions).
+ */
+class Trajectory
+{
+public:
+    typedef Eigen::VectorXd Vector;
+    //! @brief Values of all steps, one row per step.
+    typedef Eigen::Matrix<double,
+                          Eigen::Dynamic,
+                          Eigen::Dynamic,
+                          Eigen::RowMajor>
+        Buffer;
+
+    Trajectory() = default;
+
+    /**
+     * @param positions  Positions, one row per step.
+     * @param velocities  Velocities, one row per step.
+     * @throws std::invalid_argument if the shapes of positions and velocities
+     *     do not match.
+     */
+    Trajectory(const Buffer &positions, const Buffer &velocities)
+        : positions_(positions), velocities_(velocities)
+    {
+        if (positions.rows() != velocities.rows() ||
+            positions.cols() != velocities.cols())
+        {
+            throw std::invalid_argument(
+                "Shapes of positions and velocities do not match.");
+        }
+    }
+
+    /**
+     * @brief Quintic polynomial between two states.
+     *
+     * @param start  Start position.
+     * @param goal  Goal position.
+     * @param start_velocity  Velocity at the start.
+     * @param goal_velocity  Velocity at the goal.
+     * @param start_acceleration  Acceleration at the start.
+     * @param goal_acceleration  Acceleration at the goal.
+     * @param num_steps  Number of steps of the trajectory.
+     * @param step_duration_s  Duration of one step [s].
+     * @throws std::invalid_argument if the sizes of the vectors do not match.
+     */
+    static Trajectory quintic(const Vector &start,
+                              const Vector &goal,
+                              const Vector &start_velocity,
+                              const Vector &goal_velocity,
+                              const Vector &start_acceleration,
+                              const Vector &goal_acceleration,
+                              const uint32_t num_steps,
+                              const double step_duration_s)
+    {
+        const Eigen::Index n = start.size();
+        if (goal.size() != n || start_velocity.size() != n ||
+            goal_velocity.size() != n || start_acceleration.size() != n ||
+            goal_acceleration.size() != n)
+        {
+            throw std::invalid_argument("Sizes of the vectors do not match.");
+        }
+
+        Trajectory trajectory;
+        trajectory.positions_.resize(num_steps, n);
+        trajectory.velocities_.resize(num_steps, n);
+        trajectory.append_quintic(0,
+                                  start,
+                                  goal,
+                                  start_velocity,
+                                  goal_velocity,
+                                  start_acceleration,
+                                  goal_acceleration,
+                                  num_steps,
+                                  step_duration_s);
+
+        return trajectory;
+    }
+
+    /**
+     * @brief Minimum jerk trajectory from start to goal.
+     *
+     * Quintic polynomial with zero velocity and acceleration at start and
+     * goal.
+     *
+     * @param start  Start position.
+     * @param goal  Goal position.
+     * @param num_steps  Number of steps of the trajectory.
+     * @param step_duration_s  Duration of one step [s].
+     */
+    static Trajectory min_jerk(const Vector &start,
+                               const Vector &goal,
+                               const uint32_t num_steps,
+                               const double step_duration_s)
+    {
+        const Vector zero = Vector::Zero(start.size());
+        return quintic(
+            start, goal, zero, zero, zero, zero, num_steps, step_duration_s);
+    }
+
+    /**
+     * @brief Normalised minimum jerk profile going from 0 to 1.
+     *
+     * One-dimensional minimum jerk trajectory which can be scaled to the
+     * actual start and goal once they are known (`start + (goal - start) *
+     * profile`).
+     *
+     * @param num_steps  Number of steps of the trajectory.
+     * @param step_duration_s  Duration of one step [s].
+     */
+    static Trajectory min_jerk_profile(const uint32_t num_steps,
+                                       const double step_duration_s = 1.0)
+    {
+        return min_jerk(
+            Vector::Zero(1), Vector::Ones(1), num_steps, step_duration_s);
+    }
+
+    /**
+     * @brief Spline through multiple waypoints.
+     *
+     * Consecutive waypoints are connected by quintic polynomials.  The
+     * velocity at inner waypoints is the mean of the average velocities of the
+     * adjacent segments, the velocity at the first and last waypoint as well
+     * as the acceleration at all waypoints are zero.  This way the trajectory
+     * passes through the waypoints without stopping.
+     *
+     * @param waypoints  Waypoints, including start and goal.
+     * @param segment_steps  Number of steps from one waypoint to the next (one
+     *     entry less than waypoints).
+     * @param step_duration_s  Duration of one step [s].
+     * @throws std::invalid_argument if there are less than two waypoints, the
+     *     number of segments does not match, a segment has zero steps or the
+     *     waypoints have different sizes.
+     */
+    static Trajectory spline(const std::vector<Vector> &waypoints,
+                             const std::vector<uint32_t> &segment_steps,
+                             const double step_duration_s)
+    {
+        if (waypoints.size() < 2)
+        {
+            throw std::invalid_argument("Need at least two waypoints.");
+        }
+        if (segment_steps.size() != waypoints.size() - 1)
+        {
+            throw std::invalid_argument(
+                "Number of segments does not match number of waypoints.");
+        }
+
+        const Eigen::Index n = waypoints[0].size();
+        Eigen::Index total_steps = 0;
+        for (size_t i = 0; i < segment_steps.size(); i++)
+        {
+            if (segment_steps[i] == 0)
+            {
+                throw std::invalid_argument("Segments must not be empty.");
+            }
+            if (waypoints[i + 1].size() != n)
+            {
+                throw std::invalid_argument(
+                    "Sizes of the waypoints do not match.");
+            }
+            total_steps += segment_steps[i];
+        }
+
+        // velocities at the waypoints
+        std::vector<Vector> velocities(waypoints.size(), Vector::Zero(n));
+        for (size_t i = 1; i < waypoints.size() - 1; i++)
+        {
+            const double duration_before =
+                segment_steps[i - 1] * step_duration_s;
+            const double duration_after = segment_steps[i] * step_duration_s;
+            velocities[i] =
+                0.5 * ((waypoints[i] - waypoints[i - 1]) / duration_before +
+                       (waypoints[i + 1] - waypoints[i]) / duration_after);
+        }
+
+        const Vector zero = Vector::Zero(n);
+        Trajectory trajectory;
+        trajectory.positions_.resize(total_steps, n);
+        trajectory.velocities_.resize(total_steps, n);
+        Eigen::Index offset = 0;
+        for (size_t i = 0; i < segment_steps.size(); i++)
+        {
+            trajectory.append_quintic(offset,
+                                      waypoints[i],
+                                      waypoints[i + 1],
+                                      velocities[i],
+                                      velocities[i + 1],
+                                      zero,
+                                      zero,
+                                      segment_steps[i],
+                                      step_duration_s);
+            offset += segment_steps[i];
+        }
+
+        return trajectory;
+    }
+
+    //! @brief Number of steps.
+    Eigen::Index size() const
+    {
+        return positions_.rows();
+    }
+
+    //! @brief Number of degrees of freedom (e.g. joints).
+    Eigen::Index num_dofs() const
+    {
+        return positions_.cols();
+    }
+
+    //! @brief Positions of all steps (one row per step).
+    const Buffer &positions() const
+    {
+        return positions_;
+    }
+
+    //! @brief Velocities of all steps (one row per step).
+    const Buffer &velocities() const
+    {
+        return velocities_;
+    }
+
+    //! @brief Position at the given step.
+    Eigen::Map<const Eigen::RowVectorXd> position(const Eigen::Index step) const
+    {
+        return Eigen::Map<const Eigen::RowVectorXd>(
+            positions_.data() + step * positions_.cols(), positions_.cols());
+    }
+
+    //! @brief Velocity at the given step.
+    Eigen::Map<const Eigen::RowVectorXd> velocity(const Eigen::Index step) const
+    {
+        return Eigen::Map<const Eigen::RowVectorXd>(
+            velocities_.data() + step * velocities_.cols(), velocities_.cols());
+    }
+
+private:
+    Buffer positions_;
+    Buffer velocities_;
+
+    /**
+     * @brief Write a quintic segment to the buffers, starting at the given row.
+     *
+     * Uses the polynomial in normalised time tau in [0, 1], with velocities
+     * and accelerations scaled by the duration of the segment.
+     */
+    void append_quintic(const Eigen::Index offset,
+                        const Vector &p0,
+                        const Vector &p1,
+                        const Vector &v0,
+                        const Vector &v1,
+                        const Vector &a0,
+                        const Vector &a1,
+                        const uint32_t num_steps,
+                        const double step_duration_s)
+    {
+        const double duration = num_steps * step_duration_s;
+        const Vector d = p1 - p0;
+        const Vector V0 = v0 * duration;
+        const Vector V1 = v1 * duration;
+        const Vector A0 = a0 * duration * duration;
+        const Vector A1 = a1 * duration * duration;
+
+        const Vector c0 = p0;
+        const Vector c1 = V0;
+        const Vector c2 = 0.5 * A0;
+        const Vector c3 = 10.0 * d - 6.0 * V0 - 4.0 * V1 - 1.5 * A0 + 0.5 * A1;
+        const Vector c4 = -15.0 * d + 8.0 * V0 + 7.0 * V1 + 1.5 * A0 - A1;
+        const Vector c5 = 6.0 * d - 3.0 * V0 - 3.0 * V1 - 0.5 * A0 + 0.5 * A1;
+
+        for (uint32_t t = 0; t < num_steps; t++)
+        {
+            const double tau = static_cast<double>(t + 1) / num_steps;
+
+            // evaluate polynomial and its derivative in Horner form
+            positions_.row(offset + t) =
+                (c0 +
+                 tau * (c1 + tau * (c2 + tau * (c3 + tau * (c4 + tau * c5)))))
+                    .transpose();
+            velocities_.row(offset + t) =
+                ((c1 + tau * (2.0 * c2 +
+                              tau * (3.0 * c3 +
+                                     tau * (4.0 * c4 + tau * 5.0 * c5)))) /
+                 duration)
+                    .transpose();
+        }
+    }
+};
+
+}  // namespace robot_fingers
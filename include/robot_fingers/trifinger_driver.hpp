@@ -15,7 +15,10 @@ class TriFingerDriver : public NFingerDriver<3>
 {
 public:
     TriFingerDriver(const Config &config)
-        : TriFingerDriver(create_motor_boards(config.can_ports), config)
+        : TriFingerDriver(
+              create_motor_boards(config.can_ports,
+                                  config.motor_board_ready_timeout_s),
+              config)
     {
     }
 
@@ -25,15 +28,16 @@ private:
 // the warning until then).
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
-    TriFingerDriver(const MotorBoards &motor_boards, const Config &config)
-        : NFingerDriver<3>(motor_boards,
-                           create_motors(motor_boards),
+    TriFingerDriver(const MotorBoardSetup &boards, const Config &config)
+        : NFingerDriver<3>(boards.boards,
+                           create_motors(boards.boards),
                            {
                                // MotorParameters
                                .torque_constant_NmpA = 0.02,
                                .gear_ratio = 9.0,
                            },
-                           config)
+                           config,
+                           boards.bring_up_s)
     {
     }
 #pragma GCC diagnostic pop
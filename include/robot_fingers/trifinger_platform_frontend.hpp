@@ -6,11 +6,23 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <Eigen/Eigen>
 #include <robot_interfaces/finger_types.hpp>
 #include <robot_interfaces/sensors/sensor_frontend.hpp>
 #include <trifinger_cameras/tricamera_observation.hpp>
 #include <trifinger_object_tracking/tricamera_object_observation.hpp>
 
+#include "append_desired_actions.hpp"
+#include "object_pose_publisher.hpp"
+#include "time_index_matcher.hpp"
+
 namespace robot_fingers
 {
 /**
@@ -39,6 +51,40 @@ public:
     //    CameraObservation;
     typedef CameraObservation_t CameraObservation;
 
+    /**
+     * @brief Values of a range of time steps, one row per step.
+     *
+     * Row-major, so the values of one time step are contiguous in memory.
+     */
+    template <int N>
+    using Block = Eigen::Matrix<double, Eigen::Dynamic, N, Eigen::RowMajor>;
+
+    //! @brief Robot observations of a range of time steps.
+    struct RobotObservationBlock
+    {
+        Block<9> position;
+        Block<9> velocity;
+        Block<9> torque;
+        Block<3> tip_force;
+    };
+
+    //! @brief Robot actions of a range of time steps.
+    struct ActionBlock
+    {
+        Block<9> torque;
+        Block<9> position;
+        Block<9> position_kp;
+        Block<9> position_kd;
+    };
+
+    //! @brief Robot status of a range of time steps.
+    struct RobotStatusBlock
+    {
+        Eigen::Matrix<uint32_t, Eigen::Dynamic, 1> action_repetitions;
+        //! @brief Values of robot_interfaces::Status::ErrorStatus.
+        Eigen::Matrix<int32_t, Eigen::Dynamic, 1> error_status;
+    };
+
     /**
      * @brief Initialize with data instances for all internal frontends.
      *
@@ -46,12 +92,17 @@ public:
      * @param object_tracker_data ObjectTrackerData instance used by the object
      *     tracker frontend.
      * @param camera_data SensorData instance, used by the camera frontend.
+     * @param object_pose_data  Object poses published by an
+     *     ObjectPosePublisher (optional, only needed for get_object_pose()).
      */
     T_TriFingerPlatformFrontend(
         robot_interfaces::TriFingerTypes::BaseDataPtr robot_data,
         std::shared_ptr<robot_interfaces::SensorData<CameraObservation>>
-            camera_data)
-        : robot_frontend_(robot_data), camera_frontend_(camera_data)
+            camera_data,
+        std::shared_ptr<ObjectPoseData> object_pose_data = nullptr)
+        : robot_frontend_(robot_data),
+          camera_frontend_(camera_data),
+          object_pose_data_(object_pose_data)
     {
     }
 
@@ -60,7 +111,8 @@ public:
      *
      * Creates for each internal frontend a corresponding mutli-process data
      * instance with the default shared memory ID for the corresponding data
-     * type.
+     * type.  With object tracking, it also connects to the object pose data
+     * if the backend publishes it.
      */
     T_TriFingerPlatformFrontend()
         : robot_frontend_(std::make_shared<
@@ -69,7 +121,8 @@ public:
           camera_frontend_(
               std::make_shared<
                   robot_interfaces::MultiProcessSensorData<CameraObservation>>(
-                  "tricamera", false))
+                  "tricamera", false)),
+          object_pose_data_(connect_object_pose_data())
 
     {
     }
@@ -86,6 +139,30 @@ public:
         return robot_frontend_.append_desired_action(desired_action);
     }
 
+    /**
+     * @brief Append a batch of desired robot actions to the action queue.
+     *
+     * Fields of desired_actions with zero rows are set to their default
+     * value.  All actions are validated before the first one is appended.
+     * The batch must not be longer than the history of the robot data, as
+     * actions are dropped from it before being executed otherwise.
+     *
+     * @see robot_fingers::append_desired_actions
+     *
+     * @param desired_actions  The actions, one row per time step.
+     *
+     * @return Range [t_begin, t_end) of the time steps at which the actions
+     *     are going to be executed.
+     * @throws std::invalid_argument if the batch is empty or the fields have
+     *     different numbers of rows.
+     */
+    std::pair<time_series::Index, time_series::Index> append_desired_actions(
+        const ActionBlock &desired_actions)
+    {
+        return robot_fingers::append_desired_actions<Action>(robot_frontend_,
+                                                             desired_actions);
+    }
+
     /**
      * @brief Get robot observation of the time step t.
      * @see robot_interfaces::TriFingerTypes::Frontend::get_observation
@@ -131,6 +208,112 @@ public:
         return robot_frontend_.get_timestamp_ms(t);
     }
 
+    /**
+     * @brief Get robot observations of the time steps [t_begin, t_end).
+     *
+     * Same as calling get_robot_observation() for each step but the result
+     * is returned as one contiguous block per field.  This is much faster
+     * when called from Python, as the interpreter boundary is crossed only
+     * once.
+     *
+     * If t_end - 1 is in the future, this method will block and wait.
+     *
+     * @throws std::invalid_argument if t_end < t_begin.
+     */
+    RobotObservationBlock get_robot_observations(
+        const time_series::Index t_begin, const time_series::Index t_end) const
+    {
+        const Eigen::Index n = get_range_size(t_begin, t_end);
+
+        RobotObservationBlock block;
+        block.position.resize(n, Eigen::NoChange);
+        block.velocity.resize(n, Eigen::NoChange);
+        block.torque.resize(n, Eigen::NoChange);
+        block.tip_force.resize(n, Eigen::NoChange);
+
+        for (Eigen::Index i = 0; i < n; i++)
+        {
+            const RobotObservation observation =
+                robot_frontend_.get_observation(t_begin + i);
+            block.position.row(i) = observation.position.transpose();
+            block.velocity.row(i) = observation.velocity.transpose();
+            block.torque.row(i) = observation.torque.transpose();
+            block.tip_force.row(i) = observation.tip_force.transpose();
+        }
+
+        return block;
+    }
+
+    /**
+     * @brief Get desired actions of the time steps [t_begin, t_end).
+     * @see get_robot_observations
+     */
+    ActionBlock get_desired_actions(const time_series::Index t_begin,
+                                    const time_series::Index t_end) const
+    {
+        return get_action_block(t_begin, t_end, [this](time_series::Index t) {
+            return robot_frontend_.get_desired_action(t);
+        });
+    }
+
+    /**
+     * @brief Get actually applied actions of the time steps [t_begin, t_end).
+     * @see get_robot_observations
+     */
+    ActionBlock get_applied_actions(const time_series::Index t_begin,
+                                    const time_series::Index t_end) const
+    {
+        return get_action_block(t_begin, t_end, [this](time_series::Index t) {
+            return robot_frontend_.get_applied_action(t);
+        });
+    }
+
+    /**
+     * @brief Get robot status of the time steps [t_begin, t_end).
+     *
+     * Error messages are not included, use get_robot_status() for steps with
+     * an error.
+     *
+     * @see get_robot_observations
+     */
+    RobotStatusBlock get_robot_statuses(const time_series::Index t_begin,
+                                        const time_series::Index t_end) const
+    {
+        const Eigen::Index n = get_range_size(t_begin, t_end);
+
+        RobotStatusBlock block;
+        block.action_repetitions.resize(n);
+        block.error_status.resize(n);
+
+        for (Eigen::Index i = 0; i < n; i++)
+        {
+            const RobotStatus status = robot_frontend_.get_status(t_begin + i);
+            block.action_repetitions[i] = status.action_repetitions;
+            block.error_status[i] = static_cast<int32_t>(status.error_status);
+        }
+
+        return block;
+    }
+
+    /**
+     * @brief Get timestamps (in milliseconds) of the time steps [t_begin,
+     *        t_end).
+     * @see get_robot_observations
+     */
+    Eigen::VectorXd get_timestamps_ms(const time_series::Index t_begin,
+                                      const time_series::Index t_end) const
+    {
+        const Eigen::Index n = get_range_size(t_begin, t_end);
+
+        Eigen::VectorXd timestamps(n);
+        for (Eigen::Index i = 0; i < n; i++)
+        {
+            timestamps[i] = robot_frontend_.get_timestamp_ms(t_begin + i);
+        }
+
+        return timestamps;
+    }
+
     /**
      * @brief Get the current time index.
      * @see robot_interfaces::TriFingerTypes::Frontend::get_current_timeindex
@@ -159,14 +342,147 @@ public:
      */
     CameraObservation get_camera_observation(const time_series::Index t) const
     {
-        auto t_camera = find_matching_timeindex(camera_frontend_, t);
+        auto t_camera =
+            find_matching_timeindex(camera_frontend_, camera_index_matcher_, t);
         return camera_frontend_.get_observation(t_camera);
     }
 
+    /**
+     * @brief Get object pose of time step t.
+     *
+     * Matches t to the camera observations in the same way as
+     * get_camera_observation() but reads the object pose from the separate
+     * object pose time series (see ObjectPosePublisher), so the images are
+     * not copied.
+     *
+     * @param t  Time index of the robot time series.
+     *
+     * @return Object pose of the camera observation of time step t.
+     * @throws std::runtime_error if no object pose data is available.
+     * @throws std::out_of_range if the matching pose is not available (not
+     *     published yet or already dropped from the buffer).
+     */
+    ObjectPoseObservation get_object_pose(const time_series::Index t) const
+    {
+        if (!object_pose_data_)
+        {
+            throw std::runtime_error(
+                "No object pose data available.  Is the backend running with "
+                "object tracking?");
+        }
+        auto &poses = *object_pose_data_->observation;
+
+        const time_series::Timestamp stamp_robot = get_timestamp_ms(t);
+        const time_series::Index t_pose = object_pose_index_matcher_.find(
+            stamp_robot,
+            poses.newest_timeindex(false),
+            [&poses](time_series::Index i, time_series::Timestamp *stamp) {
+                try
+                {
+                    *stamp = poses[i].camera_timestamp_ms;
+                }
+                catch (const std::invalid_argument &)
+                {
+                    return false;
+                }
+                return true;
+            });
+
+        return poses[t_pose];
+    }
+
+    /**
+     * @brief Get camera images of time step t with shared ownership.
+     *
+     * Same as get_camera_observation() but the observation is returned as
+     * shared pointer, so it can be passed on (e.g. to multiple consumers or
+     * to Python, see `get_camera_images` of the Python bindings) without
+     * copying it.
+     *
+     * @param t  Time index of the robot time series.
+     *
+     * @return Camera images of time step t.
+     */
+    std::shared_ptr<const CameraObservation> get_camera_observation_ptr(
+        const time_series::Index t) const
+    {
+        return std::make_shared<const CameraObservation>(
+            get_camera_observation(t));
+    }
+
 private:
     robot_interfaces::TriFingerTypes::Frontend robot_frontend_;
     robot_interfaces::SensorFrontend<CameraObservation> camera_frontend_;
 
+    //! @brief Remembers the last match of a robot to a camera time index.
+    mutable TimeIndexMatcher camera_index_matcher_;
+
+    std::shared_ptr<ObjectPoseData> object_pose_data_;
+    mutable TimeIndexMatcher object_pose_index_matcher_;
+
+    /**
+     * @brief Connect to the object pose data of the backend, if there is one.
+     *
+     * @return The data or nullptr if not using object tracking or if the
+     *     backend does not publish object poses.
+     */
+    static std::shared_ptr<ObjectPoseData> connect_object_pose_data()
+    {
+        if (!std::is_same<CameraObservation,
+                          trifinger_object_tracking::
+                              TriCameraObjectObservation>::value)
+        {
+            return nullptr;
+        }
+
+        try
+        {
+            return std::make_shared<MultiProcessObjectPoseData>(
+                ObjectPosePublisher::DEFAULT_SHARED_MEMORY_ID, false);
+        }
+        catch (const std::exception &)
+        {
+            return nullptr;
+        }
+    }
+
+    static Eigen::Index get_range_size(const time_series::Index t_begin,
+                                       const time_series::Index t_end)
+    {
+        if (t_end < t_begin)
+        {
+            throw std::invalid_argument(
+                "Invalid range: t_end (" + std::to_string(t_end) +
+                ") is before t_begin (" + std::to_string(t_begin) + ").");
+        }
+        return static_cast<Eigen::Index>(t_end - t_begin);
+    }
+
+    template <typename GetAction>
+    ActionBlock get_action_block(const time_series::Index t_begin,
+                                 const time_series::Index t_end,
+                                 GetAction get_action) const
+    {
+        const Eigen::Index n = get_range_size(t_begin, t_end);
+
+        ActionBlock block;
+        block.torque.resize(n, Eigen::NoChange);
+        block.position.resize(n, Eigen::NoChange);
+        block.position_kp.resize(n, Eigen::NoChange);
+        block.position_kd.resize(n, Eigen::NoChange);
+
+        for (Eigen::Index i = 0; i < n; i++)
+        {
+            const Action action = get_action(t_begin + i);
+            block.torque.row(i) = action.torque.transpose();
+            block.position.row(i) = action.position.transpose();
+            block.position_kp.row(i) = action.position_kp.transpose();
+            block.position_kd.row(i) = action.position_kd.transpose();
+        }
+
+        return block;
+    }
+
     /**
      * @brief Find time index of frontend that matches with the given robot time
      *        index.
@@ -186,52 +502,49 @@ private:
      * called twice with the same `t_robot` if a new "other" observation
      * arrived in between the calls.
      *
-     * @todo The implementation below is very naive.
-     *       It simply does a linear search starting from the latest time index.
-     *       So worst case performance is O(n) where n is the number of "other"
-     *       observations over the period that is covered by the buffer of the
-     *       robot data.
-     *
-     *       Options to speed this up:
-     *        - binary search (?)
-     *        - estimate time step size based on last observations
-     *        - store matched indices of last call
-     *
-     *       Note, however, that `t_robot` is very likely the latest time index
-     *       in most cases.  In this case the match for `t_other` will also be
-     *       the latest index of the corresponding time series.  In this case,
-     *       the complexity is O(1).  So even when implementing a more complex
-     *       search algorithm, the first candidate for `t_other` that is checked
-     *       should always be the latest one.
+     * `t_robot` is very likely the latest time index in most cases, so the
+     * latest index of the other frontend is checked first.  Otherwise the
+     * search continues from the match of the previous call (see @ref
+     * TimeIndexMatcher), so reading through the history needs only few
+     * timestamp lookups per step.
      *
      * @tparam FrontendType Type of the frontend.  This is templated so that the
      *     same implementation can be used for both camera and object tracker
      *     frontend.
      * @param other_frontend The frontend for which a matching time index needs
      *     to be found.
+     * @param matcher  Matcher holding the previous match of other_frontend.
      * @param t_robot Time index of the robot frontend.
      *
      * @return Time index for other_frontend which is/was active at the time of
      *     t_robot.
+     * @throws std::out_of_range if the matching observation of other_frontend
+     *     is not available anymore.
      */
     template <typename FrontendType>
     time_series::Index find_matching_timeindex(
         const FrontendType &other_frontend,
+        TimeIndexMatcher &matcher,
         const time_series::Index t_robot) const
     {
         time_series::Timestamp stamp_robot = get_timestamp_ms(t_robot);
 
-        time_series::Index t_other = other_frontend.get_current_timeindex();
-        time_series::Timestamp stamp_other =
-            other_frontend.get_timestamp_ms(t_other);
-
-        while (stamp_robot < stamp_other)
-        {
-            t_other--;
-            stamp_other = other_frontend.get_timestamp_ms(t_other);
-        }
-
-        return t_other;
+        return matcher.find(
+            stamp_robot,
+            other_frontend.get_current_timeindex(),
+            [&other_frontend](time_series::Index t,
+                              time_series::Timestamp *stamp) {
+                // entries that were already dropped from the buffer
+                try
+                {
+                    *stamp = other_frontend.get_timestamp_ms(t);
+                }
+                catch (const std::invalid_argument &)
+                {
+                    return false;
+                }
+                return true;
+            });
     }
 };
 
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @brief Lock-free hand-over of values from one thread to another.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace robot_fingers
+{
+/**
+ * @brief Passes the latest value from a writer to a reader thread.
+ *
+ * Triple buffering: The writer and the reader each own one buffer, the third
+ * one holds the latest published value.  Publishing and taking over a value
+ * only swaps buffer indices with a single atomic exchange, so neither side ever
+ * waits for the other, locks or allocates memory (as long as copying T does
+ * not allocate).  The reader always sees a complete value, intermediate values
+ * are dropped if the writer publishes faster than the reader updates.
+ *
+ * There must be at most one writer and one reader at a time.
+ *
+ * @tparam T  Type of the values.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    //! @param initial_value  Value that is read until the first update.
+    explicit TripleBuffer(const T &initial_value)
+    {
+        buffers_.fill(initial_value);
+    }
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    /**
+     * @brief Publish a new value (writer side).
+     *
+     * The value is taken over by the reader with its next call of @ref
+     * update.
+     */
+    void write(const T &value)
+    {
+        buffers_[back_] = value;
+        back_ = exchange_middle(back_ | NEW_VALUE_FLAG);
+    }
+
+    /**
+     * @brief Take over the latest published value, if any (reader side).
+     *
+     * @return True if a new value was published since the last update.
+     */
+    bool update()
+    {
+        if (!(middle_.load(std::memory_order_relaxed) & NEW_VALUE_FLAG))
+        {
+            return false;
+        }
+        front_ = exchange_middle(front_);
+        return true;
+    }
+
+    /**
+     * @brief Current value of the reader (reader side).
+     *
+     * Only changes with @ref update.
+     */
+    const T &read() const
+    {
+        return buffers_[front_];
+    }
+
+private:
+    //! @brief Set in the middle index if it holds a value not yet read.
+    static constexpr uint8_t NEW_VALUE_FLAG = 0x4;
+    static constexpr uint8_t INDEX_MASK = 0x3;
+
+    std::array<T, 3> buffers_;
+    //! @brief Buffer of the reader.
+    uint8_t front_ = 0;
+    //! @brief Buffer holding the latest published value (plus flag).
+    std::atomic<uint8_t> middle_ = {1};
+    //! @brief Buffer of the writer.
+    uint8_t back_ = 2;
+
+    //! @brief Swap the middle buffer and return the index of the old one.
+    uint8_t exchange_middle(uint8_t index)
+    {
+        // acq_rel, so the content of the buffers is passed on with the index
+        return middle_.exchange(index, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+};
+
+}  // namespace robot_fingers
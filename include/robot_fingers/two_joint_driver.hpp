@@ -20,7 +20,10 @@ class TwoJointDriver : public SimpleNJointBlmcRobotDriver<2, 1>
 {
 public:
     TwoJointDriver(const Config &config)
-        : TwoJointDriver(create_motor_boards(config.can_ports), config)
+        : TwoJointDriver(
+              create_motor_boards(config.can_ports,
+                                  config.motor_board_ready_timeout_s),
+              config)
     {
     }
 
@@ -30,15 +33,16 @@ private:
 // the warning until then).
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
-    TwoJointDriver(const MotorBoards &motor_boards, const Config &config)
-        : SimpleNJointBlmcRobotDriver<2, 1>(motor_boards,
-                                            create_motors(motor_boards),
+    TwoJointDriver(const MotorBoardSetup &boards, const Config &config)
+        : SimpleNJointBlmcRobotDriver<2, 1>(boards.boards,
+                                            create_motors(boards.boards),
                                             {
                                                 // MotorParameters
                                                 .torque_constant_NmpA = 0.02,
                                                 .gear_ratio = 9.0,
                                             },
-                                            config)
+                                            config,
+                                            boards.bring_up_s)
     {
     }
 #pragma GCC diagnostic pop
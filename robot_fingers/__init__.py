@@ -3,19 +3,48 @@ from . import utils
 from .py_real_finger import (
     create_real_finger_backend,
     create_fake_finger_backend,
+    process_real_finger_action_batch,
+    append_real_finger_desired_actions,
     FingerConfig,
+    RealFingerDriver,
 )
 from .py_trifinger import (
     create_trifinger_backend,
+    process_trifinger_action_batch,
+    append_trifinger_desired_actions,
     TriFingerConfig,
+    TriFingerDriver,
     TriFingerPlatformFrontend,
     TriFingerPlatformWithObjectFrontend,
     TriFingerPlatformLog,
     TriFingerPlatformWithObjectLog,
+    ObjectPoseObservation,
+    SingleProcessObjectPoseData,
+    MultiProcessObjectPoseData,
+    ObjectPosePublisher,
 )
-from .py_one_joint import create_one_joint_backend, OneJointConfig
-from .py_two_joint import create_two_joint_backend, TwoJointConfig
-from .py_solo_eight import create_solo_eight_backend, SoloEightConfig
+from .py_one_joint import (
+    create_one_joint_backend,
+    process_one_joint_action_batch,
+    append_one_joint_desired_actions,
+    OneJointConfig,
+    OneJointDriver,
+)
+from .py_two_joint import (
+    create_two_joint_backend,
+    process_two_joint_action_batch,
+    append_two_joint_desired_actions,
+    TwoJointConfig,
+    TwoJointDriver,
+)
+from .py_solo_eight import (
+    create_solo_eight_backend,
+    process_solo_eight_action_batch,
+    append_solo_eight_desired_actions,
+    SoloEightConfig,
+    SoloEightDriver,
+)
+from .py_trajectory import Trajectory, min_jerk_phase
 
 from .robot import Robot, demo_print_position
 
@@ -24,19 +53,40 @@ __all__ = (
     "utils",
     "create_real_finger_backend",
     "create_fake_finger_backend",
+    "process_real_finger_action_batch",
+    "append_real_finger_desired_actions",
     "FingerConfig",
+    "RealFingerDriver",
     "create_trifinger_backend",
+    "process_trifinger_action_batch",
+    "append_trifinger_desired_actions",
     "TriFingerConfig",
+    "TriFingerDriver",
     "TriFingerPlatformFrontend",
     "TriFingerPlatformWithObjectFrontend",
     "TriFingerPlatformLog",
     "TriFingerPlatformWithObjectLog",
+    "ObjectPoseObservation",
+    "SingleProcessObjectPoseData",
+    "MultiProcessObjectPoseData",
+    "ObjectPosePublisher",
     "create_one_joint_backend",
+    "process_one_joint_action_batch",
+    "append_one_joint_desired_actions",
     "OneJointConfig",
+    "OneJointDriver",
     "create_two_joint_backend",
+    "process_two_joint_action_batch",
+    "append_two_joint_desired_actions",
     "TwoJointConfig",
+    "TwoJointDriver",
     "create_solo_eight_backend",
+    "process_solo_eight_action_batch",
+    "append_solo_eight_desired_actions",
     "SoloEightConfig",
+    "SoloEightDriver",
+    "Trajectory",
+    "min_jerk_phase",
     "Robot",
     "demo_print_position",
 )
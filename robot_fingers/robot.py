@@ -3,6 +3,7 @@ import json
 import os
 import pathlib
 import types
+import typing
 
 import yaml
 from ament_index_python.packages import get_package_share_directory
@@ -77,6 +78,18 @@ robot_configs = {
 }
 
 
+#: Functions to append a batch of actions to the frontend of a robot module.
+append_desired_actions_functions = {
+    robot_interfaces.finger: robot_fingers.append_real_finger_desired_actions,
+    robot_interfaces.trifinger: robot_fingers.append_trifinger_desired_actions,
+    robot_interfaces.one_joint: robot_fingers.append_one_joint_desired_actions,
+    robot_interfaces.two_joint: robot_fingers.append_two_joint_desired_actions,
+    robot_interfaces.solo_eight: (
+        robot_fingers.append_solo_eight_desired_actions
+    ),
+}
+
+
 def get_config_dir() -> pathlib.PurePath:
     """Get path to the configuration directory."""
     return pathlib.PurePath(
@@ -132,6 +145,9 @@ class Robot:
         """
         # convenience mapping of the Action type
         self.Action = robot_module.Action
+        self._append_desired_actions = append_desired_actions_functions.get(
+            robot_module
+        )
 
         try:
             config = os.fspath(get_config_dir() / config)
@@ -176,6 +192,22 @@ class Robot:
         # Initializes the robot (e.g. performs homing).
         self.backend.initialize()
 
+    def append_desired_actions(self, **fields) -> typing.Tuple[int, int]:
+        """Append a batch of desired actions to the frontend.
+
+        See :func:`append_trifinger_desired_actions` for the arguments (the
+        same function exists for all robots).
+
+        Returns:
+            Range (t_begin, t_end) of the time steps at which the actions will
+            be applied.
+        """
+        if self._append_desired_actions is None:
+            raise NotImplementedError(
+                "append_desired_actions is not supported for this robot."
+            )
+        return self._append_desired_actions(self.frontend, **fields)
+
 
 def demo_print_position(robot):
     """Send zero-torque commands to the robot and print the joint positions.
@@ -7,46 +7,33 @@ import progressbar
 import numpy as np
 from scipy.spatial.transform import Rotation
 
+import robot_fingers
 import trifinger_simulation
 
 
 def min_jerk_trajectory(current, setpoint, frequency, avg_speed):
     """Compute minimum jerk trajectory.
 
-    Based on [Mika's tech blog](https://mika-s.github.io/python/control-theory/trajectory-generation/2017/12/06/trajectory-generation-with-a-minimum-jerk-trajectory.html)  # noqa
-    License: CC BY-SA 3.0
-    """
-    trajectory = []
-    trajectory_derivative = []
+    Args:
+        current: Start position.
+        setpoint: Goal position.
+        frequency: Control rate [Hz].
+        avg_speed: Average speed [distance per step].
 
+    Returns:
+        Tuple of arrays (positions, velocities) with one row per step.  The
+        last step is the setpoint.
+    """
     num_steps = np.linalg.norm(current - setpoint) / avg_speed
     move_time = num_steps / frequency
 
     timefreq = int(move_time * frequency)
 
-    for t in range(1, timefreq):
-        trajectory.append(
-            current
-            + (setpoint - current)
-            * (
-                10.0 * (t / timefreq) ** 3
-                - 15.0 * (t / timefreq) ** 4
-                + 6.0 * (t / timefreq) ** 5
-            )
-        )
-
-        trajectory_derivative.append(
-            frequency
-            * (1.0 / timefreq)
-            * (setpoint - current)
-            * (
-                30.0 * (t / timefreq) ** 2.0
-                - 60.0 * (t / timefreq) ** 3.0
-                + 30.0 * (t / timefreq) ** 4.0
-            )
-        )
+    trajectory = robot_fingers.Trajectory.min_jerk(
+        current, setpoint, timefreq, 1.0 / frequency
+    )
 
-    return trajectory, trajectory_derivative
+    return trajectory.positions, trajectory.velocities
 
 
 def compute_single_swipe_trajectory(
@@ -140,7 +127,9 @@ def connect_swipes(initial_position, swipes, jump_speed_mps, rate_hz=1000):
         jump_traj, _ = min_jerk_trajectory(
             start, swipe[0], rate_hz, jump_speed_m_per_step
         )
-        connected_swipes.append(jump_traj)
+        # the jump ends at swipe[0], so drop its last step to not have the
+        # same position twice
+        connected_swipes.append(jump_traj[:-1])
         connected_swipes.append(swipe)
 
         start = swipe[-1]
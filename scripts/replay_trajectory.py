@@ -2,6 +2,7 @@
 """Move the robot on the trajectory of a previously recorded log file."""
 import argparse
 
+import numpy as np
 import pandas
 
 import robot_fingers
@@ -45,14 +46,16 @@ def main():
     # executed once (= original speed), at speed < 1, positions are repeated
     # (slower playback), at speed > 1, some positions are skipped (faster
     # playback).
-    step = 0
-    while int(step) < num_positions:
-        position = positions[int(step)]
-        step += args.speed
-
-        action = robot.Action(position=position)
-        t = robot.frontend.append_desired_action(action)
-        robot.frontend.wait_until_timeindex(t)
+    steps = np.arange(0, num_positions, args.speed).astype(int)
+    positions = positions[steps]
+
+    # send the positions in chunks, so they fit into the action time series
+    chunk_size = 100
+    for i in range(0, len(positions), chunk_size):
+        _, t_end = robot.append_desired_actions(
+            position=positions[i : i + chunk_size]
+        )
+        robot.frontend.wait_until_timeindex(t_end - 1)
 
 
 if __name__ == "__main__":
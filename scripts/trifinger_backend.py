@@ -145,6 +145,19 @@ def main():
         camera_driver = CameraDriver("camera60", "camera180", "camera300")
         camera_backend = tricamera.Backend(camera_driver, camera_data)
 
+        if args.cameras_with_tracker:
+            # Separate time series with only the object pose, so frontends
+            # can get it without copying the images.  It is small, so it can
+            # cover a much longer time than the camera time series.
+            OBJECT_POSE_TIME_SERIES_LENGTH = 1000
+
+            object_pose_data = robot_fingers.MultiProcessObjectPoseData(
+                "object_pose", True, OBJECT_POSE_TIME_SERIES_LENGTH
+            )
+            object_pose_publisher = robot_fingers.ObjectPosePublisher(
+                camera_data, object_pose_data
+            )
+
         logging.info("Camera backend ready.")
 
     logging.info("Start robot backend")
@@ -205,6 +218,9 @@ def main():
     logging.debug("Backend termination reason: %d", termination_reason)
 
     if cameras_enabled:
+        if args.cameras_with_tracker:
+            # stop the publisher thread before the camera backend
+            del object_pose_publisher
         camera_backend.shutdown()
 
     # delete the ready indicator file to indicate that the backend has shut
@@ -299,10 +299,13 @@ def reset_object(robot, trajectory_file):
     # extract the positions from the recorded data
     positions = data[data_keys].to_numpy()
 
-    for position in positions:
-        action = robot.Action(position=position)
-        t = robot.frontend.append_desired_action(action)
-        robot.frontend.wait_until_timeindex(t)
+    # send the positions in chunks, so they fit into the action time series
+    chunk_size = 100
+    for i in range(0, len(positions), chunk_size):
+        _, t_end = robot_fingers.append_trifinger_desired_actions(
+            robot.frontend, position=positions[i : i + chunk_size]
+        )
+        robot.frontend.wait_until_timeindex(t_end - 1)
 
 
 def record_camera_observations(
@@ -0,0 +1,143 @@
+/**
+ * @file
+ * @brief Benchmark of sending to multiple motor boards serially vs. parallel.
+ *
+ * Uses a loopback stand-in for the CAN boards: each fake board writes a
+ * CAN-sized frame to a local socket pair and then blocks for the time the
+ * frame would need on the bus (roughly 130 us for a frame with 8 data bytes at
+ * 1 Mbit/s, plus driver overhead).  The duration of the send phase is measured
+ * for different numbers of boards, once with the boards served one after the
+ * other on the calling thread (as `BlmcJointModules::send_torques()` does) and
+ * once using the ParallelBoardSender.
+ *
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <robot_fingers/parallel_board_sender.hpp>
+#include <robot_fingers/periodic_scheduler.hpp>
+
+using namespace robot_fingers;
+
+/**
+ * @brief Stand-in for a CAN motor board, writing to a local socket.
+ */
+class LoopbackBoard
+{
+public:
+    explicit LoopbackBoard(int64_t frame_time_ns) : frame_time_ns_(frame_time_ns)
+    {
+        if (socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets_) != 0)
+        {
+            throw std::runtime_error("Failed to create socket pair.");
+        }
+    }
+
+    ~LoopbackBoard()
+    {
+        close(sockets_[0]);
+        close(sockets_[1]);
+    }
+
+    void send_if_input_changed()
+    {
+        // same size as a CAN frame
+        std::array<uint8_t, 16> frame = {};
+        const int64_t start = get_monotonic_time_ns();
+        if (write(sockets_[0], frame.data(), frame.size()) < 0)
+        {
+            throw std::runtime_error("Failed to write frame.");
+        }
+
+        // block until the frame would be on the bus
+        timespec deadline;
+        const int64_t deadline_ns = start + frame_time_ns_;
+        deadline.tv_sec = deadline_ns / 1000000000;
+        deadline.tv_nsec = deadline_ns % 1000000000;
+        while (clock_nanosleep(
+                   CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+        {
+        }
+
+        // drain the other end, so the socket buffer does not fill up
+        read(sockets_[1], frame.data(), frame.size());
+    }
+
+private:
+    int64_t frame_time_ns_;
+    int sockets_[2];
+};
+
+struct Statistics
+{
+    double median_us;
+    double p99_us;
+};
+
+template <typename Send>
+Statistics measure(Send send, size_t num_iterations)
+{
+    std::vector<int64_t> durations(num_iterations);
+    for (size_t i = 0; i < num_iterations; i++)
+    {
+        const int64_t start = get_monotonic_time_ns();
+        send();
+        durations[i] = get_monotonic_time_ns() - start;
+    }
+
+    std::sort(durations.begin(), durations.end());
+    return {durations[num_iterations / 2] / 1e3,
+            durations[num_iterations * 99 / 100] / 1e3};
+}
+
+int main()
+{
+    constexpr int64_t FRAME_TIME_NS = 130000;
+    constexpr size_t NUM_ITERATIONS = 2000;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Duration of the send phase [us]\n"
+              << std::setw(8) << "boards" << std::setw(15) << "serial p50"
+              << std::setw(15) << "serial p99" << std::setw(15)
+              << "parallel p50" << std::setw(15) << "parallel p99"
+              << std::endl;
+
+    for (size_t num_boards : {1, 2, 3, 4, 6})
+    {
+        std::vector<std::shared_ptr<LoopbackBoard>> boards;
+        for (size_t i = 0; i < num_boards; i++)
+        {
+            boards.push_back(std::make_shared<LoopbackBoard>(FRAME_TIME_NS));
+        }
+
+        Statistics serial = measure(
+            [&]() {
+                for (auto &board : boards)
+                {
+                    board->send_if_input_changed();
+                }
+            },
+            NUM_ITERATIONS);
+
+        ParallelBoardSender<LoopbackBoard> sender(boards);
+        Statistics parallel =
+            measure([&]() { sender.send(); }, NUM_ITERATIONS);
+
+        std::cout << std::setw(8) << num_boards << std::setw(15)
+                  << serial.median_us << std::setw(15) << serial.p99_us
+                  << std::setw(15) << parallel.median_us << std::setw(15)
+                  << parallel.p99_us << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief Benchmark of NJointBlmcRobotDriver::process_desired_action.
+ *
+ * Measures the duration of one call for different numbers of joints.  That
+ * the results match the previous per-joint implementation is verified in
+ * test/test_process_action.cpp.
+ *
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <robot_fingers/n_joint_blmc_robot_driver.hpp>
+
+using namespace robot_fingers;
+
+/**
+ * @brief Random vector which also contains NaN and special values.
+ */
+template <typename Vector>
+Vector random_vector(std::mt19937 &rng, double nan_probability)
+{
+    std::uniform_real_distribution<double> value(-2.0, 2.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    Vector vec;
+    for (int i = 0; i < vec.size(); i++)
+    {
+        const double r = uniform(rng);
+        if (r < nan_probability)
+        {
+            vec[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+        else if (r < nan_probability + 0.02)
+        {
+            vec[i] = -0.0;
+        }
+        else
+        {
+            vec[i] = value(rng);
+        }
+    }
+
+    return vec;
+}
+
+/**
+ * @brief Run the benchmark for the given number of joints.
+ */
+template <size_t N_JOINTS>
+void run_benchmark(size_t num_samples, size_t num_repetitions, size_t num_rounds)
+{
+    typedef SimpleNJointBlmcRobotDriver<N_JOINTS> Driver;
+    typedef typename Driver::Action Action;
+    typedef typename Driver::Observation Observation;
+    typedef typename Driver::Vector Vector;
+
+    std::mt19937 rng(42);
+
+    std::vector<Action> actions;
+    std::vector<Observation> observations;
+    for (size_t i = 0; i < num_samples; i++)
+    {
+        // mix of torque, position and mixed actions
+        Action action(random_vector<Vector>(rng, 0.0),
+                      random_vector<Vector>(rng, (i % 3) * 0.5),
+                      random_vector<Vector>(rng, 0.5),
+                      random_vector<Vector>(rng, 0.5));
+        actions.push_back(action);
+
+        Observation observation;
+        observation.position = random_vector<Vector>(rng, 0.0);
+        observation.velocity = random_vector<Vector>(rng, 0.0);
+        observations.push_back(observation);
+    }
+
+    const double max_torque = 0.36;
+    const Vector safety_kd = Vector::Constant(0.08);
+    const Vector kp = Vector::Constant(3.0);
+    const Vector kd = Vector::Constant(0.03);
+    const Vector lower = Vector::Constant(-1.5);
+    const Vector upper = Vector::Constant(1.5);
+
+    auto measure = [&]() {
+        double sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < num_repetitions; r++)
+        {
+            for (size_t i = 0; i < num_samples; i++)
+            {
+                sink += Driver::process_desired_action(actions[i],
+                                                       observations[i],
+                                                       max_torque,
+                                                       safety_kd,
+                                                       kp,
+                                                       kd,
+                                                       lower,
+                                                       upper)
+                            .torque[0];
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        // make sure the computation is not optimised away
+        volatile double keep = sink;
+        (void)keep;
+
+        return std::chrono::duration<double, std::nano>(end - start).count() /
+               (num_samples * num_repetitions);
+    };
+
+    // take the fastest round to reduce the influence of other processes
+    double duration_ns = std::numeric_limits<double>::infinity();
+    for (size_t round = 0; round < num_rounds; round++)
+    {
+        duration_ns = std::min(duration_ns, measure());
+    }
+
+    std::cout << std::setw(8) << N_JOINTS << std::setw(15) << duration_ns
+              << std::setw(15) << duration_ns / N_JOINTS << std::endl;
+}
+
+int main()
+{
+    constexpr size_t NUM_SAMPLES = 1000;
+    constexpr size_t NUM_REPETITIONS = 200;
+    constexpr size_t NUM_ROUNDS = 10;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(8) << "joints" << std::setw(15) << "call [ns]"
+              << std::setw(15) << "joint [ns]" << std::endl;
+
+    run_benchmark<1>(NUM_SAMPLES, NUM_REPETITIONS, NUM_ROUNDS);
+    run_benchmark<2>(NUM_SAMPLES, NUM_REPETITIONS, NUM_ROUNDS);
+    run_benchmark<3>(NUM_SAMPLES, NUM_REPETITIONS, NUM_ROUNDS);
+    run_benchmark<8>(NUM_SAMPLES, NUM_REPETITIONS, NUM_ROUNDS);
+    run_benchmark<9>(NUM_SAMPLES, NUM_REPETITIONS, NUM_ROUNDS);
+
+    return 0;
+}
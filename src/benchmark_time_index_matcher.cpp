@@ -0,0 +1,146 @@
+/**
+ * @file
+ * @brief Benchmark of matching robot to camera time indices.
+ *
+ * Reads back through a full robot buffer (from the newest to the oldest
+ * step), matching each robot time index to the corresponding camera time
+ * index, which is the access pattern of post-processing of recorded data.
+ * Compares the previous linear search of
+ * `TriFingerPlatformFrontend::find_matching_timeindex` with the
+ * TimeIndexMatcher.
+ *
+ * The timestamps are held in a plain vector here.  In the frontend, each
+ * timestamp lookup is a round trip to the shared memory, so the number of
+ * lookups per query is the more relevant number.
+ *
+ * Usage: benchmark_time_index_matcher [robot_buffer_size]
+ *
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <robot_fingers/time_index_matcher.hpp>
+
+using namespace robot_fingers;
+using Index = TimeIndexMatcher::Index;
+
+//! @brief Timestamps of a time series, counting the lookups.
+struct Series
+{
+    std::vector<double> timestamps;
+    mutable size_t lookup_count = 0;
+
+    double get_timestamp(Index t) const
+    {
+        lookup_count++;
+        return timestamps[t];
+    }
+};
+
+//! @brief Previous implementation of find_matching_timeindex.
+Index reference_find(const Series &camera, double stamp_robot)
+{
+    Index t_camera = static_cast<Index>(camera.timestamps.size()) - 1;
+    double stamp_camera = camera.get_timestamp(t_camera);
+
+    while (stamp_robot < stamp_camera)
+    {
+        t_camera--;
+        stamp_camera = camera.get_timestamp(t_camera);
+    }
+
+    return t_camera;
+}
+
+template <typename Find>
+void run(const std::string &name,
+         const Series &robot,
+         const Series &camera,
+         Find find,
+         Index *checksum)
+{
+    camera.lookup_count = 0;
+    *checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (Index t = static_cast<Index>(robot.timestamps.size()) - 1; t >= 0;
+         t--)
+    {
+        *checksum += find(robot.timestamps[t]);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const double num_queries = robot.timestamps.size();
+    const double duration_ns =
+        std::chrono::duration<double, std::nano>(end - start).count();
+
+    std::cout << std::setw(12) << name << std::setw(18)
+              << camera.lookup_count / num_queries << std::setw(18)
+              << duration_ns / num_queries << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    // robot at 1 kHz, camera at 10 Hz
+    constexpr double ROBOT_PERIOD_MS = 1.0;
+    constexpr double CAMERA_PERIOD_MS = 100.0;
+
+    const size_t robot_buffer_size =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+    Series robot, camera;
+    for (size_t i = 0; i < robot_buffer_size; i++)
+    {
+        robot.timestamps.push_back(i * ROBOT_PERIOD_MS);
+    }
+    for (double stamp = 0; stamp < robot_buffer_size * ROBOT_PERIOD_MS;
+         stamp += CAMERA_PERIOD_MS)
+    {
+        camera.timestamps.push_back(stamp);
+    }
+
+    std::cout << "Robot buffer: " << robot.timestamps.size()
+              << " steps, camera: " << camera.timestamps.size() << " frames"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(12) << "" << std::setw(18) << "lookups/query"
+              << std::setw(18) << "time/query [ns]" << std::endl;
+
+    Index reference_checksum, matcher_checksum;
+
+    run(
+        "linear",
+        robot,
+        camera,
+        [&camera](double stamp) { return reference_find(camera, stamp); },
+        &reference_checksum);
+
+    TimeIndexMatcher matcher;
+    const Index newest = static_cast<Index>(camera.timestamps.size()) - 1;
+    run(
+        "matcher",
+        robot,
+        camera,
+        [&](double stamp) {
+            return matcher.find(stamp, newest, [&camera](Index t, double *s) {
+                *s = camera.get_timestamp(t);
+                return true;
+            });
+        },
+        &matcher_checksum);
+
+    if (reference_checksum != matcher_checksum)
+    {
+        std::cerr << "ERROR: Results of the implementations differ."
+                  << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
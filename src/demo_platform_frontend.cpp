@@ -33,17 +33,17 @@ int main()
                   << robot_observation.position[1] << ", "
                   << robot_observation.position[2] << std::endl;
 
-        // try
-        //{
-        //    auto object_pose = frontend.get_object_pose(t);
-        //    std::cout << "Object: " << object_pose.position[0] << ", "
-        //              << object_pose.position[0] << ", "
-        //              << object_pose.position[0] << std::endl;
-        //}
-        // catch (const std::invalid_argument &e)
-        //{
-        //    std::cerr << "No object pose: " << e.what() << std::endl;
-        //}
+        try
+        {
+            auto object_pose = frontend.get_object_pose(t).object_pose;
+            std::cout << "Object: " << object_pose.position[0] << ", "
+                      << object_pose.position[1] << ", "
+                      << object_pose.position[2] << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "No object pose: " << e.what() << std::endl;
+        }
 
         try
         {
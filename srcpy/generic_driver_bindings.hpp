@@ -4,12 +4,16 @@
  * @copyright 2019, Max Planck Gesellschaft.  All rights reserved.
  * @license BSD 3-clause
  */
+#include <utility>
+
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include <robot_interfaces/n_joint_robot_types.hpp>
 
+#include <robot_fingers/append_desired_actions.hpp>
+
 namespace robot_fingers
 {
 template <typename Driver>
@@ -33,6 +37,26 @@ void bind_driver_config(pybind11::module &m, const std::string &name)
 
              Returns:
                  The configuration loaded from the given file.
+)XXX")
+        .def_static("try_load_config",
+                    &Driver::Config::try_load_config,
+                    pybind11::call_guard<pybind11::gil_scoped_release>(),
+                    pybind11::arg("config_file_name"),
+                    R"XXX(
+             try_load_config(config_file_name: str) -> Config
+
+             Like :meth:`load_config` but raises an error instead of exiting
+             if the configuration is invalid.
+
+             Args:
+                 config_file_name:  Path to the config file.
+
+             Returns:
+                 The configuration loaded from the given file.
+
+             Raises:
+                 ValueError: If the configuration is invalid.  The message
+                     lists all problems that were found.
 )XXX")
         .def("is_within_hard_position_limits",
              &Driver::Config::is_within_hard_position_limits,
@@ -64,6 +88,13 @@ void bind_driver_config(pybind11::module &m, const std::string &name)
         .def_readwrite("max_current_A",
                        &Driver::Config::max_current_A,
                        "Maximum current that can be sent to the motor [A].")
+        .def_readwrite("control_period_s",
+                       &Driver::Config::control_period_s,
+                       "Duration of one cycle of the control loop [s].")
+        .def_readwrite("wait_for_new_measurement",
+                       &Driver::Config::wait_for_new_measurement,
+                       "Synchronise the control loop with the measurements of "
+                       "the motor boards.")
         .def_readwrite("has_endstop",
                        &Driver::Config::has_endstop,
                        "Whether the joints have physical end stops or not.")
@@ -74,6 +105,17 @@ void bind_driver_config(pybind11::module &m, const std::string &name)
                        &Driver::Config::move_to_position_tolerance_rad,
                        "Tolerance for reaching the target with "
                        "NJointBlmcRobotDriver::move_to_position()")
+        .def_readwrite("move_to_position_max_velocity_radps",
+                       &Driver::Config::move_to_position_max_velocity_radps,
+                       "Velocity limit for moves to a position.")
+        .def_readwrite(
+            "move_to_position_max_acceleration_radps2",
+            &Driver::Config::move_to_position_max_acceleration_radps2,
+            "Acceleration limit for moves to a position.")
+        .def_readwrite("move_to_position_settled_velocity_radps",
+                       &Driver::Config::move_to_position_settled_velocity_radps,
+                       "Velocity below which a joint is considered to be at "
+                       "rest (enables early exit of moves).")
         .def_readwrite(
             "safety_kd",
             &Driver::Config::safety_kd,
@@ -100,9 +142,58 @@ void bind_driver_config(pybind11::module &m, const std::string &name)
             "initial_position_rad",
             &Driver::Config::initial_position_rad,
             "Initial position to which the robot moves during initialisation.")
+        .def_readwrite(
+            "initial_move_order",
+            &Driver::Config::initial_move_order,
+            "Order in which the joints move to the initial position.")
+        .def_readwrite("initial_move_groups",
+                       &Driver::Config::initial_move_groups,
+                       "Groups of joints that move to the initial position "
+                       "together.")
         .def_readwrite("shutdown_trajectory",
                        &Driver::Config::shutdown_trajectory,
-                       "Trajectory which is executed during shutdown.");
+                       "Trajectory which is executed during shutdown.")
+        .def_readwrite("shutdown_timeout_s",
+                       &Driver::Config::shutdown_timeout_s,
+                       "Maximum duration of the shutdown trajectory.")
+        .def_readwrite("enable_timing_trace",
+                       &Driver::Config::enable_timing_trace,
+                       "Record the timing of each control cycle.")
+        .def_readwrite("timing_trace_file",
+                       &Driver::Config::timing_trace_file,
+                       "File to which the timing trace is written.")
+        .def_readwrite("parallel_can_send",
+                       &Driver::Config::parallel_can_send,
+                       "Send the torque commands to all boards in parallel.")
+        .def_readwrite("can_send_cpus",
+                       &Driver::Config::can_send_cpus,
+                       "CPUs to which the CAN writer threads are pinned.")
+        .def_readwrite("motor_board_ready_timeout_s",
+                       &Driver::Config::motor_board_ready_timeout_s,
+                       "Time the motor boards have to get ready at startup.")
+        .def_readwrite("initialization_report_file",
+                       &Driver::Config::initialization_report_file,
+                       "File to which the initialisation report is written.")
+        .def_readwrite("homing_cache_file",
+                       &Driver::Config::homing_cache_file,
+                       "File in which the result of the homing is cached.")
+        .def_readwrite(
+            "homing_cache_tolerance_rad",
+            &Driver::Config::homing_cache_tolerance_rad,
+            "Allowed deviation of the joint positions for the homing cache.");
+
+    pybind11::enum_<typename Driver::Config::EndstopStallAction>(
+        config, "EndstopStallAction")
+        .value("PUSH", Driver::Config::EndstopStallAction::PUSH)
+        .value("HOLD", Driver::Config::EndstopStallAction::HOLD)
+        .value("ZERO_TORQUE", Driver::Config::EndstopStallAction::ZERO_TORQUE);
+
+    pybind11::enum_<typename Driver::Config::InitialMoveOrder>(
+        config, "InitialMoveOrder")
+        .value("JOINT_BY_JOINT",
+               Driver::Config::InitialMoveOrder::JOINT_BY_JOINT)
+        .value("SIMULTANEOUS", Driver::Config::InitialMoveOrder::SIMULTANEOUS)
+        .value("GROUPS", Driver::Config::InitialMoveOrder::GROUPS);
 
     pybind11::class_<typename Driver::Config::TrajectoryStep>(config,
                                                               "TrajectoryStep")
@@ -113,7 +204,10 @@ void bind_driver_config(pybind11::module &m, const std::string &name)
         .def_readwrite(
             "move_steps",
             &Driver::Config::TrajectoryStep::move_steps,
-            "Number of time steps for reaching the target position.");
+            "Number of time steps for reaching the target position.")
+        .def_readwrite("joints",
+                       &Driver::Config::TrajectoryStep::joints,
+                       "Joints moved by this step (all joints if empty).");
 
     pybind11::class_<typename Driver::Config::CalibrationParameters>(
         config, "CalibrationParameters")
@@ -125,7 +219,16 @@ void bind_driver_config(pybind11::module &m, const std::string &name)
         .def_readwrite(
             "move_steps",
             &Driver::Config::CalibrationParameters::move_steps,
-            "Number of time steps for reaching the initial position.");
+            "Number of time steps for reaching the initial position.")
+        .def_readwrite(
+            "endstop_search_timeout_s",
+            &Driver::Config::CalibrationParameters::endstop_search_timeout_s,
+            "Maximum duration of the end-stop search.")
+        .def_readwrite(
+            "endstop_stall_action",
+            &Driver::Config::CalibrationParameters::endstop_stall_action,
+            "What to do with joints that reached the end stop while others "
+            "are still moving.");
 
     pybind11::class_<typename Driver::Config::PositionControlGains>(
         config, "PositionControlGains")
@@ -134,9 +237,76 @@ void bind_driver_config(pybind11::module &m, const std::string &name)
         .def_readwrite("kd", &Driver::Config::PositionControlGains::kd);
 }
 
+template <typename Driver>
+void bind_driver(pybind11::module &m, const std::string &name)
+{
+    pybind11::class_<Driver, std::shared_ptr<Driver>> driver(m,
+                                                             name.c_str(),
+                                                             R"XXX(
+        Driver for the real robot.
+
+        Pass it to the corresponding ``create_*_backend`` function.  Keep a
+        reference to change gains and soft limits while the robot is running
+        (see :meth:`set_runtime_parameters`).
+)XXX");
+    driver
+        .def(pybind11::init<const typename Driver::Config &>(),
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             pybind11::arg("config"))
+        .def("set_runtime_parameters",
+             &Driver::set_runtime_parameters,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             pybind11::arg("parameters"),
+             R"XXX(
+                set_runtime_parameters(parameters: RuntimeParameters)
+
+                Change gains and soft limits while the robot is running.
+
+                The parameters are used starting with the next action.
+
+                Raises:
+                    ValueError: if the parameters are invalid.
+)XXX")
+        .def("get_runtime_parameters",
+             &Driver::get_runtime_parameters,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             "Parameters that were set last.")
+        .def("get_config",
+             &Driver::get_config,
+             "Configuration the driver was created with.");
+
+    pybind11::class_<typename Driver::RuntimeParameters>(driver,
+                                                         "RuntimeParameters")
+        .def(pybind11::init<>())
+        .def_static("from_config",
+                    &Driver::RuntimeParameters::from_config,
+                    pybind11::arg("config"))
+        .def("validate", &Driver::RuntimeParameters::validate)
+        .def_readwrite("position_control_kp",
+                       &Driver::RuntimeParameters::position_control_kp)
+        .def_readwrite("position_control_kd",
+                       &Driver::RuntimeParameters::position_control_kd)
+        .def_readwrite("safety_kd", &Driver::RuntimeParameters::safety_kd)
+        .def_readwrite("soft_position_limits_lower",
+                       &Driver::RuntimeParameters::soft_position_limits_lower)
+        .def_readwrite("soft_position_limits_upper",
+                       &Driver::RuntimeParameters::soft_position_limits_upper);
+}
+
 template <typename Driver>
 void bind_create_backend(pybind11::module &m, const std::string &name)
 {
+    m.def(name.c_str(),
+          pybind11::overload_cast<typename Driver::Types::BaseDataPtr,
+                                  std::shared_ptr<Driver>,
+                                  const double,
+                                  const uint32_t>(&create_backend<Driver>),
+          pybind11::arg("robot_data"),
+          pybind11::arg("driver"),
+          pybind11::arg("first_action_timeout") =
+              std::numeric_limits<double>::infinity(),
+          pybind11::arg("max_number_of_actions") = 0);
+
     m.def(name.c_str(),
           pybind11::overload_cast<typename Driver::Types::BaseDataPtr,
                                   const typename Driver::Config &,
@@ -160,4 +330,153 @@ void bind_create_backend(pybind11::module &m, const std::string &name)
           pybind11::arg("max_number_of_actions") = 0);
 }
 
+template <typename Driver>
+void bind_process_desired_action_batch(pybind11::module &m,
+                                       const std::string &name)
+{
+    using JointTrajectory = typename Driver::JointTrajectory;
+    using Vector = typename Driver::Vector;
+
+    m.def(
+        name.c_str(),
+        // The actions are taken by value and moved into the batch, so the
+        // NumPy arrays are only copied once (when converting them).
+        [](JointTrajectory torque,
+           JointTrajectory position,
+           JointTrajectory position_kp,
+           JointTrajectory position_kd,
+           const JointTrajectory &observed_position,
+           const JointTrajectory &observed_velocity,
+           const double max_torque_Nm,
+           const Vector &safety_kd,
+           const Vector &default_position_control_kp,
+           const Vector &default_position_control_kd,
+           const Vector &lower_position_limits,
+           const Vector &upper_position_limits,
+           const unsigned int num_threads) {
+            typename Driver::ActionBatch actions = {std::move(torque),
+                                                    std::move(position),
+                                                    std::move(position_kp),
+                                                    std::move(position_kd)};
+
+            typename Driver::ActionBatch result;
+            {
+                pybind11::gil_scoped_release release;
+                result = Driver::process_desired_action_batch(
+                    actions,
+                    observed_position,
+                    observed_velocity,
+                    max_torque_Nm,
+                    safety_kd,
+                    default_position_control_kp,
+                    default_position_control_kd,
+                    lower_position_limits,
+                    upper_position_limits,
+                    num_threads);
+            }
+
+            return pybind11::make_tuple(result.torque,
+                                        result.position,
+                                        result.position_kp,
+                                        result.position_kd);
+        },
+        pybind11::arg("torque"),
+        pybind11::arg("position"),
+        pybind11::arg("position_kp"),
+        pybind11::arg("position_kd"),
+        pybind11::arg("observed_position"),
+        pybind11::arg("observed_velocity"),
+        pybind11::arg("max_torque_Nm"),
+        pybind11::arg("safety_kd"),
+        pybind11::arg("default_position_control_kp"),
+        pybind11::arg("default_position_control_kd"),
+        pybind11::arg("lower_position_limits") =
+            Vector::Constant(-std::numeric_limits<double>::infinity()),
+        pybind11::arg("upper_position_limits") =
+            Vector::Constant(std::numeric_limits<double>::infinity()),
+        pybind11::arg("num_threads") = 0,
+        R"XXX(
+        Apply the safety processing of the driver to a batch of time steps.
+
+        All trajectory arguments are arrays of shape (T, n_joints) with one
+        row per time step.  For each time step the result is exactly the same
+        as the action that the driver would apply, so this can be used to
+        verify the applied actions of a robot log.  The time steps are
+        processed in parallel.
+
+        Args:
+            torque, position, position_kp, position_kd:  Desired actions.
+            observed_position, observed_velocity:  Observed joint states.
+            max_torque_Nm:  Maximum allowed absolute torque.
+            safety_kd:  D-gain for velocity damping.
+            default_position_control_kp:  Default P-gain.
+            default_position_control_kd:  Default D-gain.
+            lower_position_limits:  Soft lower position limits.
+            upper_position_limits:  Soft upper position limits.
+            num_threads:  Number of threads (0 = number of CPU cores).
+
+        Returns:
+            Tuple (torque, position, position_kp, position_kd) of the
+            resulting actions.
+)XXX");
+}
+
+template <typename Driver>
+void bind_append_desired_actions(pybind11::module &m, const std::string &name)
+{
+    using JointTrajectory = typename Driver::JointTrajectory;
+
+    m.def(
+        name.c_str(),
+        // by value and moved, see bind_process_desired_action_batch()
+        [](typename Driver::Types::Frontend &frontend,
+           JointTrajectory torque,
+           JointTrajectory position,
+           JointTrajectory position_kp,
+           JointTrajectory position_kd) {
+            typename Driver::ActionBatch actions = {std::move(torque),
+                                                    std::move(position),
+                                                    std::move(position_kp),
+                                                    std::move(position_kd)};
+
+            pybind11::gil_scoped_release release;
+            return append_desired_actions<typename Driver::Action>(frontend,
+                                                                   actions);
+        },
+        pybind11::arg("frontend"),
+        pybind11::arg("torque") = JointTrajectory(),
+        pybind11::arg("position") = JointTrajectory(),
+        pybind11::arg("position_kp") = JointTrajectory(),
+        pybind11::arg("position_kd") = JointTrajectory(),
+        R"XXX(
+        Append a batch of desired actions to the action time series of a
+        frontend.
+
+        Same as calling ``frontend.append_desired_action()`` for each row of
+        the given arrays but with a single call.  Fields that are not given
+        are set to their default value (zero torque, no position control),
+        e.g. ``append_desired_actions(frontend, position=positions)`` appends
+        a position trajectory.  All actions are validated before the first one
+        is appended.
+
+        Note that actions are dropped from the time series before being
+        executed if the batch is longer than its history, so send long
+        trajectories in chunks.
+
+        Args:
+            frontend:  The robot frontend.
+            torque, position, position_kp, position_kd:  Arrays of shape
+                (N, n_joints) with one row per time step.  All given arrays
+                must have the same number of rows.
+
+        Returns:
+            Tuple (t_begin, t_end) with the range [t_begin, t_end) of time
+            steps at which the actions will be applied.
+
+        Raises:
+            ValueError: if no array is given or the arrays have different
+                numbers of rows.
+)XXX");
+}
+
 }  // namespace robot_fingers
@@ -26,4 +26,9 @@ PYBIND11_MODULE(py_one_joint, m)
 {
     bind_create_backend<OneJointDriver>(m, "create_one_joint_backend");
     bind_driver_config<OneJointDriver>(m, "OneJointConfig");
+    bind_driver<OneJointDriver>(m, "OneJointDriver");
+    bind_process_desired_action_batch<OneJointDriver>(
+        m, "process_one_joint_action_batch");
+    bind_append_desired_actions<OneJointDriver>(
+        m, "append_one_joint_desired_actions");
 }
@@ -27,6 +27,11 @@ PYBIND11_MODULE(py_real_finger, m)
 {
     bind_create_backend<RealFingerDriver>(m, "create_real_finger_backend");
     bind_driver_config<RealFingerDriver>(m, "FingerConfig");
+    bind_driver<RealFingerDriver>(m, "RealFingerDriver");
+    bind_process_desired_action_batch<RealFingerDriver>(
+        m, "process_real_finger_action_batch");
+    bind_append_desired_actions<RealFingerDriver>(
+        m, "append_real_finger_desired_actions");
 
     m.def("create_fake_finger_backend", &create_fake_finger_backend);
 }
@@ -32,4 +32,9 @@ PYBIND11_MODULE(py_solo_eight, m)
 {
     bind_create_backend<SoloEightDriver>(m, "create_solo_eight_backend");
     bind_driver_config<SoloEightDriver>(m, "SoloEightConfig");
+    bind_driver<SoloEightDriver>(m, "SoloEightDriver");
+    bind_process_desired_action_batch<SoloEightDriver>(
+        m, "process_solo_eight_action_batch");
+    bind_append_desired_actions<SoloEightDriver>(
+        m, "append_solo_eight_desired_actions");
 }
@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief Python bindings for the trajectory generation.
+ * @copyright 2022, Max Planck Gesellschaft.  All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <pybind11/eigen.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <robot_fingers/trajectory.hpp>
+
+using namespace robot_fingers;
+
+PYBIND11_MODULE(py_trajectory, m)
+{
+    m.def("min_jerk_phase",
+          &min_jerk_phase,
+          pybind11::arg("alpha"),
+          "Fraction of the distance covered by a minimum jerk trajectory at "
+          "normalised time alpha.");
+
+    pybind11::class_<Trajectory>(m, "Trajectory", R"XXX(
+        Trajectory with positions and velocities precomputed for each step.
+
+        Step t holds the values at time (t + 1) * step_duration, i.e. the last
+        step is the goal.  Values are stored as arrays with one row per step.
+)XXX")
+        .def(pybind11::init<>())
+        .def(pybind11::init<const Trajectory::Buffer &,
+                            const Trajectory::Buffer &>(),
+             pybind11::arg("positions"),
+             pybind11::arg("velocities"))
+        .def_static("quintic",
+                    &Trajectory::quintic,
+                    pybind11::call_guard<pybind11::gil_scoped_release>(),
+                    pybind11::arg("start"),
+                    pybind11::arg("goal"),
+                    pybind11::arg("start_velocity"),
+                    pybind11::arg("goal_velocity"),
+                    pybind11::arg("start_acceleration"),
+                    pybind11::arg("goal_acceleration"),
+                    pybind11::arg("num_steps"),
+                    pybind11::arg("step_duration_s"),
+                    "Quintic polynomial between two states.")
+        .def_static("min_jerk",
+                    &Trajectory::min_jerk,
+                    pybind11::call_guard<pybind11::gil_scoped_release>(),
+                    pybind11::arg("start"),
+                    pybind11::arg("goal"),
+                    pybind11::arg("num_steps"),
+                    pybind11::arg("step_duration_s"),
+                    "Minimum jerk trajectory from start to goal.")
+        .def_static("min_jerk_profile",
+                    &Trajectory::min_jerk_profile,
+                    pybind11::call_guard<pybind11::gil_scoped_release>(),
+                    pybind11::arg("num_steps"),
+                    pybind11::arg("step_duration_s") = 1.0,
+                    "Normalised minimum jerk profile going from 0 to 1.")
+        .def_static("spline",
+                    &Trajectory::spline,
+                    pybind11::call_guard<pybind11::gil_scoped_release>(),
+                    pybind11::arg("waypoints"),
+                    pybind11::arg("segment_steps"),
+                    pybind11::arg("step_duration_s"),
+                    "Spline of quintic segments through the given waypoints.")
+        .def("__len__", &Trajectory::size)
+        .def_property_readonly("num_dofs", &Trajectory::num_dofs)
+        .def_property_readonly("positions",
+                               &Trajectory::positions,
+                               "Positions of all steps (one row per step).")
+        .def_property_readonly("velocities",
+                               &Trajectory::velocities,
+                               "Velocities of all steps (one row per step).");
+}
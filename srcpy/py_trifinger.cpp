@@ -6,9 +6,12 @@
  */
 #include <pybind11/eigen.h>
 #include <pybind11/embed.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl_bind.h>
 
+#include <opencv2/core.hpp>
+
 #include <robot_fingers/trifinger_driver.hpp>
 #include <robot_fingers/trifinger_platform_frontend.hpp>
 #include <robot_fingers/trifinger_platform_log.hpp>
@@ -18,18 +21,96 @@
 using namespace pybind11::literals;
 using namespace robot_fingers;
 
+/**
+ * @brief Create a read-only NumPy array referencing the pixels of an image.
+ *
+ * The array keeps a reference to the image data (cv::Mat is reference
+ * counted), so it stays valid independent of the lifetime of the mat.
+ */
+pybind11::array image_to_numpy_view(const cv::Mat &image)
+{
+    pybind11::dtype dtype;
+    switch (image.depth())
+    {
+        case CV_8U:
+            dtype = pybind11::dtype::of<uint8_t>();
+            break;
+        case CV_8S:
+            dtype = pybind11::dtype::of<int8_t>();
+            break;
+        case CV_16U:
+            dtype = pybind11::dtype::of<uint16_t>();
+            break;
+        case CV_16S:
+            dtype = pybind11::dtype::of<int16_t>();
+            break;
+        case CV_32S:
+            dtype = pybind11::dtype::of<int32_t>();
+            break;
+        case CV_32F:
+            dtype = pybind11::dtype::of<float>();
+            break;
+        case CV_64F:
+            dtype = pybind11::dtype::of<double>();
+            break;
+        default:
+            throw std::invalid_argument("Unsupported image depth.");
+    }
+
+    std::vector<pybind11::ssize_t> shape = {image.rows, image.cols};
+    std::vector<pybind11::ssize_t> strides = {
+        static_cast<pybind11::ssize_t>(image.step[0]),
+        static_cast<pybind11::ssize_t>(image.elemSize())};
+    if (image.channels() > 1)
+    {
+        shape.push_back(image.channels());
+        strides.push_back(static_cast<pybind11::ssize_t>(image.elemSize1()));
+    }
+
+    pybind11::capsule owner(new cv::Mat(image), [](void *mat) {
+        delete static_cast<cv::Mat *>(mat);
+    });
+    pybind11::array array(dtype, shape, strides, image.data, owner);
+    // the pixels may be shared with other views of the same observation
+    array.attr("setflags")(pybind11::arg("write") = false);
+
+    return array;
+}
+
 template <typename T>
-void pybind_trifinger_platform_frontend(pybind11::module &m,
-                                        const std::string &name)
+pybind11::class_<T, std::shared_ptr<T>> pybind_trifinger_platform_frontend(
+    pybind11::module &m, const std::string &name)
 {
     auto trifinger_types =
         pybind11::module::import("robot_interfaces.py_trifinger_types");
 
+    using JointBlock = typename T::template Block<9>;
+
     pybind11::class_<T, std::shared_ptr<T>> PyT(m, name.c_str());
 
     // expose the "Action" typedef to Python
     PyT.attr("Action") = trifinger_types.attr("Action");
 
+    // Blocks returned by the range getters.  Fields are exposed as NumPy
+    // arrays referencing the data of the block (no copy).
+    pybind11::class_<typename T::RobotObservationBlock>(
+        PyT, "RobotObservationBlock", "Robot observations of a range of steps.")
+        .def_readonly("position", &T::RobotObservationBlock::position)
+        .def_readonly("velocity", &T::RobotObservationBlock::velocity)
+        .def_readonly("torque", &T::RobotObservationBlock::torque)
+        .def_readonly("tip_force", &T::RobotObservationBlock::tip_force);
+    pybind11::class_<typename T::ActionBlock>(
+        PyT, "ActionBlock", "Robot actions of a range of steps.")
+        .def_readonly("torque", &T::ActionBlock::torque)
+        .def_readonly("position", &T::ActionBlock::position)
+        .def_readonly("position_kp", &T::ActionBlock::position_kp)
+        .def_readonly("position_kd", &T::ActionBlock::position_kd);
+    pybind11::class_<typename T::RobotStatusBlock>(
+        PyT, "RobotStatusBlock", "Robot status of a range of steps.")
+        .def_readonly("action_repetitions",
+                      &T::RobotStatusBlock::action_repetitions)
+        .def_readonly("error_status", &T::RobotStatusBlock::error_status);
+
     PyT.def(pybind11::init<>())
         .def("append_desired_action",
              &T::append_desired_action,
@@ -57,6 +138,56 @@ void pybind_trifinger_platform_frontend(pybind11::module &m,
 
              Returns:
                  Time step at which the action will be applied.
+)XXX")
+        .def(
+            "append_desired_actions",
+            // The arrays are taken by value and moved into the block, so they
+            // are only copied once (when converting them).
+            [](T &self,
+               JointBlock torque,
+               JointBlock position,
+               JointBlock position_kp,
+               JointBlock position_kd) {
+                typename T::ActionBlock actions = {std::move(torque),
+                                                   std::move(position),
+                                                   std::move(position_kp),
+                                                   std::move(position_kd)};
+
+                pybind11::gil_scoped_release release;
+                return self.append_desired_actions(actions);
+            },
+            "torque"_a = JointBlock(),
+            "position"_a = JointBlock(),
+            "position_kp"_a = JointBlock(),
+            "position_kd"_a = JointBlock(),
+            R"XXX(
+             append_desired_actions(torque: numpy.ndarray = ..., position: numpy.ndarray = ..., position_kp: numpy.ndarray = ..., position_kd: numpy.ndarray = ...) -> Tuple[int, int]
+
+             Append a batch of desired actions to the action time series.
+
+             Same as calling :meth:`append_desired_action` for each row of
+             the given arrays but with a single call.  Fields that are not
+             given are set to their default value (zero torque, no position
+             control), e.g. ``append_desired_actions(position=positions)``
+             appends a position trajectory.  All actions are validated before
+             the first one is appended.
+
+             Note that actions are dropped from the time series before being
+             executed if the batch is longer than its history, so send long
+             trajectories in chunks.
+
+             Args:
+                 torque, position, position_kp, position_kd:  Arrays of shape
+                     (N, 9) with one row per time step.  All given arrays
+                     must have the same number of rows.
+
+             Returns:
+                 Tuple (t_begin, t_end) with the range [t_begin, t_end) of
+                 time steps at which the actions will be applied.
+
+             Raises:
+                 ValueError: if no array is given or the arrays have
+                     different numbers of rows.
 )XXX")
         .def("get_robot_observation",
              &T::get_robot_observation,
@@ -100,6 +231,48 @@ void pybind_trifinger_platform_frontend(pybind11::module &m,
                     Exception: if t is too old and not in the time series buffer
                         anymore.
 )XXX")
+        .def(
+            "get_camera_images",
+            [](const T &self, const time_series::Index t) {
+                std::shared_ptr<const typename T::CameraObservation>
+                    observation;
+                {
+                    pybind11::gil_scoped_release release;
+                    observation = self.get_camera_observation_ptr(t);
+                }
+
+                pybind11::list images;
+                for (const auto &camera : observation->cameras)
+                {
+                    images.append(image_to_numpy_view(camera.image));
+                }
+                return images;
+            },
+            "t"_a,
+            R"XXX(
+                get_camera_images(t: int) -> List[numpy.ndarray]
+
+                Get the images of all cameras of time step t without copying.
+
+                Unlike :meth:`get_camera_observation`, the images are not
+                copied but returned as read-only arrays which directly
+                reference the image data (use ``numpy.array(image)`` to get a
+                writeable copy).  Use this if only the images are needed.
+
+                If t is in the future, this method will block and wait.
+
+                Args:
+                    t:  Time index of the robot time series.  This is internally
+                        mapped to the corresponding time index of the camera
+                        time series.
+
+                Returns:
+                    List with the raw image of each camera.
+
+                Raises:
+                    Exception: if t is too old and not in the time series buffer
+                        anymore.
+)XXX")
         .def("get_desired_action",
              &T::get_desired_action,
              pybind11::call_guard<pybind11::gil_scoped_release>(),
@@ -148,6 +321,78 @@ void pybind_trifinger_platform_frontend(pybind11::module &m,
                 Get timestamp in milliseconds of time step t.
 
                 If t is in the future, this method will block and wait.
+)XXX")
+        .def("get_robot_observations",
+             &T::get_robot_observations,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             "t_begin"_a,
+             "t_end"_a,
+             R"XXX(
+                get_robot_observations(t_begin: int, t_end: int) -> RobotObservationBlock
+
+                Get robot observations of the time steps [t_begin, t_end).
+
+                Much faster than calling :meth:`get_robot_observation` in a
+                loop, as all steps are fetched in a single call.  The fields
+                of the result are arrays with one row per time step, e.g.
+                ``position`` has shape (t_end - t_begin, 9).
+
+                If t_end - 1 is in the future, this method will block and
+                wait.
+
+                Raises:
+                    Exception: if a step is too old and not in the time series
+                        buffer anymore.
+)XXX")
+        .def("get_desired_actions",
+             &T::get_desired_actions,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             "t_begin"_a,
+             "t_end"_a,
+             R"XXX(
+                get_desired_actions(t_begin: int, t_end: int) -> ActionBlock
+
+                Get desired actions of the time steps [t_begin, t_end).
+
+                See :meth:`get_robot_observations`.
+)XXX")
+        .def("get_applied_actions",
+             &T::get_applied_actions,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             "t_begin"_a,
+             "t_end"_a,
+             R"XXX(
+                get_applied_actions(t_begin: int, t_end: int) -> ActionBlock
+
+                Get actually applied actions of the time steps [t_begin, t_end).
+
+                See :meth:`get_robot_observations`.
+)XXX")
+        .def("get_robot_statuses",
+             &T::get_robot_statuses,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             "t_begin"_a,
+             "t_end"_a,
+             R"XXX(
+                get_robot_statuses(t_begin: int, t_end: int) -> RobotStatusBlock
+
+                Get robot status of the time steps [t_begin, t_end).
+
+                Error messages are not included, use :meth:`get_robot_status`
+                for steps with an error.  See :meth:`get_robot_observations`.
+)XXX")
+        .def("get_timestamps_ms",
+             &T::get_timestamps_ms,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             "t_begin"_a,
+             "t_end"_a,
+             R"XXX(
+                get_timestamps_ms(t_begin: int, t_end: int) -> numpy.ndarray
+
+                Get timestamps in milliseconds of the time steps [t_begin,
+                t_end).
+
+                See :meth:`get_robot_observations`.
 )XXX")
         .def("wait_until_timeindex",
              &T::wait_until_timeindex,
@@ -165,6 +410,58 @@ void pybind_trifinger_platform_frontend(pybind11::module &m,
 
                 Get the current time index.
 )XXX");
+
+    return PyT;
+}
+
+void pybind_object_pose_data(pybind11::module &m)
+{
+    pybind11::class_<ObjectPoseObservation>(
+        m, "ObjectPoseObservation", "Object pose of one camera observation.")
+        .def(pybind11::init<>())
+        .def_readwrite("object_pose",
+                       &ObjectPoseObservation::object_pose,
+                       "Pose of the object as detected in the camera images.")
+        .def_readwrite("filtered_object_pose",
+                       &ObjectPoseObservation::filtered_object_pose,
+                       "Filtered pose of the object.")
+        .def_readwrite("camera_timeindex",
+                       &ObjectPoseObservation::camera_timeindex,
+                       "Time index of the camera observation.")
+        .def_readwrite("camera_timestamp_ms",
+                       &ObjectPoseObservation::camera_timestamp_ms,
+                       "Timestamp of the camera observation.");
+
+    pybind11::class_<ObjectPoseData, std::shared_ptr<ObjectPoseData>>(
+        m, "BaseObjectPoseData");
+    pybind11::class_<SingleProcessObjectPoseData,
+                     std::shared_ptr<SingleProcessObjectPoseData>,
+                     ObjectPoseData>(m, "SingleProcessObjectPoseData")
+        .def(pybind11::init<size_t>(), "history_length"_a = 1000);
+    pybind11::class_<MultiProcessObjectPoseData,
+                     std::shared_ptr<MultiProcessObjectPoseData>,
+                     ObjectPoseData>(m, "MultiProcessObjectPoseData")
+        .def(pybind11::init<const std::string &, bool, size_t>(),
+             "shared_memory_id_prefix"_a,
+             "is_master"_a,
+             "history_length"_a = 1000);
+
+    pybind11::class_<ObjectPosePublisher, std::shared_ptr<ObjectPosePublisher>>(
+        m,
+        "ObjectPosePublisher",
+        R"XXX(
+            Copies the object poses of the camera observations to a separate
+            time series.
+
+            Run this in the camera backend, so that frontends can get the
+            object pose without copying the camera images (see
+            :meth:`TriFingerPlatformWithObjectFrontend.get_object_pose`).
+)XXX")
+        .def(pybind11::init<std::shared_ptr<robot_interfaces::SensorData<
+                                ObjectPosePublisher::CameraObservation>>,
+                            std::shared_ptr<ObjectPoseData>>(),
+             "camera_data"_a,
+             "object_pose_data"_a);
 }
 
 template <typename T>
@@ -282,16 +579,50 @@ PYBIND11_MODULE(py_trifinger, m)
     // nice in the Sphinx documentation.
     options.disable_function_signatures();
 
-    // needed for bindings of camera observations
+    // needed for bindings of camera observations and object poses
     pybind11::module::import("trifinger_object_tracking.py_tricamera_types");
+    pybind11::module::import("trifinger_object_tracking.py_object_tracker");
 
     bind_create_backend<TriFingerDriver>(m, "create_trifinger_backend");
     bind_driver_config<TriFingerDriver>(m, "TriFingerConfig");
+    bind_driver<TriFingerDriver>(m, "TriFingerDriver");
+    bind_process_desired_action_batch<TriFingerDriver>(
+        m, "process_trifinger_action_batch");
+    bind_append_desired_actions<TriFingerDriver>(
+        m, "append_trifinger_desired_actions");
 
     pybind_trifinger_platform_frontend<TriFingerPlatformFrontend>(
         m, "TriFingerPlatformFrontend");
+
+    pybind_object_pose_data(m);
+
     pybind_trifinger_platform_frontend<TriFingerPlatformWithObjectFrontend>(
-        m, "TriFingerPlatformWithObjectFrontend");
+        m, "TriFingerPlatformWithObjectFrontend")
+        .def("get_object_pose",
+             &TriFingerPlatformWithObjectFrontend::get_object_pose,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             "t"_a,
+             R"XXX(
+                get_object_pose(t: int) -> ObjectPoseObservation
+
+                Get the object pose of time step t.
+
+                Matches t to the camera observations in the same way as
+                :meth:`get_camera_observation` but only reads the object pose
+                from the object pose time series (published by
+                :class:`ObjectPosePublisher` in the backend), so the images
+                are not copied.
+
+                Args:
+                    t:  Time index of the robot time series.
+
+                Returns:
+                    Object pose of the camera observation of time step t.
+
+                Raises:
+                    Exception: if the backend does not publish object poses or
+                        if the matching pose is not available.
+)XXX");
 
     pybind_trifinger_platform_log<TriFingerPlatformLog>(m,
                                                         "TriFingerPlatformLog");
@@ -26,4 +26,9 @@ PYBIND11_MODULE(py_two_joint, m)
 {
     bind_create_backend<TwoJointDriver>(m, "create_two_joint_backend");
     bind_driver_config<TwoJointDriver>(m, "TwoJointConfig");
+    bind_driver<TwoJointDriver>(m, "TwoJointDriver");
+    bind_process_desired_action_batch<TwoJointDriver>(
+        m, "process_two_joint_action_batch");
+    bind_append_desired_actions<TwoJointDriver>(
+        m, "append_two_joint_desired_actions");
 }
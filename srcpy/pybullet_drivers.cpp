@@ -18,6 +18,7 @@ PYBIND11_MODULE(pybullet_drivers, m)
           "visualize"_a,
           "first_action_timeout"_a = std::numeric_limits<double>::infinity(),
           "max_number_of_actions"_a = 0,
+          "control_period_s"_a = 0.001,
           R"XXX(
             Create backend for the Single Finger robot using pyBullet simulation.
 
@@ -35,6 +36,8 @@ PYBIND11_MODULE(pybullet_drivers, m)
                     executed by the backend.  If set to a value greater than
                     zero, the backend will automatically shut down after the
                     specified number of actions is executed.
+                control_period_s (float): Duration of one simulation step in
+                    seconds.
 
             Returns:
                 Finger backend using simulation instead of the real robot.
@@ -49,6 +52,7 @@ PYBIND11_MODULE(pybullet_drivers, m)
           "visualize"_a,
           "first_action_timeout"_a = std::numeric_limits<double>::infinity(),
           "max_number_of_actions"_a = 0,
+          "control_period_s"_a = 0.001,
           R"XXX(
             Create a backend for the TriFinger robot using pyBullet simulation.
 
@@ -66,6 +70,8 @@ PYBIND11_MODULE(pybullet_drivers, m)
                     executed by the backend.  If set to a value greater than
                     zero, the backend will automatically shut down after the
                     specified number of actions is executed.
+                control_period_s (float): Duration of one simulation step in
+                    seconds.
 
             Returns:
                 TriFinger backend using simulation instead of the real robot.
@@ -0,0 +1,245 @@
+/**
+ * @file
+ * @brief Simulated motor board to test the driver without hardware.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include <blmc_drivers/devices/motor.hpp>
+#include <blmc_drivers/devices/motor_board.hpp>
+
+/**
+ * @brief Motor board with two simulated motors.
+ *
+ * Each motor is modelled without inertia, i.e. its velocity is proportional to
+ * the current, and it stops at its end stops.  The simulation advances by one
+ * step each time new controls are sent, so one step corresponds to one cycle
+ * of the driver's control loop.  Measurements are appended after each step,
+ * so the driver can be used with Config::wait_for_new_measurement.
+ *
+ * Like on the real boards, positions are given in motor revolutions and
+ * velocities in revolutions per second.  The encoder index is reported when a
+ * motor passes it.
+ *
+ * All time series are allocated in the constructor, so the board can be used
+ * in tests that check for allocations in the control loop.
+ */
+class FakeMotorBoard : public blmc_drivers::MotorBoardInterface
+{
+public:
+    //! @brief State and parameters of one simulated motor.
+    struct SimulatedMotor
+    {
+        //! @brief Position [rev].
+        double position = 0.0;
+        //! @brief Velocity [rev/s].
+        double velocity = 0.0;
+        //! @brief Velocity per current [rev/s/A].
+        double velocity_per_current = 0.5;
+        //! @brief Position of the lower end stop [rev].
+        double lower_end_stop = -std::numeric_limits<double>::infinity();
+        //! @brief Position of the upper end stop [rev].
+        double upper_end_stop = std::numeric_limits<double>::infinity();
+        //! @brief Position of the encoder index within one revolution [rev].
+        double index_offset = 0.25;
+        /**
+         * @brief Number of steps with non-zero current before the motor starts
+         *        moving (e.g. to simulate static friction).
+         */
+        uint32_t start_delay_steps = 0;
+        //! @brief Number of steps with non-zero current so far.
+        uint32_t powered_steps = 0;
+    };
+
+    std::array<SimulatedMotor, 2> motors;
+
+    /**
+     * @param step_duration_s  Simulated duration of one step.  Should match
+     *     Config::control_period_s of the driver.
+     */
+    explicit FakeMotorBoard(double step_duration_s)
+        : step_duration_s_(step_duration_s),
+          status_(std::make_shared<StatusTimeseries>(HISTORY_LENGTH)),
+          command_(std::make_shared<CommandTimeseries>(HISTORY_LENGTH)),
+          control_(std::make_shared<ControlTimeseries>(HISTORY_LENGTH))
+    {
+        for (auto &measurement : measurements_)
+        {
+            measurement = std::make_shared<ScalarTimeseries>(HISTORY_LENGTH);
+        }
+
+        status_->append(blmc_drivers::MotorBoardStatus());
+        append_measurements();
+    }
+
+    //! @brief Report the given error code in the board status.
+    void set_error_code(uint8_t error_code)
+    {
+        blmc_drivers::MotorBoardStatus status;
+        status.error_code = error_code;
+        status_->append(status);
+    }
+
+    //! @brief Number of simulation steps so far.
+    uint64_t get_step_count() const
+    {
+        return step_count_;
+    }
+
+    void wait_until_ready()
+    {
+    }
+
+    bool is_ready()
+    {
+        return true;
+    }
+
+    void pause_motors()
+    {
+        set_control(0.0, current_target_0);
+        set_control(0.0, current_target_1);
+        send_if_input_changed();
+    }
+
+    std::shared_ptr<const ScalarTimeseries> get_measurement(
+        const int &index) const override
+    {
+        return measurements_[index];
+    }
+
+    std::shared_ptr<const StatusTimeseries> get_status() const override
+    {
+        return status_;
+    }
+
+    std::shared_ptr<const CommandTimeseries> get_command() const override
+    {
+        return command_;
+    }
+
+    std::shared_ptr<const ControlTimeseries> get_control() const override
+    {
+        return control_;
+    }
+
+    std::shared_ptr<const CommandTimeseries> get_sent_command() const override
+    {
+        return command_;
+    }
+
+    std::shared_ptr<const ControlTimeseries> get_sent_control() const override
+    {
+        return control_;
+    }
+
+    void set_command(const blmc_drivers::MotorBoardCommand &command) override
+    {
+        command_->append(command);
+    }
+
+    void set_control(const double &control, const int &index) override
+    {
+        current_[index] = control;
+        control_->append(current_);
+        has_new_control_ = true;
+    }
+
+    //! @brief Simulate one step if new controls have been set.
+    void send_if_input_changed() override
+    {
+        // called once per motor, but only the first call of a cycle has new
+        // controls
+        if (!has_new_control_)
+        {
+            return;
+        }
+        has_new_control_ = false;
+
+        for (size_t i = 0; i < motors.size(); i++)
+        {
+            step(&motors[i], current_[i], i);
+        }
+        step_count_++;
+        append_measurements();
+    }
+
+private:
+    static constexpr size_t HISTORY_LENGTH = 100;
+
+    const double step_duration_s_;
+    uint64_t step_count_ = 0;
+    Control current_ = {0.0, 0.0};
+    bool has_new_control_ = false;
+
+    std::array<std::shared_ptr<ScalarTimeseries>, measurement_count>
+        measurements_;
+    std::shared_ptr<StatusTimeseries> status_;
+    std::shared_ptr<CommandTimeseries> command_;
+    std::shared_ptr<ControlTimeseries> control_;
+
+    void step(SimulatedMotor *motor, double current, size_t index)
+    {
+        double velocity = 0.0;
+        if (current != 0.0)
+        {
+            if (motor->powered_steps >= motor->start_delay_steps)
+            {
+                velocity = motor->velocity_per_current * current;
+            }
+            motor->powered_steps++;
+        }
+
+        const double old_position = motor->position;
+        motor->position =
+            std::min(std::max(old_position + velocity * step_duration_s_,
+                              motor->lower_end_stop),
+                     motor->upper_end_stop);
+        motor->velocity = (motor->position - old_position) / step_duration_s_;
+
+        // report the index that was passed last
+        const double old_revolution =
+            std::floor(old_position - motor->index_offset);
+        const double revolution =
+            std::floor(motor->position - motor->index_offset);
+        if (revolution != old_revolution)
+        {
+            measurements_[encoder_index_0 + index]->append(
+                std::max(revolution, old_revolution) + motor->index_offset);
+        }
+    }
+
+    void append_measurements()
+    {
+        for (size_t i = 0; i < motors.size(); i++)
+        {
+            measurements_[current_0 + i]->append(current_[i]);
+            measurements_[position_0 + i]->append(motors[i].position);
+            measurements_[velocity_0 + i]->append(motors[i].velocity);
+        }
+    }
+};
+
+/**
+ * @brief Create the motors of the given boards (two per board).
+ *
+ * @tparam Motors  Array type of the motors (see NJointBlmcRobotDriver::Motors).
+ */
+template <typename Motors, typename MotorBoards>
+Motors create_fake_motors(const MotorBoards &boards)
+{
+    Motors motors;
+    for (size_t i = 0; i < motors.size(); i++)
+    {
+        motors[i] =
+            std::make_shared<blmc_drivers::Motor>(boards[i / 2], i % 2);
+    }
+    return motors;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @brief Tests for append_desired_actions().
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <robot_fingers/append_desired_actions.hpp>
+#include <robot_fingers/n_joint_blmc_robot_driver.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+
+using Driver = robot_fingers::SimpleNJointBlmcRobotDriver<2>;
+using Action = Driver::Action;
+using Vector = Action::Vector;
+using JointTrajectory = Driver::JointTrajectory;
+
+/**
+ * @brief Frontend that only stores the appended actions.
+ */
+struct FakeFrontend
+{
+    std::vector<Action> actions;
+    //! @brief Time index of the first appended action.
+    time_series::Index offset = 0;
+
+    time_series::Index append_desired_action(const Action &action)
+    {
+        actions.push_back(action);
+        return offset + static_cast<time_series::Index>(actions.size()) - 1;
+    }
+};
+
+TEST(TestAppendDesiredActions, all_fields)
+{
+    FakeFrontend frontend;
+    frontend.offset = 42;
+
+    Driver::ActionBatch batch;
+    batch.torque = JointTrajectory::Random(3, 2);
+    batch.position = JointTrajectory::Random(3, 2);
+    batch.position_kp = JointTrajectory::Random(3, 2);
+    batch.position_kd = JointTrajectory::Random(3, 2);
+
+    auto range =
+        robot_fingers::append_desired_actions<Action>(frontend, batch);
+
+    EXPECT_EQ(42, range.first);
+    EXPECT_EQ(45, range.second);
+    ASSERT_EQ(3u, frontend.actions.size());
+    for (size_t i = 0; i < 3; i++)
+    {
+        const Action &action = frontend.actions[i];
+        EXPECT_EQ(Vector(batch.torque.row(i)), action.torque);
+        EXPECT_EQ(Vector(batch.position.row(i)), action.position);
+        EXPECT_EQ(Vector(batch.position_kp.row(i)), action.position_kp);
+        EXPECT_EQ(Vector(batch.position_kd.row(i)), action.position_kd);
+    }
+}
+
+TEST(TestAppendDesiredActions, empty_fields_use_defaults)
+{
+    FakeFrontend frontend;
+
+    Driver::ActionBatch batch;
+    batch.position = JointTrajectory::Random(2, 2);
+
+    auto range =
+        robot_fingers::append_desired_actions<Action>(frontend, batch);
+
+    EXPECT_EQ(0, range.first);
+    EXPECT_EQ(2, range.second);
+    ASSERT_EQ(2u, frontend.actions.size());
+    for (size_t i = 0; i < 2; i++)
+    {
+        const Action &action = frontend.actions[i];
+        EXPECT_EQ(Vector::Zero(), action.torque);
+        EXPECT_EQ(Vector(batch.position.row(i)), action.position);
+        EXPECT_TRUE(action.position_kp.array().isNaN().all());
+        EXPECT_TRUE(action.position_kd.array().isNaN().all());
+    }
+}
+
+TEST(TestAppendDesiredActions, invalid_batch)
+{
+    FakeFrontend frontend;
+
+    Driver::ActionBatch batch;
+    EXPECT_THROW(robot_fingers::append_desired_actions<Action>(frontend, batch),
+                 std::invalid_argument);
+
+    batch.torque = JointTrajectory::Zero(3, 2);
+    batch.position_kd = JointTrajectory::Zero(2, 2);
+    EXPECT_THROW(robot_fingers::append_desired_actions<Action>(frontend, batch),
+                 std::invalid_argument);
+
+    // nothing is appended if the batch is invalid
+    EXPECT_TRUE(frontend.actions.empty());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
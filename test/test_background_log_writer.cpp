@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @brief Tests for the BackgroundLogWriter.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <robot_fingers/background_log_writer.hpp>
+
+using robot_fingers::BackgroundLogWriter;
+
+std::string read_file(const std::string &filename)
+{
+    std::ifstream file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+TEST(TestBackgroundLogWriter, append_and_flush)
+{
+    const std::string file_a = ::testing::TempDir() + "log_writer_a.txt";
+    const std::string file_b = ::testing::TempDir() + "log_writer_b.txt";
+    std::remove(file_a.c_str());
+    std::remove(file_b.c_str());
+
+    BackgroundLogWriter writer;
+    writer.append(file_a, "1\t42");
+    writer.append(file_b, "foo");
+    writer.append(file_a, "2\t43");
+    writer.flush();
+
+    ASSERT_EQ("1\t42\n2\t43\n", read_file(file_a));
+    ASSERT_EQ("foo\n", read_file(file_b));
+    ASSERT_EQ(0u, writer.get_failure_count());
+
+    std::remove(file_a.c_str());
+    std::remove(file_b.c_str());
+}
+
+TEST(TestBackgroundLogWriter, append_to_existing_file)
+{
+    const std::string filename = ::testing::TempDir() + "log_writer_c.txt";
+    {
+        std::ofstream file(filename);
+        file << "existing\n";
+    }
+
+    BackgroundLogWriter writer;
+    writer.append(filename, "new");
+    writer.flush();
+
+    ASSERT_EQ("existing\nnew\n", read_file(filename));
+    std::remove(filename.c_str());
+}
+
+TEST(TestBackgroundLogWriter, destructor_writes_pending_lines)
+{
+    const std::string filename = ::testing::TempDir() + "log_writer_d.txt";
+    std::remove(filename.c_str());
+
+    {
+        BackgroundLogWriter writer;
+        for (int i = 0; i < 100; i++)
+        {
+            writer.append(filename, std::to_string(i));
+        }
+    }
+
+    std::stringstream expected;
+    for (int i = 0; i < 100; i++)
+    {
+        expected << i << "\n";
+    }
+    ASSERT_EQ(expected.str(), read_file(filename));
+    std::remove(filename.c_str());
+}
+
+TEST(TestBackgroundLogWriter, failure)
+{
+    BackgroundLogWriter writer;
+    writer.append("/this/directory/does/not/exist/log.txt", "foo");
+    writer.flush();
+
+    ASSERT_EQ(1u, writer.get_failure_count());
+}
+
+TEST(TestBackgroundLogWriter, flush_without_lines)
+{
+    BackgroundLogWriter writer;
+    writer.flush();
+    ASSERT_EQ(0u, writer.get_failure_count());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @brief Tests for the binary config snapshots.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <robot_fingers/config_snapshot.hpp>
+
+using namespace robot_fingers;
+
+struct Item
+{
+    Eigen::Vector3d position = Eigen::Vector3d::Zero();
+    std::string name;
+
+    template <typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(position);
+        archive(name);
+    }
+};
+
+TEST(TestConfigSnapshot, fnv1a_hash)
+{
+    // reference values of the FNV-1a specification
+    ASSERT_EQ(0xcbf29ce484222325ULL, fnv1a_hash(""));
+    ASSERT_EQ(0xaf63dc4c8601ec8cULL, fnv1a_hash("a"));
+    ASSERT_NE(fnv1a_hash("foo: 1"), fnv1a_hash("foo: 2"));
+}
+
+TEST(TestConfigSnapshot, round_trip)
+{
+    std::array<std::string, 2> ports = {"can0", "can1"};
+    std::vector<std::vector<size_t>> groups = {{0, 2}, {}, {1}};
+    std::vector<Item> items(2);
+    items[0].position << 1.0, 2.0, 3.0;
+    items[0].name = "first";
+    items[1].name = "second";
+
+    SnapshotWriter writer;
+    writer(42.5);
+    writer(true);
+    writer(ports);
+    writer(groups);
+    writer(items);
+
+    double number = 0;
+    bool flag = false;
+    std::array<std::string, 2> ports_read;
+    std::vector<std::vector<size_t>> groups_read;
+    std::vector<Item> items_read;
+
+    SnapshotReader reader(writer.data().data(), writer.data().size());
+    reader(number);
+    reader(flag);
+    reader(ports_read);
+    reader(groups_read);
+    reader(items_read);
+
+    ASSERT_TRUE(reader.at_end());
+    ASSERT_EQ(42.5, number);
+    ASSERT_TRUE(flag);
+    ASSERT_EQ(ports, ports_read);
+    ASSERT_EQ(groups, groups_read);
+    ASSERT_EQ(2u, items_read.size());
+    ASSERT_EQ(items[0].position, items_read[0].position);
+    ASSERT_EQ("first", items_read[0].name);
+    ASSERT_EQ("second", items_read[1].name);
+}
+
+TEST(TestConfigSnapshot, truncated)
+{
+    SnapshotWriter writer;
+    writer(std::string("some text"));
+
+    for (size_t size = 0; size < writer.data().size(); size++)
+    {
+        std::string value;
+        SnapshotReader reader(writer.data().data(), size);
+        ASSERT_THROW(reader(value), std::runtime_error);
+    }
+}
+
+TEST(TestConfigSnapshot, corrupted_size)
+{
+    // a huge vector size must not result in a huge allocation
+    SnapshotWriter writer;
+    writer(static_cast<uint64_t>(1) << 60);
+
+    std::vector<double> values;
+    SnapshotReader reader(writer.data().data(), writer.data().size());
+    ASSERT_THROW(reader(values), std::runtime_error);
+}
+
+TEST(TestConfigSnapshot, save_and_map)
+{
+    const std::string filename = ::testing::TempDir() + "snapshot.bin";
+
+    SnapshotWriter writer;
+    writer(std::string("hello"));
+    writer(static_cast<uint32_t>(7));
+    writer.save(filename);
+
+    {
+        MappedFile file(filename);
+        ASSERT_EQ(writer.data().size(), file.size());
+
+        std::string text;
+        uint32_t number;
+        SnapshotReader reader(file.data(), file.size());
+        reader(text);
+        reader(number);
+        ASSERT_EQ("hello", text);
+        ASSERT_EQ(7u, number);
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestConfigSnapshot, map_missing_file)
+{
+    ASSERT_THROW(MappedFile("/this/file/does/not/exist"), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
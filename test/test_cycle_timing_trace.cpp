@@ -0,0 +1,204 @@
+/**
+ * @file
+ * @brief Tests for the cycle timing trace and its components.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <robot_fingers/cycle_timing_trace.hpp>
+#include <robot_fingers/latency_histogram.hpp>
+#include <robot_fingers/spsc_ring_buffer.hpp>
+
+using namespace robot_fingers;
+
+TEST(TestSpscRingBuffer, push_pop)
+{
+    SpscRingBuffer<int> buffer(3);
+    ASSERT_EQ(3u, buffer.capacity());
+
+    int value = 0;
+    ASSERT_FALSE(buffer.try_pop(&value));
+
+    ASSERT_TRUE(buffer.try_push(1));
+    ASSERT_TRUE(buffer.try_push(2));
+    ASSERT_TRUE(buffer.try_push(3));
+    // buffer is full
+    ASSERT_FALSE(buffer.try_push(4));
+
+    ASSERT_TRUE(buffer.try_pop(&value));
+    ASSERT_EQ(1, value);
+
+    // wrap around
+    ASSERT_TRUE(buffer.try_push(5));
+
+    ASSERT_TRUE(buffer.try_pop(&value));
+    ASSERT_EQ(2, value);
+    ASSERT_TRUE(buffer.try_pop(&value));
+    ASSERT_EQ(3, value);
+    ASSERT_TRUE(buffer.try_pop(&value));
+    ASSERT_EQ(5, value);
+    ASSERT_FALSE(buffer.try_pop(&value));
+}
+
+TEST(TestSpscRingBuffer, two_threads)
+{
+    constexpr int NUM_ELEMENTS = 100000;
+    SpscRingBuffer<int> buffer(64);
+
+    std::thread producer([&buffer]() {
+        for (int i = 0; i < NUM_ELEMENTS; i++)
+        {
+            while (!buffer.try_push(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // elements need to arrive complete and in order
+    for (int i = 0; i < NUM_ELEMENTS; i++)
+    {
+        int value;
+        while (!buffer.try_pop(&value))
+        {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(i, value);
+    }
+
+    producer.join();
+}
+
+TEST(TestLatencyHistogram, empty)
+{
+    LatencyHistogram histogram;
+    ASSERT_EQ(0u, histogram.get_count());
+    ASSERT_EQ(0, histogram.get_min());
+    ASSERT_EQ(0, histogram.get_max());
+    ASSERT_EQ(0, histogram.get_value_at_percentile(50));
+}
+
+TEST(TestLatencyHistogram, small_values_exact)
+{
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 50; i++)
+    {
+        histogram.record(i);
+    }
+
+    ASSERT_EQ(50u, histogram.get_count());
+    ASSERT_EQ(1, histogram.get_min());
+    ASSERT_EQ(50, histogram.get_max());
+    ASSERT_DOUBLE_EQ(25.5, histogram.get_mean());
+    ASSERT_EQ(25, histogram.get_value_at_percentile(50));
+    ASSERT_EQ(50, histogram.get_value_at_percentile(100));
+}
+
+TEST(TestLatencyHistogram, relative_error)
+{
+    LatencyHistogram histogram;
+    for (int64_t i = 1; i <= 10000; i++)
+    {
+        histogram.record(i * 1000);
+    }
+
+    const double max_relative_error =
+        1.0 / LatencyHistogram::SUB_BUCKET_COUNT;
+    for (double percentile : {10.0, 50.0, 90.0, 99.0, 99.9})
+    {
+        const double expected = percentile * 100 * 1000;
+        const double actual = histogram.get_value_at_percentile(percentile);
+        EXPECT_GE(actual, expected) << "percentile " << percentile;
+        EXPECT_LE(actual, expected * (1 + max_relative_error))
+            << "percentile " << percentile;
+    }
+
+    ASSERT_EQ(10000000, histogram.get_max());
+    ASSERT_EQ(10000000, histogram.get_value_at_percentile(100));
+
+    histogram.reset();
+    ASSERT_EQ(0u, histogram.get_count());
+}
+
+TEST(TestCycleTimingTrace, record_and_drain)
+{
+    const std::string filename = ::testing::TempDir() + "timing_trace.txt";
+
+    {
+        CycleTimingTrace trace(16, filename);
+
+        for (uint64_t i = 0; i < 20; i++)
+        {
+            CycleTimingTrace::CycleTimestamps ts;
+            ts.cycle = i;
+            ts.start_ns = i * 1000000;
+            ts.observation_ns = ts.start_ns + 10000;
+            ts.processing_ns = ts.observation_ns + 5000;
+            ts.send_ns = ts.processing_ns + 20000;
+            ts.end_ns = ts.start_ns + 1000000;
+            trace.record(ts);
+        }
+
+        // buffer capacity is 16, so the remaining 4 are dropped
+        ASSERT_EQ(4u, trace.get_dropped_count());
+        ASSERT_EQ(16u, trace.drain());
+        trace.stop();
+
+        using Phase = CycleTimingTrace::Phase;
+        ASSERT_EQ(16u, trace.get_histogram(Phase::CYCLE).get_count());
+        ASSERT_EQ(15u, trace.get_histogram(Phase::PERIOD).get_count());
+        ASSERT_EQ(10000, trace.get_histogram(Phase::OBSERVATION).get_max());
+        ASSERT_EQ(5000, trace.get_histogram(Phase::PROCESSING).get_max());
+        ASSERT_EQ(20000, trace.get_histogram(Phase::SEND).get_max());
+        ASSERT_EQ(965000, trace.get_histogram(Phase::SLEEP).get_min());
+        ASSERT_EQ(1000000, trace.get_histogram(Phase::PERIOD).get_min());
+
+        std::stringstream summary;
+        trace.print_summary(summary);
+        ASSERT_NE(std::string::npos, summary.str().find("observation"));
+    }
+
+    // header plus one line per processed cycle
+    std::ifstream file(filename);
+    std::string line;
+    int num_lines = 0;
+    while (std::getline(file, line))
+    {
+        num_lines++;
+    }
+    ASSERT_EQ(17, num_lines);
+    std::remove(filename.c_str());
+}
+
+TEST(TestCycleTimingTrace, reader_thread)
+{
+    CycleTimingTrace trace(16);
+    trace.start(0.001);
+
+    // more records than fit into the buffer, the reader needs to keep up
+    for (uint64_t i = 0; i < 100; i++)
+    {
+        CycleTimingTrace::CycleTimestamps ts;
+        ts.cycle = i;
+        trace.record(ts);
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    trace.stop();
+
+    using Phase = CycleTimingTrace::Phase;
+    ASSERT_EQ(100u,
+              trace.get_histogram(Phase::CYCLE).get_count() +
+                  trace.get_dropped_count());
+    ASSERT_GT(trace.get_histogram(Phase::CYCLE).get_count(), 16u);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,200 @@
+/**
+ * @file
+ * @brief Tests for the homing cache.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+#include <robot_fingers/homing_cache.hpp>
+
+using robot_fingers::HomingCache;
+
+typedef HomingCache<3> Cache;
+
+constexpr double TOLERANCE = 0.01;
+constexpr double INDEX_SPACING = 2 * M_PI / 9.0;
+
+Cache create_cache()
+{
+    Cache cache;
+    cache.homing_method = "endstop_release";
+    cache.home_offset_rad << 0.1, -0.2, 0.3;
+    cache.zero_angles << 1.0, 2.0, 3.0;
+    cache.raw_position << 0.5, 1.5, -2.5;
+    cache.raw_index_angles << 0.2,
+        std::numeric_limits<double>::quiet_NaN(), 0.4;
+    return cache;
+}
+
+bool is_valid(const Cache &cache,
+              const std::string &method,
+              const Cache::Vector &offset,
+              const Cache::Vector &position,
+              const Cache::Vector &index_angles)
+{
+    return cache.is_valid(
+        method, offset, position, index_angles, TOLERANCE, INDEX_SPACING);
+}
+
+TEST(TestHomingCache, save_and_load)
+{
+    const std::string filename = ::testing::TempDir() + "homing_cache.yml";
+    const Cache cache = create_cache();
+
+    cache.save(filename);
+    Cache loaded = Cache::load(filename);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(cache.homing_method, loaded.homing_method);
+    ASSERT_TRUE(cache.home_offset_rad.isApprox(loaded.home_offset_rad));
+    ASSERT_TRUE(cache.zero_angles.isApprox(loaded.zero_angles));
+    ASSERT_TRUE(cache.raw_position.isApprox(loaded.raw_position));
+    ASSERT_DOUBLE_EQ(cache.raw_index_angles[0], loaded.raw_index_angles[0]);
+    ASSERT_TRUE(std::isnan(loaded.raw_index_angles[1]));
+}
+
+TEST(TestHomingCache, load_missing_file)
+{
+    ASSERT_THROW(Cache::load("/this/file/does/not/exist.yml"),
+                 std::runtime_error);
+}
+
+TEST(TestHomingCache, valid)
+{
+    const Cache cache = create_cache();
+    Cache::Vector no_index =
+        Cache::Vector::Constant(std::numeric_limits<double>::quiet_NaN());
+    std::string reason = "foo";
+
+    ASSERT_TRUE(cache.is_valid(cache.homing_method,
+                               cache.home_offset_rad,
+                               cache.raw_position,
+                               no_index,
+                               TOLERANCE,
+                               INDEX_SPACING,
+                               &reason));
+    ASSERT_EQ("", reason);
+
+    // small deviation within tolerance
+    Cache::Vector position = cache.raw_position;
+    position[2] += 0.5 * TOLERANCE;
+    ASSERT_TRUE(is_valid(cache,
+                         cache.homing_method,
+                         cache.home_offset_rad,
+                         position,
+                         no_index));
+}
+
+TEST(TestHomingCache, config_changed)
+{
+    const Cache cache = create_cache();
+    Cache::Vector offset = cache.home_offset_rad;
+    offset[1] += 0.1;
+
+    ASSERT_FALSE(is_valid(cache,
+                          "endstop",
+                          cache.home_offset_rad,
+                          cache.raw_position,
+                          cache.raw_index_angles));
+    ASSERT_FALSE(is_valid(cache,
+                          cache.homing_method,
+                          offset,
+                          cache.raw_position,
+                          cache.raw_index_angles));
+}
+
+TEST(TestHomingCache, position_changed)
+{
+    const Cache cache = create_cache();
+    Cache::Vector position = cache.raw_position;
+    position[1] += 2 * TOLERANCE;
+    std::string reason;
+
+    ASSERT_FALSE(cache.is_valid(cache.homing_method,
+                                cache.home_offset_rad,
+                                position,
+                                cache.raw_index_angles,
+                                TOLERANCE,
+                                INDEX_SPACING,
+                                &reason));
+    ASSERT_EQ("Position of joint 1 changed.", reason);
+
+    // power cycle of the boards resets the position
+    ASSERT_FALSE(is_valid(cache,
+                          cache.homing_method,
+                          cache.home_offset_rad,
+                          Cache::Vector::Zero(),
+                          cache.raw_index_angles));
+}
+
+TEST(TestHomingCache, index_angles)
+{
+    const Cache cache = create_cache();
+
+    // index of the next motor revolution is fine
+    Cache::Vector index_angles = cache.raw_index_angles;
+    index_angles[0] += INDEX_SPACING;
+    index_angles[2] -= 2 * INDEX_SPACING;
+    ASSERT_TRUE(is_valid(cache,
+                         cache.homing_method,
+                         cache.home_offset_rad,
+                         cache.raw_position,
+                         index_angles));
+
+    // joint 1 has no stored index angle, so any value is accepted
+    index_angles[1] = 0.3;
+    ASSERT_TRUE(is_valid(cache,
+                         cache.homing_method,
+                         cache.home_offset_rad,
+                         cache.raw_position,
+                         index_angles));
+
+    // index at a different position of the motor revolution
+    index_angles[2] += 0.5 * INDEX_SPACING;
+    ASSERT_FALSE(is_valid(cache,
+                          cache.homing_method,
+                          cache.home_offset_rad,
+                          cache.raw_position,
+                          index_angles));
+}
+
+TEST(TestHomingCache, matches_index_angles)
+{
+    Cache cache = create_cache();
+    cache.raw_index_angles[1] = 0.3;
+    std::string reason = "foo";
+
+    Cache::Vector index_angles = cache.raw_index_angles;
+    index_angles[0] += INDEX_SPACING;
+    ASSERT_TRUE(cache.matches_index_angles(
+        index_angles, TOLERANCE, INDEX_SPACING, &reason));
+    ASSERT_EQ("", reason);
+
+    // all joints need an index
+    index_angles[2] = std::numeric_limits<double>::quiet_NaN();
+    ASSERT_FALSE(cache.matches_index_angles(
+        index_angles, TOLERANCE, INDEX_SPACING, &reason));
+    ASSERT_EQ("Encoder index of joint 2 not found.", reason);
+
+    index_angles[2] = cache.raw_index_angles[2] + 0.5 * INDEX_SPACING;
+    ASSERT_FALSE(cache.matches_index_angles(
+        index_angles, TOLERANCE, INDEX_SPACING, &reason));
+    ASSERT_EQ("Encoder index of joint 2 moved.", reason);
+
+    // also if none was stored
+    cache.raw_index_angles[1] = std::numeric_limits<double>::quiet_NaN();
+    ASSERT_FALSE(cache.matches_index_angles(
+        cache.raw_index_angles, TOLERANCE, INDEX_SPACING, &reason));
+    ASSERT_EQ("No encoder index of joint 1 stored.", reason);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
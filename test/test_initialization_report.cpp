@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Tests for the InitializationReport.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <robot_fingers/initialization_report.hpp>
+
+using robot_fingers::InitializationReport;
+
+TEST(TestInitializationReport, empty_to_json)
+{
+    InitializationReport report;
+
+    ASSERT_EQ(
+        "{\n"
+        "  \"board_bring_up_s\": null,\n"
+        "  \"endstop_search_s\": null,\n"
+        "  \"zero_torque_release_s\": null,\n"
+        "  \"index_search_s\": null,\n"
+        "  \"initial_moves\": [],\n"
+        "  \"total_s\": null,\n"
+        "  \"homing_restored_from_cache\": false,\n"
+        "  \"homing_succeeded\": false,\n"
+        "  \"reached_initial_position\": false\n"
+        "}",
+        report.to_json());
+}
+
+TEST(TestInitializationReport, to_json)
+{
+    InitializationReport report;
+    report.board_bring_up_s = 0.5;
+    report.endstop_search_s = 1.25;
+    report.zero_torque_release_s = 1.0;
+    report.initial_moves.push_back({{0, 3}, 0.75});
+    report.initial_moves.push_back({{1}, 0.5});
+    report.total_s = 3.5;
+    report.homing_succeeded = true;
+    report.reached_initial_position = true;
+
+    ASSERT_EQ(
+        "{\n"
+        "  \"board_bring_up_s\": 0.500000,\n"
+        "  \"endstop_search_s\": 1.250000,\n"
+        "  \"zero_torque_release_s\": 1.000000,\n"
+        "  \"index_search_s\": null,\n"
+        "  \"initial_moves\": [\n"
+        "    {\"joints\": [0, 3], \"duration_s\": 0.750000},\n"
+        "    {\"joints\": [1], \"duration_s\": 0.500000}\n"
+        "  ],\n"
+        "  \"total_s\": 3.500000,\n"
+        "  \"homing_restored_from_cache\": false,\n"
+        "  \"homing_succeeded\": true,\n"
+        "  \"reached_initial_position\": true\n"
+        "}",
+        report.to_json());
+}
+
+TEST(TestInitializationReport, write_json)
+{
+    const std::string filename = ::testing::TempDir() + "init_report.json";
+    InitializationReport report;
+    report.total_s = 2.0;
+
+    report.write_json(filename);
+
+    std::ifstream file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(report.to_json() + "\n", content.str());
+}
+
+TEST(TestInitializationReport, write_json_failure)
+{
+    InitializationReport report;
+    ASSERT_THROW(report.write_json("/this/directory/does/not/exist.json"),
+                 std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
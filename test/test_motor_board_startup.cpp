@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief Tests for the concurrent bring-up of motor boards.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+#include <robot_fingers/motor_board_startup.hpp>
+
+using robot_fingers::bring_up_motor_boards;
+
+/**
+ * @brief Fake board that gets ready after a fixed time.
+ */
+class FakeBoard
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit FakeBoard(double startup_duration_s)
+        : ready_time_(Clock::now() +
+                      std::chrono::duration_cast<Clock::duration>(
+                          std::chrono::duration<double>(startup_duration_s)))
+    {
+    }
+
+    bool is_ready() const
+    {
+        return Clock::now() >= ready_time_;
+    }
+
+private:
+    Clock::time_point ready_time_;
+};
+
+//! Create fake boards with startup duration depending on the port name.
+std::shared_ptr<FakeBoard> create_fake_board(const std::string &can_port)
+{
+    if (can_port == "missing")
+    {
+        throw std::runtime_error("no such device");
+    }
+    else if (can_port == "slow")
+    {
+        return std::make_shared<FakeBoard>(10.0);
+    }
+    return std::make_shared<FakeBoard>(0.2);
+}
+
+TEST(TestMotorBoardStartup, boards_start_concurrently)
+{
+    std::array<std::string, 4> ports = {"can0", "can1", "can2", "can3"};
+
+    auto start = std::chrono::steady_clock::now();
+    auto boards = bring_up_motor_boards<FakeBoard>(
+        ports, create_fake_board, std::numeric_limits<double>::infinity());
+    double duration_s = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+    for (const auto &board : boards)
+    {
+        ASSERT_TRUE(board);
+        EXPECT_TRUE(board->is_ready());
+    }
+    // one after the other would take at least 0.8 s
+    EXPECT_LT(duration_s, 0.6);
+}
+
+TEST(TestMotorBoardStartup, timeout_names_slow_port)
+{
+    std::array<std::string, 3> ports = {"can0", "slow", "can2"};
+
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        bring_up_motor_boards<FakeBoard>(ports, create_fake_board, 0.5);
+        FAIL() << "Expected std::runtime_error";
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::string msg = e.what();
+        EXPECT_NE(std::string::npos, msg.find("slow"));
+        EXPECT_EQ(std::string::npos, msg.find("can0"));
+        EXPECT_EQ(std::string::npos, msg.find("can2"));
+    }
+    double duration_s = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    EXPECT_LT(duration_s, 2.0);
+}
+
+TEST(TestMotorBoardStartup, failing_board_names_port)
+{
+    std::array<std::string, 2> ports = {"can0", "missing"};
+
+    try
+    {
+        bring_up_motor_boards<FakeBoard>(ports, create_fake_board, 5.0);
+        FAIL() << "Expected std::runtime_error";
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::string msg = e.what();
+        EXPECT_NE(std::string::npos, msg.find("missing"));
+        EXPECT_EQ(std::string::npos, msg.find("can0"));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
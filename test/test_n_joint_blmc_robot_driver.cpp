@@ -4,8 +4,17 @@
  * @copyright Copyright (c) 2020, New York University & Max Planck Gesellschaft.
  */
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <robot_fingers/homing_cache.hpp>
 #include <robot_fingers/n_joint_blmc_robot_driver.hpp>
 
+#include "fake_motor_board.hpp"
+
 using Driver = robot_fingers::SimpleNJointBlmcRobotDriver<2>;
 
 TEST(TestNJointBlmcRobotDriverConfig, is_within_joint_limits)
@@ -39,6 +48,685 @@ TEST(TestNJointBlmcRobotDriverConfig, is_within_joint_limits)
     ASSERT_FALSE(config.is_within_hard_position_limits(Driver::Vector(1, 0.5)));
 }
 
+TEST(TestNJointBlmcRobotDriverConfig, initial_move_plan)
+{
+    using Config = robot_fingers::SimpleNJointBlmcRobotDriver<3>::Config;
+    using Plan = std::vector<std::vector<size_t>>;
+
+    Config config;
+    ASSERT_EQ(Plan({{0}, {1}, {2}}), config.get_initial_move_plan());
+
+    config.initial_move_order = Config::InitialMoveOrder::SIMULTANEOUS;
+    ASSERT_EQ(Plan({{0, 1, 2}}), config.get_initial_move_plan());
+
+    config.initial_move_order = Config::InitialMoveOrder::GROUPS;
+    config.initial_move_groups = {{2}, {0, 1}};
+    ASSERT_EQ(Plan({{2}, {0, 1}}), config.get_initial_move_plan());
+}
+
+TEST(TestNJointBlmcRobotDriverConfig, validate_initial_move_groups)
+{
+    using Config = robot_fingers::SimpleNJointBlmcRobotDriver<3>::Config;
+
+    ASSERT_NO_THROW(Config::validate_initial_move_groups({{0, 1, 2}}));
+    ASSERT_NO_THROW(Config::validate_initial_move_groups({{1}, {2, 0}}));
+
+    // joint missing
+    ASSERT_THROW(Config::validate_initial_move_groups({{0}, {2}}),
+                 std::invalid_argument);
+    // joint in multiple groups
+    ASSERT_THROW(Config::validate_initial_move_groups({{0, 1}, {1, 2}}),
+                 std::invalid_argument);
+    // invalid joint index
+    ASSERT_THROW(Config::validate_initial_move_groups({{0, 1, 2, 3}}),
+                 std::invalid_argument);
+    // empty group
+    ASSERT_THROW(Config::validate_initial_move_groups({{0, 1, 2}, {}}),
+                 std::invalid_argument);
+}
+
+TEST(TestNJointBlmcRobotDriverConfig, initial_move_order_names)
+{
+    using Config = robot_fingers::SimpleNJointBlmcRobotDriver<3>::Config;
+
+    for (auto order : {Config::InitialMoveOrder::JOINT_BY_JOINT,
+                       Config::InitialMoveOrder::SIMULTANEOUS,
+                       Config::InitialMoveOrder::GROUPS})
+    {
+        ASSERT_EQ(order,
+                  Config::parse_initial_move_order_name(
+                      Config::get_initial_move_order_name(order)));
+    }
+    ASSERT_THROW(Config::parse_initial_move_order_name("foo"),
+                 std::invalid_argument);
+}
+
+namespace
+{
+const char *TWO_JOINT_CONFIG = R"(
+can_ports: ["can0"]
+max_current_A: 2
+has_endstop: false
+move_to_position_tolerance_rad: 0.05
+safety_kd: [0.08, 0.08]
+position_control_gains:
+    kp: [3, 3]
+    kd: [0.03, 0.03]
+hard_position_limits_lower: [-1.0, -2.0]
+hard_position_limits_upper: [1.0, 2.0]
+home_offset_rad: [0.5, 0.25]
+initial_position_rad: [0, 0.1]
+)";
+
+void write_file(const std::string &filename, const std::string &content)
+{
+    std::ofstream file(filename);
+    file << content;
+}
+}  // namespace
+
+TEST(TestNJointBlmcRobotDriverConfig, parse_config_collects_errors)
+{
+    YAML::Node node = YAML::Load(TWO_JOINT_CONFIG);
+    node["max_current_A"] = "foo";
+    node["safety_kd"] = "bar";
+    node["shutdown_timeout_s"] = -1.0;
+
+    std::vector<std::string> errors;
+    Driver::Config::parse_config(node, &errors);
+
+    // all problems are reported, not only the first one
+    ASSERT_EQ(3u, errors.size());
+    ASSERT_EQ("Failed to load parameter 'max_current_A'.", errors[0]);
+    ASSERT_EQ("Failed to load parameter 'safety_kd'.", errors[1]);
+    ASSERT_EQ("shutdown_timeout_s needs to be positive.", errors[2]);
+}
+
+TEST(TestNJointBlmcRobotDriverConfig, try_load_config_invalid)
+{
+    const std::string filename = ::testing::TempDir() + "invalid_config.yml";
+    write_file(filename, "max_current_A: foo\nsafety_kd: bar\n");
+
+    try
+    {
+        Driver::Config::try_load_config(filename);
+        FAIL() << "Expected std::invalid_argument";
+    }
+    catch (const std::invalid_argument &e)
+    {
+        const std::string msg = e.what();
+        EXPECT_NE(std::string::npos, msg.find("'max_current_A'"));
+        EXPECT_NE(std::string::npos, msg.find("'safety_kd'"));
+    }
+
+    ASSERT_THROW(Driver::Config::try_load_config("/does/not/exist.yml"),
+                 std::invalid_argument);
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestNJointBlmcRobotDriverConfig, snapshot_round_trip)
+{
+    std::vector<std::string> errors;
+    const Driver::Config config =
+        Driver::Config::parse_config(YAML::Load(TWO_JOINT_CONFIG), &errors);
+    ASSERT_TRUE(errors.empty());
+
+    const std::string filename = ::testing::TempDir() + "config_snapshot.bin";
+    config.save_snapshot(filename, 42);
+
+    const Driver::Config loaded = Driver::Config::load_snapshot(filename, 42);
+    ASSERT_EQ(config.can_ports, loaded.can_ports);
+    ASSERT_EQ(config.max_current_A, loaded.max_current_A);
+    ASSERT_EQ(config.safety_kd, loaded.safety_kd);
+    ASSERT_EQ(config.hard_position_limits_upper,
+              loaded.hard_position_limits_upper);
+    ASSERT_EQ(config.home_offset_rad, loaded.home_offset_rad);
+    ASSERT_EQ(config.initial_position_rad, loaded.initial_position_rad);
+    ASSERT_EQ(config.homing_method, loaded.homing_method);
+
+    // snapshot of a different file content
+    ASSERT_THROW(Driver::Config::load_snapshot(filename, 43),
+                 std::runtime_error);
+    // snapshot of a different robot type
+    ASSERT_THROW(
+        robot_fingers::SimpleNJointBlmcRobotDriver<3>::Config::load_snapshot(
+            filename, 42),
+        std::runtime_error);
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestNJointBlmcRobotDriverConfig, try_load_config_uses_snapshot)
+{
+    const std::string cache_dir = ::testing::TempDir();
+    const std::string filename = cache_dir + "two_joint_config.yml";
+    write_file(filename, TWO_JOINT_CONFIG);
+
+    const std::string snapshot =
+        Driver::Config::get_snapshot_path(cache_dir, TWO_JOINT_CONFIG);
+    std::remove(snapshot.c_str());
+
+    setenv(Driver::Config::CONFIG_CACHE_DIR_ENV, cache_dir.c_str(), 1);
+
+    // first load creates the snapshot
+    const Driver::Config config = Driver::Config::try_load_config(filename);
+    ASSERT_TRUE(std::ifstream(snapshot).good());
+
+    // second load uses it, so modifying it is visible in the result
+    Driver::Config modified = config;
+    modified.max_current_A = 1.5;
+    modified.save_snapshot(snapshot,
+                           robot_fingers::fnv1a_hash(TWO_JOINT_CONFIG));
+    ASSERT_EQ(1.5, Driver::Config::try_load_config(filename).max_current_A);
+
+    // a corrupted snapshot is ignored and replaced
+    write_file(snapshot, "garbage");
+    ASSERT_EQ(config.max_current_A,
+              Driver::Config::try_load_config(filename).max_current_A);
+    ASSERT_NO_THROW(Driver::Config::load_snapshot(
+        snapshot, robot_fingers::fnv1a_hash(TWO_JOINT_CONFIG)));
+
+    unsetenv(Driver::Config::CONFIG_CACHE_DIR_ENV);
+    std::remove(snapshot.c_str());
+    std::remove(filename.c_str());
+}
+
+TEST(TestNJointBlmcRobotDriverConfig, trajectory_dependencies)
+{
+    using Config = robot_fingers::SimpleNJointBlmcRobotDriver<3>::Config;
+    using Dependencies = std::vector<std::vector<size_t>>;
+
+    std::vector<Config::TrajectoryStep> trajectory(6);
+    trajectory[0].joints = {0};
+    trajectory[1].joints = {1, 2};
+    trajectory[2].joints = {0};
+    // all joints
+    trajectory[3].joints = {};
+    trajectory[4].joints = {2};
+    trajectory[5].joints = {1, 2};
+
+    // steps of different joints do not depend on each other, a step of all
+    // joints waits for all previous steps
+    ASSERT_EQ(Dependencies({{}, {}, {0}, {1, 2}, {3}, {3, 4}}),
+              Config::get_trajectory_dependencies(trajectory));
+
+    ASSERT_EQ(Dependencies(),
+              Config::get_trajectory_dependencies(
+                  std::vector<Config::TrajectoryStep>()));
+}
+
+TEST(TestNJointBlmcRobotDriverConfig, shutdown_trajectory_joints)
+{
+    YAML::Node node = YAML::Load(TWO_JOINT_CONFIG);
+    node["move_to_position_max_velocity_radps"] = 1.0;
+    node["shutdown_trajectory"] = YAML::Load(R"(
+- target_position_rad: [0.5]
+  joints: [1]
+- target_position_rad: [0.1, 0.2]
+  move_steps: 100
+)");
+
+    std::vector<std::string> errors;
+    Driver::Config config = Driver::Config::parse_config(node, &errors);
+    ASSERT_TRUE(errors.empty());
+    ASSERT_EQ(2u, config.shutdown_trajectory.size());
+
+    const auto &first = config.shutdown_trajectory[0];
+    ASSERT_EQ(std::vector<size_t>({1}), first.joints);
+    ASSERT_EQ(0.5, first.target_position_rad[1]);
+    ASSERT_EQ(0u, first.move_steps);
+    ASSERT_FALSE(first.moves_joint(0));
+    ASSERT_TRUE(first.moves_joint(1));
+
+    const auto &second = config.shutdown_trajectory[1];
+    ASSERT_TRUE(second.joints.empty());
+    ASSERT_EQ(Driver::Vector(0.1, 0.2), second.target_position_rad);
+    ASSERT_EQ(100u, second.move_steps);
+    ASSERT_TRUE(second.moves_joint(0));
+    ASSERT_TRUE(second.moves_joint(1));
+}
+
+TEST(TestNJointBlmcRobotDriverConfig, shutdown_trajectory_invalid)
+{
+    YAML::Node node = YAML::Load(TWO_JOINT_CONFIG);
+    node["shutdown_trajectory"] = YAML::Load(R"(
+# move_steps required without velocity limit
+- target_position_rad: [0.1, 0.2]
+# invalid joint index
+- target_position_rad: [0.5]
+  joints: [2]
+  move_steps: 100
+# duplicate joint
+- target_position_rad: [0.5, 0.5]
+  joints: [1, 1]
+  move_steps: 100
+# wrong number of targets
+- target_position_rad: [0.5, 0.5]
+  joints: [0]
+  move_steps: 100
+)");
+
+    std::vector<std::string> errors;
+    Driver::Config::parse_config(node, &errors);
+    ASSERT_EQ(4u, errors.size());
+    EXPECT_EQ(0u, errors[0].find("shutdown_trajectory[0]: "));
+    EXPECT_EQ(0u, errors[1].find("shutdown_trajectory[1]: "));
+    EXPECT_EQ(0u, errors[2].find("shutdown_trajectory[2]: "));
+    EXPECT_EQ(0u, errors[3].find("shutdown_trajectory[3]: "));
+}
+
+TEST(TestNJointBlmcRobotDriver, min_jerk_duration_steps)
+{
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    constexpr double PERIOD = 0.001;
+
+    // no limits: use the given number of steps
+    ASSERT_EQ(500u,
+              Driver::get_min_jerk_duration_steps(
+                  Driver::Vector(1.0, 0.0), INF, INF, PERIOD, 500));
+
+    // velocity limited: T = 1.875 * D / v
+    ASSERT_EQ(375u,
+              Driver::get_min_jerk_duration_steps(
+                  Driver::Vector(0.5, -1.0), 5.0, INF, PERIOD, 1000));
+
+    // acceleration limited: T = sqrt(10 / sqrt(3) * D / a)
+    ASSERT_EQ(std::ceil(std::sqrt(10.0 / std::sqrt(3.0) * 0.4 / 10.0) / PERIOD),
+              Driver::get_min_jerk_duration_steps(
+                  Driver::Vector(0.1, 0.4), INF, 10.0, PERIOD, 1000));
+
+    // the longer of both is used
+    ASSERT_EQ(375u,
+              Driver::get_min_jerk_duration_steps(
+                  Driver::Vector(0.5, -1.0), 5.0, 1000.0, PERIOD, 1000));
+
+    // bounded by the given number of steps
+    ASSERT_EQ(100u,
+              Driver::get_min_jerk_duration_steps(
+                  Driver::Vector(0.5, -1.0), 5.0, INF, PERIOD, 100));
+
+    // already at the goal
+    ASSERT_EQ(0u,
+              Driver::get_min_jerk_duration_steps(
+                  Driver::Vector(0.0, 0.0), 5.0, 10.0, PERIOD, 500));
+}
+
+TEST(TestNJointBlmcRobotDriverRuntimeParameters, from_config)
+{
+    Driver::Config config;
+    config.position_control_gains.kp << 1.0, 2.0;
+    config.position_control_gains.kd << 0.1, 0.2;
+    config.safety_kd << 0.01, 0.02;
+    config.soft_position_limits_lower << -1.0, -2.0;
+    config.soft_position_limits_upper << 1.0, 2.0;
+
+    auto parameters = Driver::RuntimeParameters::from_config(config);
+
+    ASSERT_EQ(config.position_control_gains.kp, parameters.position_control_kp);
+    ASSERT_EQ(config.position_control_gains.kd, parameters.position_control_kd);
+    ASSERT_EQ(config.safety_kd, parameters.safety_kd);
+    ASSERT_EQ(config.soft_position_limits_lower,
+              parameters.soft_position_limits_lower);
+    ASSERT_EQ(config.soft_position_limits_upper,
+              parameters.soft_position_limits_upper);
+    ASSERT_NO_THROW(parameters.validate());
+}
+
+TEST(TestNJointBlmcRobotDriverRuntimeParameters, validate)
+{
+    Driver::RuntimeParameters parameters;
+    ASSERT_NO_THROW(parameters.validate());
+
+    parameters.position_control_kp << 1.0, -1.0;
+    ASSERT_THROW(parameters.validate(), std::invalid_argument);
+    parameters.position_control_kp << 1.0, 1.0;
+
+    parameters.position_control_kd[0] = std::nan("");
+    ASSERT_THROW(parameters.validate(), std::invalid_argument);
+    parameters.position_control_kd[0] = 0.0;
+
+    parameters.safety_kd[1] = -0.1;
+    ASSERT_THROW(parameters.validate(), std::invalid_argument);
+    parameters.safety_kd[1] = 0.1;
+
+    // equal limits are allowed
+    parameters.soft_position_limits_lower << 0.5, 0.0;
+    parameters.soft_position_limits_upper << 0.5, 1.0;
+    ASSERT_NO_THROW(parameters.validate());
+
+    parameters.soft_position_limits_lower << 0.6, 0.0;
+    ASSERT_THROW(parameters.validate(), std::invalid_argument);
+}
+
+TEST(TestNJointBlmcRobotDriverErrorState, no_error)
+{
+    Driver::ErrorState error_state;
+
+    ASSERT_FALSE(error_state.has_error());
+    ASSERT_EQ("", error_state.to_string());
+}
+
+TEST(TestNJointBlmcRobotDriverErrorState, board_errors)
+{
+    using ErrorCodes = blmc_drivers::MotorBoardStatus::ErrorCodes;
+
+    robot_fingers::SimpleNJointBlmcRobotDriver<4, 2>::ErrorState error_state;
+
+    error_state.board_error_codes[1] = ErrorCodes::CRIT_TEMP;
+    ASSERT_TRUE(error_state.has_error());
+    ASSERT_EQ("[Board 1] Critical Temperature", error_state.to_string());
+
+    error_state.board_error_codes[0] = ErrorCodes::ENCODER;
+    ASSERT_EQ("[Board 0] Encoder Error  [Board 1] Critical Temperature",
+              error_state.to_string());
+}
+
+TEST(TestNJointBlmcRobotDriverErrorState, position_limits)
+{
+    using ErrorCodes = blmc_drivers::MotorBoardStatus::ErrorCodes;
+
+    Driver::ErrorState error_state;
+
+    error_state.position_limits_exceeded = true;
+    ASSERT_TRUE(error_state.has_error());
+    ASSERT_EQ("Position limits exceeded.", error_state.to_string());
+
+    error_state.board_error_codes[0] = ErrorCodes::CAN_RECV_TIMEOUT;
+    ASSERT_EQ("[Board 0] CAN Receive Timeout | Position limits exceeded.",
+              error_state.to_string());
+}
+
+TEST(TestNJointBlmcRobotDriverErrorState, unknown_error_code)
+{
+    Driver::ErrorState error_state;
+
+    error_state.board_error_codes[0] = 6;
+    ASSERT_TRUE(error_state.has_error());
+    ASSERT_EQ("[Board 0] Unknown Error", error_state.to_string());
+}
+
+/**
+ * @brief Driver with simulated boards that gives access to the protected
+ *        methods used for initialisation and shutdown.
+ */
+class FakeBoardDriver
+    : public robot_fingers::SimpleNJointBlmcRobotDriver<2, 1, FakeMotorBoard>
+{
+public:
+    typedef robot_fingers::SimpleNJointBlmcRobotDriver<2, 1, FakeMotorBoard>
+        Base;
+
+    using Base::Base;
+    using Base::execute_trajectory;
+    using Base::get_current_homing_state;
+    using Base::move_to_position;
+    using Base::move_until_blocking;
+    using Base::restore_homing_cache;
+};
+
+//! @brief Fixture for running the driver with a simulated board.
+class TestNJointBlmcRobotDriverFakeBoard : public ::testing::Test
+{
+protected:
+    FakeBoardDriver::Config config;
+    std::shared_ptr<FakeMotorBoard> board;
+
+    void SetUp() override
+    {
+        config.max_current_A = 2.0;
+        config.wait_for_new_measurement = true;
+        config.position_control_gains.kp.setConstant(3.0);
+        config.position_control_gains.kd.setConstant(0.01);
+        config.hard_position_limits_lower.setConstant(-10.0);
+        config.hard_position_limits_upper.setConstant(10.0);
+
+        board = std::make_shared<FakeMotorBoard>(config.control_period_s);
+    }
+
+    //! @brief Create the driver (after config and board are set up).
+    std::unique_ptr<FakeBoardDriver> create_driver()
+    {
+        FakeBoardDriver::MotorBoards boards = {board};
+        return std::make_unique<FakeBoardDriver>(
+            boards,
+            create_fake_motors<FakeBoardDriver::Motors>(boards),
+            robot_fingers::MotorParameters{0.02, 9.0},
+            config);
+    }
+};
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, move_until_blocking)
+{
+    board->motors[0].upper_end_stop = 0.2;
+    board->motors[1].lower_end_stop = -0.1;
+    auto driver = create_driver();
+
+    auto result =
+        driver->move_until_blocking(FakeBoardDriver::Vector(0.1, -0.1));
+
+    EXPECT_TRUE(result.all_stalled);
+    EXPECT_EQ(0.2, board->motors[0].position);
+    EXPECT_EQ(-0.1, board->motors[1].position);
+    // the joint with the shorter distance stalls first
+    EXPECT_LT(result.stall_time_s[1], result.stall_time_s[0]);
+}
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, move_until_blocking_late_start)
+{
+    config.calibration.endstop_stall_action =
+        FakeBoardDriver::Config::EndstopStallAction::HOLD;
+    board->motors[0].upper_end_stop = 0.1;
+    board->motors[1].upper_end_stop = 0.1;
+    // the second joint only starts moving after several velocity windows
+    board->motors[1].start_delay_steps = 300;
+    auto driver = create_driver();
+
+    auto result =
+        driver->move_until_blocking(FakeBoardDriver::Vector(0.1, 0.1));
+
+    EXPECT_TRUE(result.all_stalled);
+    EXPECT_EQ(0.1, board->motors[0].position);
+    EXPECT_EQ(0.1, board->motors[1].position);
+    EXPECT_GT(result.stall_time_s[1], 0.3);
+}
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, move_until_blocking_at_end_stop)
+{
+    // the first joint is already at the end stop, so it never moves
+    board->motors[0].upper_end_stop = 0.0;
+    board->motors[1].upper_end_stop = 0.1;
+    auto driver = create_driver();
+
+    auto result =
+        driver->move_until_blocking(FakeBoardDriver::Vector(0.1, 0.1));
+
+    EXPECT_TRUE(result.all_stalled);
+    EXPECT_NEAR(1.0, result.stall_time_s[0], 0.01);
+    EXPECT_EQ(0.1, board->motors[1].position);
+}
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, move_to_position_holds_goal)
+{
+    config.move_to_position_max_velocity_radps = 1.0;
+    auto driver = create_driver();
+
+    const FakeBoardDriver::Vector goal(0.3, -0.2);
+    const uint32_t profile_steps = FakeBoardDriver::get_min_jerk_duration_steps(
+        goal,
+        config.move_to_position_max_velocity_radps,
+        config.move_to_position_max_acceleration_radps2,
+        config.control_period_s,
+        3000);
+
+    auto result = driver->move_to_position(goal, 0.001, 3000);
+
+    // the joints lag behind the profile, so the goal is only reached by
+    // holding it after the profile ended
+    EXPECT_TRUE(result.reached_goal);
+    EXPECT_GT(result.executed_steps, profile_steps);
+    EXPECT_LT(result.executed_steps, 3000u);
+    EXPECT_TRUE((result.position_error.array().abs() < 0.001).all());
+}
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, invalid_shutdown_trajectory)
+{
+    FakeBoardDriver::Config::TrajectoryStep step;
+    step.move_steps = 100;
+    config.shutdown_trajectory = {step, step};
+
+    // no limits, so move_steps is required
+    config.shutdown_trajectory[1].move_steps = 0;
+    EXPECT_THROW(create_driver(), std::invalid_argument);
+
+    config.shutdown_trajectory[1].move_steps = 100;
+    config.shutdown_trajectory[1].joints = {2};
+    EXPECT_THROW(create_driver(), std::invalid_argument);
+
+    config.shutdown_trajectory[1].joints = {1};
+    EXPECT_NO_THROW(create_driver());
+}
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, execute_trajectory)
+{
+    config.position_control_gains.kp.setConstant(20.0);
+    auto driver = create_driver();
+
+    using TrajectoryStep = FakeBoardDriver::Config::TrajectoryStep;
+    std::vector<TrajectoryStep> trajectory(4);
+    // steps 0 and 1 move different joints, so they run concurrently
+    trajectory[0].joints = {0};
+    trajectory[0].target_position_rad[0] = 0.2;
+    trajectory[0].move_steps = 1000;
+    trajectory[1].joints = {1};
+    trajectory[1].target_position_rad[1] = -0.2;
+    trajectory[1].move_steps = 500;
+    // step 2 moves joint 1 again, so it starts when step 1 is done
+    trajectory[2].joints = {1};
+    trajectory[2].target_position_rad[1] = 0.0;
+    trajectory[2].move_steps = 800;
+    // step 3 moves all joints, so it waits for all previous steps
+    trajectory[3].target_position_rad << 0.1, 0.1;
+    trajectory[3].move_steps = 1000;
+
+    auto result = driver->execute_trajectory(trajectory, 0.01);
+
+    EXPECT_TRUE(result.reached_goal);
+    EXPECT_EQ(-1, result.failed_step);
+    // step 3 starts after step 2 (500 + 800 steps), which is after step 0
+    EXPECT_EQ(500u + 800u + 1000u, result.executed_steps);
+    EXPECT_NEAR(0.1, driver->get_latest_observation().position[0], 0.01);
+    EXPECT_NEAR(0.1, driver->get_latest_observation().position[1], 0.01);
+}
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, execute_trajectory_with_limits)
+{
+    config.move_to_position_max_velocity_radps = 1.0;
+    auto driver = create_driver();
+
+    using TrajectoryStep = FakeBoardDriver::Config::TrajectoryStep;
+    std::vector<TrajectoryStep> trajectory(2);
+    // durations are derived from the velocity limit
+    trajectory[0].joints = {0};
+    trajectory[0].target_position_rad[0] = 0.3;
+    trajectory[1].joints = {1};
+    trajectory[1].target_position_rad[1] = -0.2;
+    const uint32_t profile_steps = FakeBoardDriver::get_min_jerk_duration_steps(
+        trajectory[0].target_position_rad,
+        config.move_to_position_max_velocity_radps,
+        config.move_to_position_max_acceleration_radps2,
+        config.control_period_s,
+        std::numeric_limits<uint32_t>::max());
+
+    auto result = driver->execute_trajectory(trajectory, 0.001);
+
+    // the joints lag behind the profile, so the targets are only reached by
+    // holding them after the profile ended
+    EXPECT_TRUE(result.reached_goal);
+    EXPECT_EQ(-1, result.failed_step);
+    EXPECT_GT(result.executed_steps, profile_steps);
+    EXPECT_NEAR(0.3, driver->get_latest_observation().position[0], 0.001);
+    EXPECT_NEAR(-0.2, driver->get_latest_observation().position[1], 0.001);
+}
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, execute_trajectory_failed_step)
+{
+    // the first joint is blocked, so it cannot reach the target of step 1
+    board->motors[0].upper_end_stop = 0.0;
+    config.position_control_gains.kp.setConstant(20.0);
+    auto driver = create_driver();
+
+    using TrajectoryStep = FakeBoardDriver::Config::TrajectoryStep;
+    std::vector<TrajectoryStep> trajectory(3);
+    trajectory[0].joints = {1};
+    trajectory[0].target_position_rad[1] = -0.1;
+    trajectory[0].move_steps = 1000;
+    trajectory[1].joints = {0};
+    trajectory[1].target_position_rad[0] = 0.1;
+    trajectory[1].move_steps = 300;
+    trajectory[2].move_steps = 300;
+
+    auto result = driver->execute_trajectory(trajectory, 0.01);
+
+    EXPECT_FALSE(result.reached_goal);
+    EXPECT_EQ(1, result.failed_step);
+    // the target is held for another move_steps before the step fails
+    EXPECT_EQ(300u + 300u, result.executed_steps);
+    EXPECT_NEAR(0.1, result.position_error[0], 1e-6);
+    // joints of other steps (step 0 is still running) are not part of the
+    // error
+    EXPECT_EQ(0.0, result.position_error[1]);
+}
+
+TEST_F(TestNJointBlmcRobotDriverFakeBoard, restore_homing_cache)
+{
+    // matches the gear ratio of create_driver()
+    constexpr double REV_TO_RAD = 2 * M_PI / 9.0;
+    const std::string filename =
+        ::testing::TempDir() + "fake_board_homing_cache.yml";
+
+    config.homing_method =
+        FakeBoardDriver::Config::HomingMethod::CURRENT_POSITION;
+    config.homing_cache_file = filename;
+    config.move_to_position_tolerance_rad = 0.01;
+
+    robot_fingers::HomingCache<2> cache;
+    cache.homing_method =
+        FakeBoardDriver::Config::get_homing_method_name(config.homing_method);
+    cache.home_offset_rad = config.home_offset_rad;
+    cache.zero_angles << 0.5, -0.5;
+    cache.raw_position << 0.1 * REV_TO_RAD, -0.3 * REV_TO_RAD;
+    // indices of the motors are at 0.25 rev (modulo one revolution)
+    cache.raw_index_angles << 0.25 * REV_TO_RAD, -0.75 * REV_TO_RAD;
+    cache.save(filename);
+
+    auto create_board = [&](double index_offset_1) {
+        board = std::make_shared<FakeMotorBoard>(config.control_period_s);
+        board->motors[0].position = 0.1;
+        board->motors[1].position = -0.3;
+        board->motors[1].index_offset = index_offset_1;
+    };
+
+    // no index is known before the joints move, so they have to move over
+    // the next index and back
+    create_board(0.25);
+    auto driver = create_driver();
+    ASSERT_TRUE(driver->get_measured_index_angles().array().isNaN().all());
+    EXPECT_TRUE(driver->restore_homing_cache());
+    EXPECT_EQ(cache.zero_angles,
+              driver->get_current_homing_state().zero_angles);
+    EXPECT_NEAR(0.1, board->motors[0].position, 0.01 / REV_TO_RAD);
+    EXPECT_NEAR(-0.3, board->motors[1].position, 0.01 / REV_TO_RAD);
+
+    // same position but the index of the second motor is somewhere else
+    // (e.g. the motor was moved by a full revolution plus a bit and back)
+    create_board(0.5);
+    driver = create_driver();
+    EXPECT_FALSE(driver->restore_homing_cache());
+
+    std::remove(filename.c_str());
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
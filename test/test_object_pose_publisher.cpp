@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @brief Tests for the ObjectPosePublisher.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <robot_fingers/object_pose_publisher.hpp>
+#include <robot_fingers/trifinger_platform_frontend.hpp>
+
+using robot_fingers::ObjectPoseObservation;
+using robot_fingers::ObjectPosePublisher;
+using robot_fingers::SingleProcessObjectPoseData;
+using CameraObservation = ObjectPosePublisher::CameraObservation;
+using CameraData = robot_interfaces::SingleProcessSensorData<CameraObservation>;
+
+//! @brief Camera observation with a pose that identifies it.
+CameraObservation make_camera_observation(int i)
+{
+    CameraObservation observation;
+    observation.object_pose.position << i, 0, 0;
+    observation.filtered_object_pose.position << 0, i, 0;
+    return observation;
+}
+
+TEST(TestObjectPosePublisher, poses_reference_camera_observations)
+{
+    auto camera_data = std::make_shared<CameraData>(10);
+    auto pose_data = std::make_shared<SingleProcessObjectPoseData>(10);
+
+    // the publisher starts with the observation that is the newest when it is
+    // created
+    camera_data->observation->append(make_camera_observation(0));
+    ObjectPosePublisher publisher(camera_data, pose_data);
+
+    for (int i = 1; i < 5; i++)
+    {
+        camera_data->observation->append(make_camera_observation(i));
+    }
+    ASSERT_TRUE(pose_data->observation->wait_for_timeindex(4, 2.0));
+
+    for (time_series::Index i = 0; i < 5; i++)
+    {
+        ObjectPoseObservation pose = (*pose_data->observation)[i];
+        EXPECT_EQ(i, pose.camera_timeindex);
+        EXPECT_EQ(camera_data->observation->timestamp_ms(i),
+                  pose.camera_timestamp_ms);
+        EXPECT_EQ(i, pose.object_pose.position[0]);
+        EXPECT_EQ(i, pose.filtered_object_pose.position[1]);
+    }
+}
+
+TEST(TestObjectPosePublisher, dropped_observations_are_skipped)
+{
+    // camera time series only keeps the last two observations
+    CameraData camera_data(2);
+    SingleProcessObjectPoseData pose_data(10);
+
+    for (int i = 0; i < 5; i++)
+    {
+        camera_data.observation->append(make_camera_observation(i));
+    }
+
+    // observations 0 to 2 are dropped, so 3 is published instead of 0
+    time_series::Index t = ObjectPosePublisher::publish(
+        *camera_data.observation, *pose_data.observation, 0);
+    EXPECT_EQ(4, t);
+    t = ObjectPosePublisher::publish(
+        *camera_data.observation, *pose_data.observation, t);
+    EXPECT_EQ(5, t);
+
+    ASSERT_EQ(1, pose_data.observation->newest_timeindex());
+    EXPECT_EQ(3, (*pose_data.observation)[0].camera_timeindex);
+    EXPECT_EQ(3, (*pose_data.observation)[0].object_pose.position[0]);
+    EXPECT_EQ(4, (*pose_data.observation)[1].camera_timeindex);
+    EXPECT_EQ(4, (*pose_data.observation)[1].object_pose.position[0]);
+}
+
+TEST(TestObjectPosePublisher, frontend_get_object_pose)
+{
+    constexpr int N = 5;
+
+    auto robot_data = std::make_shared<
+        robot_interfaces::TriFingerTypes::SingleProcessData>(100);
+    auto camera_data = std::make_shared<CameraData>(10);
+    auto pose_data = std::make_shared<SingleProcessObjectPoseData>(10);
+    std::unique_ptr<ObjectPosePublisher> publisher;
+
+    // Alternate camera and robot observations, so each robot step has a
+    // different matching camera observation.  The publisher is created after
+    // the first camera observation, so it starts with that one.
+    for (int i = 0; i < N; i++)
+    {
+        camera_data->observation->append(make_camera_observation(i));
+        if (i == 0)
+        {
+            publisher = std::make_unique<ObjectPosePublisher>(camera_data,
+                                                              pose_data);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        robot_data->observation->append(
+            robot_interfaces::TriFingerTypes::Observation());
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(pose_data->observation->wait_for_timeindex(N - 1, 2.0));
+
+    robot_fingers::TriFingerPlatformWithObjectFrontend frontend(
+        robot_data, camera_data, pose_data);
+
+    for (time_series::Index t = 0; t < N; t++)
+    {
+        CameraObservation camera = frontend.get_camera_observation(t);
+        ObjectPoseObservation pose = frontend.get_object_pose(t);
+
+        EXPECT_EQ(t, pose.camera_timeindex);
+        EXPECT_EQ(camera.object_pose.position, pose.object_pose.position);
+        EXPECT_EQ(camera.filtered_object_pose.position,
+                  pose.filtered_object_pose.position);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
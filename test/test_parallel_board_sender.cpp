@@ -0,0 +1,152 @@
+/**
+ * @file
+ * @brief Tests for the ParallelBoardSender.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <robot_fingers/parallel_board_sender.hpp>
+
+using robot_fingers::ParallelBoardSender;
+
+/**
+ * @brief Fake board that counts how often it is asked to send.
+ *
+ * Optionally waits (with timeout) until all boards are sending at the same
+ * time, to check that the boards are actually served in parallel.  If `fail`
+ * is set, sending throws an exception.
+ */
+class FakeBoard
+{
+public:
+    FakeBoard(std::atomic<int> *num_active, int wait_for_num_active)
+        : num_active_(num_active), wait_for_num_active_(wait_for_num_active)
+    {
+    }
+
+    void send_if_input_changed()
+    {
+        num_active_->fetch_add(1);
+
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (num_active_->load() < wait_for_num_active_ &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        max_active = std::max(max_active, num_active_->load());
+
+        send_count++;
+
+        if (fail)
+        {
+            throw std::runtime_error("Failed to send.");
+        }
+    }
+
+    int send_count = 0;
+    int max_active = 0;
+    bool fail = false;
+
+private:
+    std::atomic<int> *num_active_;
+    int wait_for_num_active_;
+};
+
+TEST(TestParallelBoardSender, each_board_sends_once)
+{
+    std::atomic<int> num_active(0);
+    std::vector<std::shared_ptr<FakeBoard>> boards;
+    for (int i = 0; i < 6; i++)
+    {
+        boards.push_back(std::make_shared<FakeBoard>(&num_active, 0));
+    }
+
+    ParallelBoardSender<FakeBoard> sender(boards);
+    ASSERT_EQ(6u, sender.size());
+
+    for (int i = 0; i < 10; i++)
+    {
+        sender.send();
+        // all boards are done when send() returns
+        for (const auto &board : boards)
+        {
+            ASSERT_EQ(i + 1, board->send_count);
+        }
+    }
+}
+
+TEST(TestParallelBoardSender, boards_send_concurrently)
+{
+    constexpr int NUM_BOARDS = 3;
+
+    std::atomic<int> num_active(0);
+    std::vector<std::shared_ptr<FakeBoard>> boards;
+    for (int i = 0; i < NUM_BOARDS; i++)
+    {
+        boards.push_back(
+            std::make_shared<FakeBoard>(&num_active, NUM_BOARDS));
+    }
+
+    ParallelBoardSender<FakeBoard> sender(boards);
+    sender.send();
+
+    // If the boards were served one after the other, each would have timed out
+    // waiting for the others.
+    for (const auto &board : boards)
+    {
+        EXPECT_EQ(NUM_BOARDS, board->max_active);
+    }
+}
+
+TEST(TestParallelBoardSender, error_is_rethrown)
+{
+    std::atomic<int> num_active(0);
+    std::vector<std::shared_ptr<FakeBoard>> boards;
+    for (int i = 0; i < 3; i++)
+    {
+        boards.push_back(std::make_shared<FakeBoard>(&num_active, 0));
+    }
+
+    ParallelBoardSender<FakeBoard> sender(boards);
+
+    boards[1]->fail = true;
+    EXPECT_THROW(sender.send(), std::runtime_error);
+    // the other boards still sent
+    for (const auto &board : boards)
+    {
+        EXPECT_EQ(1, board->send_count);
+    }
+
+    // the sender is still usable and the error is not reported again
+    boards[1]->fail = false;
+    EXPECT_NO_THROW(sender.send());
+    for (const auto &board : boards)
+    {
+        EXPECT_EQ(2, board->send_count);
+    }
+}
+
+TEST(TestParallelBoardSender, invalid_cpus)
+{
+    std::atomic<int> num_active(0);
+    std::vector<std::shared_ptr<FakeBoard>> boards = {
+        std::make_shared<FakeBoard>(&num_active, 0),
+        std::make_shared<FakeBoard>(&num_active, 0)};
+
+    EXPECT_THROW(ParallelBoardSender<FakeBoard>(boards, {0}),
+                 std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief Tests for the PeriodicScheduler.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <robot_fingers/periodic_scheduler.hpp>
+
+using robot_fingers::PeriodicScheduler;
+
+TEST(TestPeriodicScheduler, invalid_period)
+{
+    ASSERT_THROW(PeriodicScheduler(0.0), std::invalid_argument);
+    ASSERT_THROW(PeriodicScheduler(-0.001), std::invalid_argument);
+}
+
+TEST(TestPeriodicScheduler, start_stop)
+{
+    PeriodicScheduler scheduler(0.001);
+    ASSERT_FALSE(scheduler.is_running());
+
+    // wait implicitly starts the scheduler
+    scheduler.wait_for_next_period();
+    ASSERT_TRUE(scheduler.is_running());
+
+    scheduler.stop();
+    ASSERT_FALSE(scheduler.is_running());
+}
+
+TEST(TestPeriodicScheduler, no_drift)
+{
+    constexpr double PERIOD_S = 0.002;
+    constexpr uint64_t NUM_CYCLES = 50;
+
+    PeriodicScheduler scheduler(PERIOD_S);
+
+    auto start = std::chrono::steady_clock::now();
+    scheduler.start();
+    for (uint64_t i = 0; i < NUM_CYCLES; i++)
+    {
+        // simulate some work that takes a fraction of the period
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        scheduler.wait_for_next_period();
+    }
+    std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+
+    // The total duration must never be below the nominal one.  The upper bound
+    // is generous to not fail on a loaded machine but would be exceeded if the
+    // work time was added to each period.
+    ASSERT_GE(duration.count(), NUM_CYCLES * PERIOD_S);
+    ASSERT_LT(duration.count(), NUM_CYCLES * (PERIOD_S + 0.0005));
+
+    ASSERT_EQ(NUM_CYCLES, scheduler.get_cycle_count());
+}
+
+TEST(TestPeriodicScheduler, skip_missed_slots)
+{
+    constexpr double PERIOD_S = 0.01;
+
+    PeriodicScheduler scheduler(PERIOD_S);
+    scheduler.start();
+
+    // overrun of 2.5 periods
+    std::this_thread::sleep_for(std::chrono::milliseconds(35));
+    ASSERT_FALSE(scheduler.wait_for_next_period());
+    ASSERT_EQ(1u, scheduler.get_overrun_count());
+    ASSERT_EQ(2u, scheduler.get_skipped_slot_count());
+
+    // The following cycle ends at the end of the current slot, i.e. the
+    // scheduler does not try to catch up with the skipped slots.
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(scheduler.wait_for_next_period());
+    std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+    ASSERT_GT(duration.count(), 0.001);
+    ASSERT_LE(duration.count(), PERIOD_S);
+
+    ASSERT_EQ(1u, scheduler.get_overrun_count());
+    ASSERT_EQ(2u, scheduler.get_skipped_slot_count());
+
+    scheduler.reset_counters();
+    ASSERT_EQ(0u, scheduler.get_cycle_count());
+    ASSERT_EQ(0u, scheduler.get_overrun_count());
+    ASSERT_EQ(0u, scheduler.get_skipped_slot_count());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
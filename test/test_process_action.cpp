@@ -5,6 +5,11 @@
  *            Gesellschaft.
  */
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <robot_fingers/clamp.hpp>
 #include <robot_fingers/n_joint_blmc_robot_driver.hpp>
 #include <robot_interfaces/n_joint_robot_types.hpp>
 
@@ -522,6 +527,328 @@ TEST_F(TestProcessDesiredAction, position_one_above_one_below_limit)
     EXPECT_EQ(default_position_control_kd[1], resulting_action.position_kd[1]);
 }
 
+/**
+ * @brief Test if the batch processing matches the per-step processing.
+ */
+TEST_F(TestProcessDesiredAction, batch)
+{
+    constexpr Eigen::Index NUM_STEPS = 5000;
+
+    Driver::ActionBatch actions;
+    actions.torque = Driver::JointTrajectory::Random(NUM_STEPS, 2);
+    actions.position = 20 * Driver::JointTrajectory::Random(NUM_STEPS, 2);
+    actions.position_kp = Driver::JointTrajectory::Random(NUM_STEPS, 2);
+    actions.position_kd = Driver::JointTrajectory::Constant(
+        NUM_STEPS, 2, std::numeric_limits<double>::quiet_NaN());
+    // mix in some steps without position command
+    for (Eigen::Index t = 0; t < NUM_STEPS; t += 3)
+    {
+        actions.position.row(t).setConstant(
+            std::numeric_limits<double>::quiet_NaN());
+    }
+
+    Driver::JointTrajectory positions =
+        20 * Driver::JointTrajectory::Random(NUM_STEPS, 2);
+    Driver::JointTrajectory velocities =
+        Driver::JointTrajectory::Random(NUM_STEPS, 2);
+
+    Vector limits;
+    limits << 10, 5;
+
+    Driver::ActionBatch result =
+        Driver::process_desired_action_batch(actions,
+                                             positions,
+                                             velocities,
+                                             max_torque_Nm,
+                                             safety_kd,
+                                             default_position_control_kp,
+                                             default_position_control_kd,
+                                             -limits,
+                                             limits,
+                                             3);
+
+    ASSERT_EQ(NUM_STEPS, result.size());
+    for (Eigen::Index t = 0; t < NUM_STEPS; t++)
+    {
+        observation.position = positions.row(t).transpose();
+        observation.velocity = velocities.row(t).transpose();
+
+        Types::Action expected = Driver::process_desired_action(
+            Types::Action(actions.torque.row(t).transpose(),
+                          actions.position.row(t).transpose(),
+                          actions.position_kp.row(t).transpose(),
+                          actions.position_kd.row(t).transpose()),
+            observation,
+            max_torque_Nm,
+            safety_kd,
+            default_position_control_kp,
+            default_position_control_kd,
+            -limits,
+            limits);
+
+        // compare with memcmp, so NaNs are considered as well
+        ASSERT_EQ(0,
+                  std::memcmp(expected.torque.data(),
+                              result.torque.row(t).data(),
+                              sizeof(double) * 2))
+            << "t = " << t;
+        ASSERT_EQ(0,
+                  std::memcmp(expected.position.data(),
+                              result.position.row(t).data(),
+                              sizeof(double) * 2))
+            << "t = " << t;
+        ASSERT_EQ(0,
+                  std::memcmp(expected.position_kp.data(),
+                              result.position_kp.row(t).data(),
+                              sizeof(double) * 2))
+            << "t = " << t;
+        ASSERT_EQ(0,
+                  std::memcmp(expected.position_kd.data(),
+                              result.position_kd.row(t).data(),
+                              sizeof(double) * 2))
+            << "t = " << t;
+    }
+}
+
+TEST_F(TestProcessDesiredAction, batch_size_mismatch)
+{
+    Driver::ActionBatch actions;
+    actions.torque = Driver::JointTrajectory::Zero(10, 2);
+    actions.position = Driver::JointTrajectory::Zero(10, 2);
+    actions.position_kp = Driver::JointTrajectory::Zero(10, 2);
+    actions.position_kd = Driver::JointTrajectory::Zero(10, 2);
+
+    EXPECT_THROW(Driver::process_desired_action_batch(
+                     actions,
+                     Driver::JointTrajectory::Zero(9, 2),
+                     Driver::JointTrajectory::Zero(10, 2),
+                     max_torque_Nm,
+                     safety_kd,
+                     default_position_control_kp,
+                     default_position_control_kd),
+                 std::invalid_argument);
+}
+
+/**
+ * @brief Straightforward per-joint implementation of process_desired_action.
+ *
+ * This is the implementation that was used before process_desired_action was
+ * fused into a single branch-light pass.  It is kept as reference to verify
+ * that the results of the driver did not change.
+ */
+template <typename Driver>
+typename Driver::Action reference_process_desired_action(
+    const typename Driver::Action &desired_action,
+    const typename Driver::Observation &latest_observation,
+    const double max_torque_Nm,
+    const typename Driver::Vector &safety_kd,
+    const typename Driver::Vector &default_position_control_kp,
+    const typename Driver::Vector &default_position_control_kd,
+    const typename Driver::Vector &lower_position_limits,
+    const typename Driver::Vector &upper_position_limits)
+{
+    typedef typename Driver::Action Action;
+    typedef typename Driver::Vector Vector;
+
+    Action processed_action = desired_action;
+
+    for (std::size_t i = 0; i < Driver::num_joints; i++)
+    {
+        if (processed_action.position[i] < lower_position_limits[i])
+        {
+            processed_action.position[i] = lower_position_limits[i];
+        }
+        else if (processed_action.position[i] > upper_position_limits[i])
+        {
+            processed_action.position[i] = upper_position_limits[i];
+        }
+
+        auto set_limit_action = [&](double sign, double limit) {
+            if (processed_action.torque[i] * sign > 0)
+            {
+                processed_action.torque[i] = 0;
+            }
+
+            if (std::isnan(processed_action.position[i]))
+            {
+                processed_action.position[i] = limit;
+            }
+
+            processed_action.position_kp[i] = default_position_control_kp[i];
+            processed_action.position_kd[i] = default_position_control_kd[i];
+        };
+
+        if (latest_observation.position[i] < lower_position_limits[i])
+        {
+            set_limit_action(-1, lower_position_limits[i]);
+        }
+        else if (latest_observation.position[i] > upper_position_limits[i])
+        {
+            set_limit_action(+1, upper_position_limits[i]);
+        }
+    }
+
+    if (!processed_action.position.array().isNaN().all())
+    {
+        processed_action.position_kp =
+            processed_action.position_kp.array().isNaN().select(
+                default_position_control_kp, processed_action.position_kp);
+        processed_action.position_kd =
+            processed_action.position_kd.array().isNaN().select(
+                default_position_control_kd, processed_action.position_kd);
+
+        Vector position_error =
+            processed_action.position - latest_observation.position;
+
+        Vector position_control_torque =
+            processed_action.position_kp.cwiseProduct(position_error) -
+            processed_action.position_kd.cwiseProduct(
+                latest_observation.velocity);
+
+        position_control_torque =
+            position_control_torque.array().isNaN().select(
+                0, position_control_torque);
+
+        processed_action.torque += position_control_torque;
+    }
+
+    processed_action.torque = robot_fingers::clamp(
+        processed_action.torque, -max_torque_Nm, max_torque_Nm);
+    processed_action.torque -=
+        safety_kd.cwiseProduct(latest_observation.velocity);
+    processed_action.torque = robot_fingers::clamp(
+        processed_action.torque, -max_torque_Nm, max_torque_Nm);
+
+    return processed_action;
+}
+
+//! @brief Random vector which also contains NaN and negative zero.
+template <typename Vector>
+Vector random_vector(std::mt19937 &rng, double nan_probability)
+{
+    std::uniform_real_distribution<double> value(-2.0, 2.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    Vector vec;
+    for (int i = 0; i < vec.size(); i++)
+    {
+        const double r = uniform(rng);
+        if (r < nan_probability)
+        {
+            vec[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+        else if (r < nan_probability + 0.02)
+        {
+            vec[i] = -0.0;
+        }
+        else
+        {
+            vec[i] = value(rng);
+        }
+    }
+
+    return vec;
+}
+
+/**
+ * @brief Check that the driver gives bit-identical results as the reference
+ *        implementation for random actions.
+ *
+ * Note that results may differ in the last bit if the compiler is allowed to
+ * contract multiplications and additions differently in the two
+ * implementations (e.g. when compiling with `-march=native` on a CPU with FMA
+ * support).
+ */
+template <size_t N_JOINTS>
+void expect_matches_reference()
+{
+    typedef robot_fingers::SimpleNJointBlmcRobotDriver<N_JOINTS> Driver;
+    typedef typename Driver::Action Action;
+    typedef typename Driver::Observation Observation;
+    typedef typename Driver::Vector Vector;
+
+    constexpr size_t NUM_SAMPLES = 2000;
+
+    std::mt19937 rng(42);
+
+    const double max_torque = 0.36;
+    const Vector safety_kd = Vector::Constant(0.08);
+    const Vector kp = Vector::Constant(3.0);
+    const Vector kd = Vector::Constant(0.03);
+
+    for (size_t i = 0; i < NUM_SAMPLES; i++)
+    {
+        // mix of torque, position and mixed actions
+        const Action action(random_vector<Vector>(rng, 0.0),
+                            random_vector<Vector>(rng, (i % 3) * 0.5),
+                            random_vector<Vector>(rng, 0.5),
+                            random_vector<Vector>(rng, 0.5));
+
+        Observation observation;
+        observation.position = random_vector<Vector>(rng, 0.0);
+        observation.velocity = random_vector<Vector>(rng, 0.0);
+
+        // random limits, so that some joints have the lower limit above the
+        // upper one
+        const Vector lower = random_vector<Vector>(rng, 0.0);
+        const Vector upper = random_vector<Vector>(rng, 0.0);
+
+        const Action expected = reference_process_desired_action<Driver>(
+            action, observation, max_torque, safety_kd, kp, kd, lower, upper);
+        const Action actual = Driver::process_desired_action(
+            action, observation, max_torque, safety_kd, kp, kd, lower, upper);
+
+        // compare with memcmp, so NaNs are considered as well
+        constexpr size_t SIZE = sizeof(double) * N_JOINTS;
+        ASSERT_EQ(0,
+                  std::memcmp(expected.torque.data(), actual.torque.data(),
+                              SIZE))
+            << "sample " << i;
+        ASSERT_EQ(0,
+                  std::memcmp(expected.position.data(), actual.position.data(),
+                              SIZE))
+            << "sample " << i;
+        ASSERT_EQ(0,
+                  std::memcmp(expected.position_kp.data(),
+                              actual.position_kp.data(),
+                              SIZE))
+            << "sample " << i;
+        ASSERT_EQ(0,
+                  std::memcmp(expected.position_kd.data(),
+                              actual.position_kd.data(),
+                              SIZE))
+            << "sample " << i;
+    }
+}
+
+/**
+ * @brief Test if the results match the reference implementation for
+ *        different numbers of joints.
+ */
+TEST(TestProcessDesiredActionReference, matches_reference)
+{
+    {
+        SCOPED_TRACE("N_JOINTS = 1");
+        expect_matches_reference<1>();
+    }
+    {
+        SCOPED_TRACE("N_JOINTS = 2");
+        expect_matches_reference<2>();
+    }
+    {
+        SCOPED_TRACE("N_JOINTS = 3");
+        expect_matches_reference<3>();
+    }
+    {
+        SCOPED_TRACE("N_JOINTS = 8");
+        expect_matches_reference<8>();
+    }
+    {
+        SCOPED_TRACE("N_JOINTS = 9");
+        expect_matches_reference<9>();
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
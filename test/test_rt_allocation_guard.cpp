@@ -0,0 +1,555 @@
+/**
+ * @file
+ * @brief Check that the real-time path does not allocate memory or lock.
+ *
+ * The heap functions of the C library and `pthread_mutex_lock` are interposed
+ * by this test executable.  While an AllocationGuard is active, all calls of
+ * these functions from the current thread are counted.  This way regressions
+ * that introduce allocations (e.g. std::string or std::vector temporaries) or
+ * locking into functions that run in the real-time control loop are detected
+ * on any ordinary Linux machine.
+ *
+ * The driver itself is run with simulated motor boards (see
+ * fake_motor_board.hpp).  The time series through which the boards exchange
+ * data with the driver are protected by a mutex, so locking cannot be avoided
+ * there.  For the driver, only locks of these known mutexes are accepted (see
+ * KnownMutexes) and the number of locks per control cycle has to stay
+ * constant.
+ *
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#include <robot_fingers/cycle_timing_trace.hpp>
+#include <robot_fingers/n_finger_driver.hpp>
+#include <robot_fingers/n_joint_blmc_robot_driver.hpp>
+#include <robot_fingers/parallel_board_sender.hpp>
+#include <robot_fingers/periodic_scheduler.hpp>
+#include <robot_fingers/stall_detector.hpp>
+#include <robot_fingers/triple_buffer.hpp>
+#include <robot_interfaces/finger_types.hpp>
+
+#include "fake_motor_board.hpp"
+
+// Interposition of heap functions and mutex locking
+// =================================================
+
+namespace
+{
+thread_local bool t_is_counting = false;
+thread_local size_t t_num_allocations = 0;
+thread_local size_t t_num_deallocations = 0;
+thread_local size_t t_num_locks = 0;
+thread_local size_t t_num_unknown_locks = 0;
+
+//! @brief Maximum number of mutexes that can be registered as known.
+constexpr size_t MAX_KNOWN_MUTEXES = 64;
+thread_local bool t_is_recording_mutexes = false;
+thread_local pthread_mutex_t *t_known_mutexes[MAX_KNOWN_MUTEXES];
+thread_local size_t t_num_known_mutexes = 0;
+
+inline bool is_known_mutex(const pthread_mutex_t *mutex)
+{
+    for (size_t i = 0; i < t_num_known_mutexes; i++)
+    {
+        if (t_known_mutexes[i] == mutex)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void count_lock(pthread_mutex_t *mutex)
+{
+    if (t_is_recording_mutexes && !is_known_mutex(mutex) &&
+        t_num_known_mutexes < MAX_KNOWN_MUTEXES)
+    {
+        t_known_mutexes[t_num_known_mutexes++] = mutex;
+    }
+
+    if (t_is_counting)
+    {
+        t_num_locks++;
+        if (!is_known_mutex(mutex))
+        {
+            t_num_unknown_locks++;
+        }
+    }
+}
+
+inline void count_allocation()
+{
+    if (t_is_counting)
+    {
+        t_num_allocations++;
+    }
+}
+
+inline void count_deallocation()
+{
+    if (t_is_counting)
+    {
+        t_num_deallocations++;
+    }
+}
+}  // namespace
+
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t num, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void *ptr);
+
+    void *malloc(size_t size)
+    {
+        count_allocation();
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t num, size_t size)
+    {
+        count_allocation();
+        return __libc_calloc(num, size);
+    }
+
+    void *realloc(void *ptr, size_t size)
+    {
+        count_allocation();
+        return __libc_realloc(ptr, size);
+    }
+
+    void *aligned_alloc(size_t alignment, size_t size)
+    {
+        count_allocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    void *memalign(size_t alignment, size_t size)
+    {
+        count_allocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void **ptr, size_t alignment, size_t size)
+    {
+        count_allocation();
+        *ptr = __libc_memalign(alignment, size);
+        return *ptr ? 0 : ENOMEM;
+    }
+
+    void free(void *ptr)
+    {
+        if (ptr)
+        {
+            count_deallocation();
+        }
+        __libc_free(ptr);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t *mutex)
+    {
+        typedef int (*LockFunction)(pthread_mutex_t *);
+        // no function-local static here, as its initialisation guard may lock
+        static LockFunction real_lock = nullptr;
+        if (!real_lock)
+        {
+            real_lock = reinterpret_cast<LockFunction>(
+                dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        }
+
+        count_lock(mutex);
+        return real_lock(mutex);
+    }
+}
+
+/**
+ * @brief Counts heap operations and locks of the current thread while alive.
+ */
+class AllocationGuard
+{
+public:
+    AllocationGuard()
+    {
+        t_num_allocations = 0;
+        t_num_deallocations = 0;
+        t_num_locks = 0;
+        t_num_unknown_locks = 0;
+        t_is_counting = true;
+    }
+
+    ~AllocationGuard()
+    {
+        stop();
+    }
+
+    //! Stop counting (call before any assertions).
+    void stop()
+    {
+        t_is_counting = false;
+    }
+
+    size_t num_allocations() const
+    {
+        return t_num_allocations;
+    }
+    size_t num_deallocations() const
+    {
+        return t_num_deallocations;
+    }
+    size_t num_locks() const
+    {
+        return t_num_locks;
+    }
+    //! Number of locks of mutexes that are not registered in KnownMutexes.
+    size_t num_unknown_locks() const
+    {
+        return t_num_unknown_locks;
+    }
+};
+
+/**
+ * @brief Registers the mutexes that are locked while alive as known.
+ *
+ * Locks of known mutexes are still counted by the AllocationGuard but not
+ * reported by AllocationGuard::num_unknown_locks().  The registration is reset
+ * on construction.
+ */
+class KnownMutexes
+{
+public:
+    KnownMutexes()
+    {
+        t_num_known_mutexes = 0;
+        t_is_recording_mutexes = true;
+    }
+
+    ~KnownMutexes()
+    {
+        stop();
+    }
+
+    //! Stop registering mutexes.
+    void stop()
+    {
+        t_is_recording_mutexes = false;
+    }
+
+    size_t size() const
+    {
+        return t_num_known_mutexes;
+    }
+};
+
+#define EXPECT_REAL_TIME_SAFE(guard)               \
+    EXPECT_EQ(0u, guard.num_allocations())         \
+        << "Unexpected memory allocation";         \
+    EXPECT_EQ(0u, guard.num_deallocations())       \
+        << "Unexpected memory deallocation";       \
+    EXPECT_EQ(0u, guard.num_locks()) << "Unexpected mutex lock"
+
+// Like EXPECT_REAL_TIME_SAFE but accepts locks of known mutexes (see
+// KnownMutexes).
+#define EXPECT_REAL_TIME_SAFE_EXCEPT_KNOWN_LOCKS(guard) \
+    EXPECT_EQ(0u, guard.num_allocations())              \
+        << "Unexpected memory allocation";              \
+    EXPECT_EQ(0u, guard.num_deallocations())            \
+        << "Unexpected memory deallocation";            \
+    EXPECT_EQ(0u, guard.num_unknown_locks()) << "Unexpected mutex lock"
+
+// Tests
+// =====
+
+/**
+ * @brief Make sure the guard actually detects allocations and locks.
+ */
+TEST(TestRealTimeAllocationGuard, self_test)
+{
+    std::mutex mutex;
+
+    AllocationGuard guard;
+    {
+        std::vector<double> vec(42);
+        vec[0] = 1;
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    guard.stop();
+
+    ASSERT_EQ(1u, guard.num_allocations());
+    ASSERT_EQ(1u, guard.num_deallocations());
+    ASSERT_EQ(1u, guard.num_locks());
+    ASSERT_EQ(1u, guard.num_unknown_locks());
+}
+
+/**
+ * @brief Make sure only locks of mutexes that are not known are reported.
+ */
+TEST(TestRealTimeAllocationGuard, known_mutexes)
+{
+    std::mutex known_mutex, other_mutex;
+
+    KnownMutexes known;
+    {
+        std::lock_guard<std::mutex> lock(known_mutex);
+    }
+    known.stop();
+
+    AllocationGuard guard;
+    {
+        std::lock_guard<std::mutex> lock(known_mutex);
+    }
+    {
+        std::lock_guard<std::mutex> lock(other_mutex);
+    }
+    guard.stop();
+
+    ASSERT_EQ(1u, known.size());
+    ASSERT_EQ(2u, guard.num_locks());
+    ASSERT_EQ(1u, guard.num_unknown_locks());
+}
+
+/**
+ * @brief Run process_desired_action with a variety of actions.
+ *
+ * @tparam Driver  Driver type from which process_desired_action is used.
+ */
+template <typename Driver>
+void check_process_desired_action()
+{
+    using Action = typename Driver::Action;
+    using Vector = typename Driver::Vector;
+    using Observation = typename Driver::Types::Observation;
+
+    Observation observation;
+    observation.position = Vector::LinSpaced(-1.0, 1.0);
+    observation.velocity = Vector::Constant(0.3);
+    observation.torque = Vector::Zero();
+
+    const Vector safety_kd = Vector::Constant(0.1);
+    const Vector kp = Vector::Constant(3.0);
+    const Vector kd = Vector::Constant(0.1);
+    // some joints are outside of the limits
+    const Vector lower = Vector::Constant(-0.5);
+    const Vector upper = Vector::Constant(0.5);
+
+    const Action actions[] = {
+        Action::Torque(Vector::Constant(0.2)),
+        Action::Position(Vector::Constant(0.1)),
+        Action::Position(Vector::Constant(0.1), kp, Action::None()),
+        Action::TorqueAndPosition(Vector::Constant(-0.1), Vector::Zero()),
+    };
+
+    Action result;
+    AllocationGuard guard;
+    for (const Action &action : actions)
+    {
+        result = Driver::process_desired_action(
+            action, observation, 0.36, safety_kd, kp, kd);
+        result = Driver::process_desired_action(
+            action, observation, 0.36, safety_kd, kp, kd, lower, upper);
+    }
+    guard.stop();
+
+    EXPECT_REAL_TIME_SAFE(guard);
+}
+
+TEST(TestRealTimeAllocationGuard, process_desired_action)
+{
+    using namespace robot_fingers;
+
+    check_process_desired_action<SimpleNJointBlmcRobotDriver<1>>();
+    check_process_desired_action<SimpleNJointBlmcRobotDriver<2>>();
+    check_process_desired_action<SimpleNJointBlmcRobotDriver<8, 4>>();
+    check_process_desired_action<NFingerDriver<1>>();
+    check_process_desired_action<NFingerDriver<3>>();
+}
+
+/**
+ * @brief Driver with simulated boards that gives access to the protected
+ *        control loop methods.
+ */
+class FakeBoardDriver
+    : public robot_fingers::SimpleNJointBlmcRobotDriver<2, 1, FakeMotorBoard>
+{
+public:
+    typedef robot_fingers::SimpleNJointBlmcRobotDriver<2, 1, FakeMotorBoard>
+        Base;
+
+    using Base::Base;
+    using Base::move_until_blocking;
+    using Base::MoveUntilBlockingResult;
+};
+
+TEST(TestRealTimeAllocationGuard, driver_control_loop)
+{
+    using Vector = FakeBoardDriver::Vector;
+    using Action = FakeBoardDriver::Action;
+
+    FakeBoardDriver::Config config;
+    config.max_current_A = 2.0;
+    config.wait_for_new_measurement = true;
+    config.calibration.move_steps = 100;
+    config.move_to_position_tolerance_rad = 0.01;
+    config.position_control_gains.kp = Vector::Constant(3.0);
+    config.position_control_gains.kd = Vector::Constant(0.01);
+    config.hard_position_limits_lower = Vector::Constant(-10.0);
+    config.hard_position_limits_upper = Vector::Constant(10.0);
+
+    auto board = std::make_shared<FakeMotorBoard>(config.control_period_s);
+    board->motors[0].upper_end_stop = 0.5;
+    board->motors[1].lower_end_stop = -0.5;
+    FakeBoardDriver::MotorBoards boards = {board};
+    FakeBoardDriver driver(
+        boards,
+        create_fake_motors<FakeBoardDriver::Motors>(boards),
+        robot_fingers::MotorParameters{0.02, 9.0},
+        config);
+    driver.initialize();
+
+    // The only mutexes that may be locked are the ones of the time series of
+    // the board.
+    KnownMutexes known_mutexes;
+    for (int i = 0; i < FakeMotorBoard::measurement_count; i++)
+    {
+        board->get_measurement(i)->length();
+    }
+    board->get_status()->length();
+    board->get_command()->length();
+    board->get_control()->length();
+    known_mutexes.stop();
+
+    constexpr size_t NUM_CYCLES = 100;
+    std::array<size_t, NUM_CYCLES> locks_per_cycle;
+    Action applied_action;
+    FakeBoardDriver::Observation observation;
+    FakeBoardDriver::ErrorState error_state;
+    std::string error;
+    FakeBoardDriver::MoveUntilBlockingResult blocking_result;
+
+    AllocationGuard guard;
+    for (size_t i = 0; i < NUM_CYCLES; i++)
+    {
+        const size_t num_locks_before = guard.num_locks();
+        applied_action = driver.apply_action(
+            Action::Position(Vector::Constant(0.01 * i)));
+        observation = driver.get_latest_observation();
+        error_state = driver.get_error_state();
+        // no error message is generated as long as there is no error
+        error = driver.get_error();
+        locks_per_cycle[i] = guard.num_locks() - num_locks_before;
+    }
+    blocking_result = driver.move_until_blocking(Vector(0.1, -0.1));
+    guard.stop();
+
+    EXPECT_REAL_TIME_SAFE_EXCEPT_KNOWN_LOCKS(guard);
+    // all cycles do the same accesses to the time series, so the number of
+    // locks must not change (e.g. due to locks only taken in some cycles)
+    for (size_t i = 1; i < NUM_CYCLES; i++)
+    {
+        EXPECT_EQ(locks_per_cycle[0], locks_per_cycle[i]) << "cycle " << i;
+    }
+    EXPECT_FALSE(error_state.has_error());
+    EXPECT_TRUE(error.empty());
+    EXPECT_TRUE(blocking_result.all_stalled);
+    EXPECT_LT(0.0, observation.position[0]);
+}
+
+TEST(TestRealTimeAllocationGuard, control_loop_timing)
+{
+    robot_fingers::PeriodicScheduler scheduler(0.0001);
+    robot_fingers::CycleTimingTrace trace(100);
+
+    AllocationGuard guard;
+    for (uint64_t i = 0; i < 10; i++)
+    {
+        robot_fingers::CycleTimingTrace::CycleTimestamps timestamps;
+        timestamps.cycle = i;
+        timestamps.start_ns = robot_fingers::get_monotonic_time_ns();
+        scheduler.wait_for_next_period();
+        timestamps.end_ns = robot_fingers::get_monotonic_time_ns();
+        trace.record(timestamps);
+    }
+    guard.stop();
+
+    EXPECT_REAL_TIME_SAFE(guard);
+}
+
+TEST(TestRealTimeAllocationGuard, parallel_board_sender)
+{
+    struct FakeBoard
+    {
+        void send_if_input_changed()
+        {
+        }
+    };
+
+    std::vector<std::shared_ptr<FakeBoard>> boards;
+    for (int i = 0; i < 6; i++)
+    {
+        boards.push_back(std::make_shared<FakeBoard>());
+    }
+    robot_fingers::ParallelBoardSender<FakeBoard> sender(boards);
+
+    AllocationGuard guard;
+    for (int i = 0; i < 10; i++)
+    {
+        sender.send();
+    }
+    guard.stop();
+
+    EXPECT_REAL_TIME_SAFE(guard);
+}
+
+TEST(TestRealTimeAllocationGuard, stall_detector)
+{
+    robot_fingers::StallDetector<9> detector(100, 0.01, 1000);
+
+    AllocationGuard guard;
+    detector.reset();
+    for (int i = 0; i < 300; i++)
+    {
+        detector.update(robot_fingers::StallDetector<9>::Vector::Constant(
+            i < 150 ? 1.0 : 0.0));
+    }
+    guard.stop();
+
+    EXPECT_TRUE(detector.all_stalled());
+    EXPECT_REAL_TIME_SAFE(guard);
+}
+
+TEST(TestRealTimeAllocationGuard, triple_buffer)
+{
+    using RuntimeParameters =
+        robot_fingers::NFingerDriver<3>::RuntimeParameters;
+
+    RuntimeParameters parameters;
+    robot_fingers::TripleBuffer<RuntimeParameters> buffer(parameters);
+    parameters.safety_kd.setConstant(0.5);
+    buffer.write(parameters);
+
+    // reader side as used in the control loop
+    AllocationGuard guard;
+    bool has_update = buffer.update();
+    double safety_kd = buffer.read().safety_kd[0];
+    guard.stop();
+
+    EXPECT_TRUE(has_update);
+    EXPECT_EQ(0.5, safety_kd);
+    EXPECT_REAL_TIME_SAFE(guard);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Tests for the StallDetector.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <robot_fingers/stall_detector.hpp>
+
+using Detector = robot_fingers::StallDetector<2>;
+
+TEST(TestStallDetector, needs_full_window)
+{
+    Detector detector(10, 0.01, 0);
+
+    // joints are not moving from the start but are only considered stalled
+    // once the window is full
+    for (int i = 0; i < 9; i++)
+    {
+        ASSERT_FALSE(detector.update(Detector::Vector::Zero()));
+    }
+    ASSERT_TRUE(detector.update(Detector::Vector::Zero()));
+    ASSERT_TRUE(detector.is_stalled(0));
+    ASSERT_TRUE(detector.is_stalled(1));
+}
+
+TEST(TestStallDetector, min_steps_without_motion)
+{
+    Detector detector(10, 0.01, 50);
+
+    // joint 0 never moves, joint 1 moves for 20 steps
+    for (int i = 0; i < 49; i++)
+    {
+        Detector::Vector velocity(0.0, i < 20 ? 1.0 : 0.0);
+        ASSERT_FALSE(detector.update(velocity));
+    }
+    ASSERT_FALSE(detector.is_stalled(0));
+    ASSERT_TRUE(detector.is_stalled(1));
+
+    ASSERT_TRUE(detector.update(Detector::Vector::Zero()));
+}
+
+TEST(TestStallDetector, late_start)
+{
+    Detector detector(10, 0.01, 100);
+
+    // joint 0 only starts moving after 30 steps and moves very slowly, so the
+    // average over the window is below the stop velocity right away
+    for (int i = 0; i < 30; i++)
+    {
+        detector.update(Detector::Vector(0.0, 1.0));
+    }
+    ASSERT_FALSE(detector.is_stalled(0));
+    detector.update(Detector::Vector(0.05, 1.0));
+
+    // it is only considered as stalled one window after it started moving
+    for (int i = 0; i < 9; i++)
+    {
+        detector.update(Detector::Vector(0.0, 1.0));
+        ASSERT_FALSE(detector.is_stalled(0));
+    }
+    detector.update(Detector::Vector(0.0, 1.0));
+    ASSERT_TRUE(detector.is_stalled(0));
+    ASSERT_FALSE(detector.is_stalled(1));
+}
+
+TEST(TestStallDetector, per_joint)
+{
+    Detector detector(10, 0.01, 0);
+
+    // joint 0 stops after 20 steps, joint 1 keeps moving
+    for (int i = 0; i < 30; i++)
+    {
+        Detector::Vector velocity(i < 20 ? 1.0 : 0.0, -1.0);
+        ASSERT_FALSE(detector.update(velocity));
+    }
+    ASSERT_TRUE(detector.is_stalled(0));
+    ASSERT_FALSE(detector.is_stalled(1));
+    ASSERT_FALSE(detector.all_stalled());
+    ASSERT_DOUBLE_EQ(0.0, detector.get_average_velocity()[0]);
+    ASSERT_DOUBLE_EQ(1.0, detector.get_average_velocity()[1]);
+
+    // stalled state is latched, even if the joint moves again
+    for (int i = 0; i < 10; i++)
+    {
+        detector.update(Detector::Vector(1.0, 0.0));
+    }
+    ASSERT_TRUE(detector.is_stalled(0));
+    ASSERT_TRUE(detector.all_stalled());
+}
+
+TEST(TestStallDetector, average_over_window)
+{
+    Detector detector(4, 0.5, 0);
+
+    // average of the last four steps (in absolute values) is 0.5, which is
+    // not below the stop velocity
+    for (double v : {5.0, 1.0, -0.5, 0.0, 0.5})
+    {
+        detector.update(Detector::Vector(v, v));
+    }
+    ASSERT_DOUBLE_EQ(0.5, detector.get_average_velocity()[0]);
+    ASSERT_FALSE(detector.is_stalled(0));
+
+    // now 0.375
+    detector.update(Detector::Vector(0.5, 0.5));
+    ASSERT_TRUE(detector.all_stalled());
+}
+
+TEST(TestStallDetector, reset)
+{
+    Detector detector(2, 0.01, 0);
+    detector.update(Detector::Vector::Zero());
+    detector.update(Detector::Vector::Zero());
+    ASSERT_TRUE(detector.all_stalled());
+
+    detector.reset();
+    ASSERT_FALSE(detector.is_stalled(0));
+    ASSERT_FALSE(detector.update(Detector::Vector::Zero()));
+}
+
+TEST(TestStallDetector, invalid_window)
+{
+    ASSERT_THROW(Detector(0, 0.01, 0), std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief Tests for TimeIndexMatcher.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include <robot_fingers/time_index_matcher.hpp>
+
+using robot_fingers::TimeIndexMatcher;
+using Index = TimeIndexMatcher::Index;
+
+/**
+ * @brief Time series with a limited history, counting timestamp lookups.
+ */
+struct FakeTimeSeries
+{
+    std::vector<double> timestamps;
+    //! @brief Entries before this index were dropped.
+    Index oldest = 0;
+    size_t lookup_count = 0;
+
+    Index newest() const
+    {
+        return static_cast<Index>(timestamps.size()) - 1;
+    }
+
+    Index find(TimeIndexMatcher &matcher, double stamp)
+    {
+        return matcher.find(stamp, newest(), [this](Index t, double *s) {
+            EXPECT_GE(t, 0);
+            EXPECT_LE(t, newest());
+            lookup_count++;
+            if (t < oldest)
+            {
+                return false;
+            }
+            *s = timestamps[t];
+            return true;
+        });
+    }
+
+    //! @brief Reference implementation (linear search).
+    Index find_linear(double stamp) const
+    {
+        for (Index t = newest(); t >= oldest; t--)
+        {
+            if (timestamps[t] <= stamp)
+            {
+                return t;
+            }
+        }
+        return -1;
+    }
+};
+
+TEST(TestTimeIndexMatcher, newest_first)
+{
+    FakeTimeSeries series;
+    series.timestamps = {10, 20, 30, 40};
+    TimeIndexMatcher matcher;
+
+    ASSERT_EQ(3, series.find(matcher, 45));
+    ASSERT_EQ(3, series.find(matcher, 40));
+    // the newest index is matched with a single lookup
+    ASSERT_EQ(2u, series.lookup_count);
+}
+
+TEST(TestTimeIndexMatcher, exact_and_between)
+{
+    FakeTimeSeries series;
+    series.timestamps = {10, 20, 30, 40, 50};
+    TimeIndexMatcher matcher;
+
+    ASSERT_EQ(0, series.find(matcher, 10));
+    ASSERT_EQ(0, series.find(matcher, 19.9));
+    ASSERT_EQ(1, series.find(matcher, 20));
+    ASSERT_EQ(3, series.find(matcher, 49));
+    ASSERT_EQ(2, series.find(matcher, 35));
+}
+
+TEST(TestTimeIndexMatcher, equal_timestamps)
+{
+    // the highest of equal timestamps is matched
+    FakeTimeSeries series;
+    series.timestamps = {10, 20, 20, 20, 30};
+    TimeIndexMatcher matcher;
+
+    ASSERT_EQ(3, series.find(matcher, 20));
+    ASSERT_EQ(3, series.find(matcher, 25));
+    ASSERT_EQ(0, series.find(matcher, 15));
+    ASSERT_EQ(3, series.find(matcher, 20));
+}
+
+TEST(TestTimeIndexMatcher, no_match)
+{
+    FakeTimeSeries series;
+    TimeIndexMatcher matcher;
+
+    // empty series
+    ASSERT_THROW(series.find(matcher, 10), std::out_of_range);
+
+    // all entries newer
+    series.timestamps = {10, 20, 30};
+    ASSERT_THROW(series.find(matcher, 5), std::out_of_range);
+
+    // match was dropped from the buffer
+    series.oldest = 2;
+    ASSERT_THROW(series.find(matcher, 25), std::out_of_range);
+    ASSERT_EQ(2, series.find(matcher, 30));
+}
+
+TEST(TestTimeIndexMatcher, random_queries)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> step(0.0, 10.0);
+
+    FakeTimeSeries series;
+    double stamp = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        // some steps are zero to get equal timestamps
+        stamp += i % 7 == 0 ? 0 : step(rng);
+        series.timestamps.push_back(stamp);
+    }
+    series.oldest = 100;
+
+    std::uniform_real_distribution<double> query(-10, stamp + 10);
+    TimeIndexMatcher matcher;
+    for (int i = 0; i < 10000; i++)
+    {
+        const double q = query(rng);
+        const Index expected = series.find_linear(q);
+        if (expected < 0)
+        {
+            ASSERT_THROW(series.find(matcher, q), std::out_of_range);
+        }
+        else
+        {
+            ASSERT_EQ(expected, series.find(matcher, q)) << "query " << q;
+        }
+    }
+}
+
+TEST(TestTimeIndexMatcher, read_back_through_history)
+{
+    // robot at 1 kHz, camera at 10 Hz
+    FakeTimeSeries camera;
+    for (int i = 0; i < 1000; i++)
+    {
+        camera.timestamps.push_back(i * 100.0);
+    }
+
+    TimeIndexMatcher matcher;
+    for (int t_robot = 99999; t_robot >= 0; t_robot--)
+    {
+        ASSERT_EQ(t_robot / 100, camera.find(matcher, t_robot));
+    }
+    // a linear search would need ~50000 lookups per query
+    ASSERT_LT(camera.lookup_count, 100000u * 4);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,166 @@
+/**
+ * @file
+ * @brief Tests for the trajectory generation.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <robot_fingers/trajectory.hpp>
+
+using robot_fingers::min_jerk_phase;
+using robot_fingers::Trajectory;
+
+TEST(TestTrajectory, min_jerk_phase)
+{
+    ASSERT_EQ(0.0, min_jerk_phase(0.0));
+    ASSERT_DOUBLE_EQ(0.5, min_jerk_phase(0.5));
+    ASSERT_DOUBLE_EQ(1.0, min_jerk_phase(1.0));
+
+    for (double alpha = 0; alpha <= 1.0; alpha += 0.01)
+    {
+        ASSERT_NEAR(10.0 * std::pow(alpha, 3) - 15.0 * std::pow(alpha, 4) +
+                        6.0 * std::pow(alpha, 5),
+                    min_jerk_phase(alpha),
+                    1e-12);
+    }
+}
+
+TEST(TestTrajectory, min_jerk)
+{
+    constexpr uint32_t NUM_STEPS = 100;
+    constexpr double STEP_DURATION = 0.01;
+
+    Trajectory::Vector start(2), goal(2);
+    start << 1.0, -2.0;
+    goal << 3.0, -1.0;
+
+    Trajectory trajectory =
+        Trajectory::min_jerk(start, goal, NUM_STEPS, STEP_DURATION);
+
+    ASSERT_EQ(NUM_STEPS, trajectory.size());
+    ASSERT_EQ(2, trajectory.num_dofs());
+
+    for (uint32_t t = 0; t < NUM_STEPS; t++)
+    {
+        const double alpha = (t + 1.0) / NUM_STEPS;
+        for (int j = 0; j < 2; j++)
+        {
+            ASSERT_NEAR(start[j] + (goal[j] - start[j]) * min_jerk_phase(alpha),
+                        trajectory.position(t)[j],
+                        1e-12);
+        }
+    }
+
+    // ends at the goal at rest, peak velocity 1.875 D/T in the middle
+    ASSERT_NEAR(goal[0], trajectory.position(NUM_STEPS - 1)[0], 1e-12);
+    ASSERT_NEAR(0.0, trajectory.velocity(NUM_STEPS - 1)[0], 1e-12);
+    ASSERT_NEAR(1.875 * 2.0 / (NUM_STEPS * STEP_DURATION),
+                trajectory.velocity(NUM_STEPS / 2 - 1)[0],
+                1e-9);
+}
+
+TEST(TestTrajectory, min_jerk_profile)
+{
+    Trajectory profile = Trajectory::min_jerk_profile(50);
+
+    ASSERT_EQ(50, profile.size());
+    ASSERT_EQ(1, profile.num_dofs());
+    ASSERT_NEAR(1.0, profile.positions()(49, 0), 1e-12);
+    ASSERT_NEAR(min_jerk_phase(0.5), profile.positions()(24, 0), 1e-12);
+
+    // step t is sampled at its end (the driver relies on this when it
+    // evaluates the phase directly instead of using a precomputed profile)
+    for (Eigen::Index t = 0; t < 50; t++)
+    {
+        ASSERT_NEAR(min_jerk_phase((t + 1) / 50.0),
+                    profile.positions()(t, 0),
+                    1e-12);
+    }
+}
+
+TEST(TestTrajectory, quintic_boundary_conditions)
+{
+    constexpr uint32_t NUM_STEPS = 1000;
+    constexpr double STEP_DURATION = 0.001;
+
+    Trajectory::Vector start(1), goal(1), v0(1), v1(1), a0(1), a1(1);
+    start << 0.0;
+    goal << 1.0;
+    v0 << 0.5;
+    v1 << -0.2;
+    a0 << 0.0;
+    a1 << 0.0;
+
+    Trajectory trajectory = Trajectory::quintic(
+        start, goal, v0, v1, a0, a1, NUM_STEPS, STEP_DURATION);
+
+    // first step is one step duration after the start
+    ASSERT_NEAR(start[0] + v0[0] * STEP_DURATION,
+                trajectory.position(0)[0],
+                1e-6);
+    ASSERT_NEAR(goal[0], trajectory.position(NUM_STEPS - 1)[0], 1e-12);
+    ASSERT_NEAR(v1[0], trajectory.velocity(NUM_STEPS - 1)[0], 1e-12);
+}
+
+TEST(TestTrajectory, quintic_size_mismatch)
+{
+    Trajectory::Vector a = Trajectory::Vector::Zero(2);
+    Trajectory::Vector b = Trajectory::Vector::Zero(3);
+
+    ASSERT_THROW(Trajectory::quintic(a, b, a, a, a, a, 10, 0.001),
+                 std::invalid_argument);
+}
+
+TEST(TestTrajectory, spline)
+{
+    constexpr double STEP_DURATION = 0.001;
+
+    std::vector<Trajectory::Vector> waypoints(3, Trajectory::Vector(2));
+    waypoints[0] << 0.0, 0.0;
+    waypoints[1] << 1.0, 0.5;
+    waypoints[2] << 2.0, 0.0;
+
+    Trajectory trajectory =
+        Trajectory::spline(waypoints, {100, 200}, STEP_DURATION);
+
+    ASSERT_EQ(300, trajectory.size());
+
+    // passes through the waypoints
+    for (int j = 0; j < 2; j++)
+    {
+        ASSERT_NEAR(waypoints[1][j], trajectory.position(99)[j], 1e-12);
+        ASSERT_NEAR(waypoints[2][j], trajectory.position(299)[j], 1e-12);
+    }
+
+    // does not stop at the inner waypoint (first joint moves monotonically)
+    ASSERT_GT(trajectory.velocity(99)[0], 0.0);
+    // ... but at the end
+    ASSERT_NEAR(0.0, trajectory.velocity(299)[0], 1e-12);
+
+    // velocity is continuous at the inner waypoint
+    ASSERT_NEAR(trajectory.velocity(99)[0], trajectory.velocity(100)[0], 0.01);
+}
+
+TEST(TestTrajectory, spline_invalid)
+{
+    std::vector<Trajectory::Vector> waypoints(2, Trajectory::Vector::Zero(2));
+
+    ASSERT_THROW(Trajectory::spline({waypoints[0]}, {}, 0.001),
+                 std::invalid_argument);
+    ASSERT_THROW(Trajectory::spline(waypoints, {10, 10}, 0.001),
+                 std::invalid_argument);
+    ASSERT_THROW(Trajectory::spline(waypoints, {0}, 0.001),
+                 std::invalid_argument);
+
+    waypoints[1] = Trajectory::Vector::Zero(3);
+    ASSERT_THROW(Trajectory::spline(waypoints, {10}, 0.001),
+                 std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @brief Tests for the TripleBuffer.
+ * @copyright Copyright (c) 2022, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+#include <robot_fingers/triple_buffer.hpp>
+
+using robot_fingers::TripleBuffer;
+
+TEST(TestTripleBuffer, initial_value)
+{
+    TripleBuffer<int> buffer(42);
+
+    ASSERT_EQ(42, buffer.read());
+    ASSERT_FALSE(buffer.update());
+    ASSERT_EQ(42, buffer.read());
+}
+
+TEST(TestTripleBuffer, write_and_update)
+{
+    TripleBuffer<int> buffer(0);
+
+    buffer.write(1);
+    // not visible before update
+    ASSERT_EQ(0, buffer.read());
+    ASSERT_TRUE(buffer.update());
+    ASSERT_EQ(1, buffer.read());
+    ASSERT_FALSE(buffer.update());
+    ASSERT_EQ(1, buffer.read());
+}
+
+TEST(TestTripleBuffer, only_latest_value)
+{
+    TripleBuffer<int> buffer(0);
+
+    for (int i = 1; i <= 10; i++)
+    {
+        buffer.write(i);
+    }
+    ASSERT_TRUE(buffer.update());
+    ASSERT_EQ(10, buffer.read());
+    ASSERT_FALSE(buffer.update());
+
+    buffer.write(11);
+    ASSERT_TRUE(buffer.update());
+    ASSERT_EQ(11, buffer.read());
+}
+
+TEST(TestTripleBuffer, concurrent)
+{
+    // each value consists of multiple fields that are all set to the same
+    // number, so torn reads would be detected
+    typedef std::array<int, 64> Value;
+    constexpr int NUM_VALUES = 100000;
+
+    Value initial;
+    initial.fill(0);
+    TripleBuffer<Value> buffer(initial);
+
+    std::thread writer([&buffer]() {
+        Value value;
+        for (int i = 1; i <= NUM_VALUES; i++)
+        {
+            value.fill(i);
+            buffer.write(value);
+        }
+    });
+
+    int last = 0;
+    while (last < NUM_VALUES)
+    {
+        buffer.update();
+        const Value &value = buffer.read();
+        for (int x : value)
+        {
+            ASSERT_EQ(value[0], x);
+        }
+        // values must never go backwards
+        ASSERT_GE(value[0], last);
+        last = value[0];
+    }
+
+    writer.join();
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}